@@ -0,0 +1,51 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_utils.h"
+
+namespace sup
+{
+namespace di
+{
+namespace bench
+{
+std::vector<std::string> InstanceNames(std::size_t n_instances)
+{
+  std::vector<std::string> result;
+  result.reserve(n_instances);
+  for (std::size_t i = 0; i < n_instances; ++i)
+  {
+    result.push_back("plant/subsystem/instance_" + std::to_string(i));
+  }
+  return result;
+}
+
+void InstanceCounts(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->RangeMultiplier(10)->Range(10, 1000000);
+}
+
+}  // namespace bench
+
+}  // namespace di
+
+}  // namespace sup
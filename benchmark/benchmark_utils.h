@@ -0,0 +1,55 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_BENCHMARK_BENCHMARK_UTILS_H_
+#define SUP_DI_BENCHMARK_BENCHMARK_UTILS_H_
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+namespace bench
+{
+/**
+ * @brief Generate distinct instance names that resemble the hierarchical names of real
+ * configurations.
+ */
+std::vector<std::string> InstanceNames(std::size_t n_instances);
+
+/**
+ * @brief Apply the common range of instance counts, from 10 to 1M in steps of 10, to a benchmark.
+ */
+void InstanceCounts(benchmark::internal::Benchmark* benchmark);
+
+}  // namespace bench
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_BENCHMARK_BENCHMARK_UTILS_H_
@@ -0,0 +1,291 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/di-composer-core/compiled_object_tree.h>
+#include <sup/di-composer-core/object_composer_element.h>
+#include <sup/di-composer-core/streaming_object_tree.h>
+
+#include <sup/di/object_manager.h>
+
+#include <sup/xml/tree_data_parser.h>
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace sup::di;
+
+namespace
+{
+const std::size_t kMaxFanIn = 8;
+
+struct ComposerNode
+{
+  std::size_t n_dependencies;
+};
+
+template <std::size_t I>
+using NodeDependency = const ComposerNode*;
+
+template <typename... Deps>
+std::unique_ptr<ComposerNode> ComposerNodeFactory(Deps... dependencies)
+{
+  (void)std::initializer_list<const ComposerNode*>{dependencies...};
+  return std::unique_ptr<ComposerNode>(new ComposerNode{sizeof...(Deps)});
+}
+
+bool ReadComposerNode(const ComposerNode* node)
+{
+  return node->n_dependencies <= kMaxFanIn;
+}
+
+std::string NodeTypeName(std::size_t fan_in)
+{
+  return "ComposerNode" + std::to_string(fan_in);
+}
+
+std::string NodeName(std::size_t idx)
+{
+  return "plant/subsystem/node_" + std::to_string(idx);
+}
+
+template <std::size_t... I>
+void RegisterNodeFactory(std::index_sequence<I...>)
+{
+  GlobalObjectManager().RegisterFactoryFunction(NodeTypeName(sizeof...(I)),
+                                                ComposerNodeFactory<NodeDependency<I>...>);
+}
+
+template <std::size_t... FanIn>
+void RegisterNodeFactories(std::index_sequence<FanIn...>)
+{
+  int dummy[] = { (RegisterNodeFactory(std::make_index_sequence<FanIn>{}), 0)... };
+  (void)dummy;
+}
+
+void RegisterComposerFunctions()
+{
+  static const bool registered = []()
+  {
+    RegisterNodeFactories(std::make_index_sequence<kMaxFanIn + 1>{});
+    GlobalObjectManager().RegisterGlobalFunction("ReadComposerNode", ReadComposerNode);
+    return true;
+  }();
+  (void)registered;
+}
+
+/**
+ * @brief Shape of a generated configuration.
+ *
+ * @details Node i depends on the nodes (i * fan_in + j) / fan_out for j < fan_in, so every node
+ * is injected into fan_out other nodes. Nodes for which these are not all preceding nodes are
+ * created without dependencies. The functions read nodes spread evenly over the configuration.
+ */
+struct ConfigurationShape
+{
+  std::size_t n_instances;
+  std::size_t n_functions;
+  std::size_t fan_in;
+  std::size_t fan_out;
+};
+
+ConfigurationShape ShapeFromState(const benchmark::State& state)
+{
+  return { static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)),
+           static_cast<std::size_t>(state.range(2)), static_cast<std::size_t>(state.range(3)) };
+}
+
+std::vector<std::size_t> NodeDependencies(const ConfigurationShape& shape, std::size_t idx)
+{
+  std::vector<std::size_t> result;
+  for (std::size_t j = 0; j < shape.fan_in; ++j)
+  {
+    auto dependency = (idx * shape.fan_in + j) / shape.fan_out;
+    if (dependency >= idx)
+    {
+      return {};
+    }
+    result.push_back(dependency);
+  }
+  return result;
+}
+
+std::string GenerateConfiguration(const ConfigurationShape& shape)
+{
+  std::ostringstream oss;
+  oss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<ObjectComposer xmlns=\"http://codac.iter.org/sup/di\" version=\"1.0\""
+      << " name=\"Generated benchmark configuration\">\n";
+  for (std::size_t idx = 0; idx < shape.n_instances; ++idx)
+  {
+    auto dependencies = NodeDependencies(shape, idx);
+    oss << "  <Instance>\n"
+        << "    <TypeName>" << NodeTypeName(dependencies.size()) << "</TypeName>\n"
+        << "    <InstanceName>" << NodeName(idx) << "</InstanceName>\n";
+    for (auto dependency : dependencies)
+    {
+      oss << "    <Dependency>" << NodeName(dependency) << "</Dependency>\n";
+    }
+    oss << "  </Instance>\n";
+  }
+  for (std::size_t idx = 0; idx < shape.n_functions; ++idx)
+  {
+    oss << "  <CallFunction>\n"
+        << "    <FunctionName>ReadComposerNode</FunctionName>\n"
+        << "    <Dependency>" << NodeName(idx * shape.n_instances / shape.n_functions)
+        << "</Dependency>\n"
+        << "  </CallFunction>\n";
+  }
+  oss << "</ObjectComposer>\n";
+  return oss.str();
+}
+
+// The composer always uses the global ObjectManager, so the nodes are removed after each run
+void RemoveNodes(const ConfigurationShape& shape)
+{
+  for (std::size_t idx = 0; idx < shape.n_instances; ++idx)
+  {
+    GlobalObjectManager().GetInstance<std::unique_ptr<ComposerNode>>(NodeName(idx));
+  }
+}
+
+double Seconds(std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+// Same shape for a range of sizes, followed by different fan-in/fan-out at a fixed size
+void ConfigurationShapes(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->ArgNames({"instances", "functions", "fan_in", "fan_out"});
+  for (std::int64_t n_instances = 10; n_instances <= 100000; n_instances *= 10)
+  {
+    benchmark->Args({n_instances, n_instances / 10 + 1, 2, 4});
+  }
+  benchmark->Args({10000, 1001, 1, 2});
+  benchmark->Args({10000, 1001, 4, 8});
+  benchmark->Args({10000, 1001, 8, 16});
+}
+}  // unnamed namespace
+
+// Runs the same phases as ExecuteObjectTreeFromFile and reports the time per phase in seconds.
+static void BM_ComposerStartup(benchmark::State& state)
+{
+  RegisterComposerFunctions();
+  auto shape = ShapeFromState(state);
+  auto filename = (std::filesystem::temp_directory_path() /
+                   ("sup-di-composer-benchmark-" + std::to_string(shape.n_instances) + ".xml"))
+                    .string();
+  {
+    std::ofstream ofs{filename};
+    ofs << GenerateConfiguration(shape);
+  }
+  double parse_time = 0.0;
+  double construct_time = 0.0;
+  double execute_time = 0.0;
+  for (auto _ : state)
+  {
+    auto start = std::chrono::steady_clock::now();
+    auto composer_tree = sup::xml::TreeDataFromFile(filename);
+    auto parsed = std::chrono::steady_clock::now();
+    ObjectComposerElement object_composer{*composer_tree};
+    auto constructed = std::chrono::steady_clock::now();
+    object_composer.Execute();
+    auto executed = std::chrono::steady_clock::now();
+    parse_time += Seconds(parsed - start);
+    construct_time += Seconds(constructed - parsed);
+    execute_time += Seconds(executed - constructed);
+    state.SetIterationTime(Seconds(executed - start));
+    RemoveNodes(shape);
+  }
+  std::remove(filename.c_str());
+  state.counters["parse"] = benchmark::Counter(parse_time, benchmark::Counter::kAvgIterations);
+  state.counters["construct"] =
+    benchmark::Counter(construct_time, benchmark::Counter::kAvgIterations);
+  state.counters["execute"] = benchmark::Counter(execute_time, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed((shape.n_instances + shape.n_functions) * state.iterations());
+}
+BENCHMARK(BM_ComposerStartup)->Apply(ConfigurationShapes)->UseManualTime()
+                             ->Unit(benchmark::kMillisecond);
+
+// Executes a precompiled image of the same configuration, including mapping and validating it.
+static void BM_CompiledStartup(benchmark::State& state)
+{
+  RegisterComposerFunctions();
+  auto shape = ShapeFromState(state);
+  auto filename = (std::filesystem::temp_directory_path() /
+                   ("sup-di-composer-benchmark-" + std::to_string(shape.n_instances) + ".img"))
+                    .string();
+  {
+    auto composer_tree = sup::xml::TreeDataFromString(GenerateConfiguration(shape));
+    std::ofstream ofs{filename, std::ios::binary};
+    ofs << CompileObjectTree(*composer_tree);
+  }
+  for (auto _ : state)
+  {
+    auto start = std::chrono::steady_clock::now();
+    ExecuteCompiledObjectTreeFromFile(filename);
+    auto executed = std::chrono::steady_clock::now();
+    state.SetIterationTime(Seconds(executed - start));
+    RemoveNodes(shape);
+  }
+  std::remove(filename.c_str());
+  state.SetItemsProcessed((shape.n_instances + shape.n_functions) * state.iterations());
+}
+BENCHMARK(BM_CompiledStartup)->Apply(ConfigurationShapes)->UseManualTime()
+                             ->Unit(benchmark::kMillisecond);
+
+// Parses and executes the same configuration one element at a time.
+static void BM_StreamingStartup(benchmark::State& state)
+{
+  RegisterComposerFunctions();
+  auto shape = ShapeFromState(state);
+  auto filename = (std::filesystem::temp_directory_path() /
+                   ("sup-di-composer-streaming-" + std::to_string(shape.n_instances) + ".xml"))
+                    .string();
+  {
+    std::ofstream ofs{filename};
+    ofs << GenerateConfiguration(shape);
+  }
+  for (auto _ : state)
+  {
+    auto start = std::chrono::steady_clock::now();
+    StreamObjectTreeFromFile(filename);
+    auto executed = std::chrono::steady_clock::now();
+    state.SetIterationTime(Seconds(executed - start));
+    RemoveNodes(shape);
+  }
+  std::remove(filename.c_str());
+  state.SetItemsProcessed((shape.n_instances + shape.n_functions) * state.iterations());
+}
+BENCHMARK(BM_StreamingStartup)->Apply(ConfigurationShapes)->UseManualTime()
+                              ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,526 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "allocation_counter.h"
+#include "benchmark_utils.h"
+
+#include <sup/di/object_manager.h>
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace sup::di;
+using namespace sup::di::bench;
+
+namespace
+{
+const std::size_t kNumberOfInstances = 1024;
+
+bool ReadValue(const int* value)
+{
+  return *value >= 0;
+}
+
+std::unique_ptr<int> CopyValue(const int* value)
+{
+  return std::make_unique<int>(*value);
+}
+
+// Shared by all benchmark threads, so it is only created once.
+ObjectManager& SharedObjectManager()
+{
+  static ObjectManager object_manager;
+  static const bool initialized = []()
+  {
+    int value = 0;
+    for (const auto& name : InstanceNames(kNumberOfInstances))
+    {
+      object_manager.RegisterInstance(std::make_unique<int>(value++), name);
+    }
+    object_manager.RegisterGlobalFunction("ReadValue", ReadValue);
+    object_manager.RegisterFactoryFunction("CopyValue", CopyValue);
+    return true;
+  }();
+  (void)initialized;
+  return object_manager;
+}
+}  // unnamed namespace
+
+static void BM_ConcurrentGetInstance(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  auto names = InstanceNames(kNumberOfInstances);
+  std::size_t idx = state.thread_index();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.GetInstance<int*>(names[idx]));
+    idx = (idx + 1) % names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentGetInstance)->ThreadRange(1, std::thread::hardware_concurrency())
+                                   ->UseRealTime();
+
+namespace
+{
+struct FirstInstanceTag
+{
+  static constexpr const char* name = "plant/subsystem/instance_0";
+};
+}  // unnamed namespace
+
+static void BM_GetInstanceByName(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  const std::string name = FirstInstanceTag::name;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.GetInstance<int*>(name));
+  }
+}
+BENCHMARK(BM_GetInstanceByName);
+
+static void BM_GetInstanceByTag(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.GetInstance<int*, FirstInstanceTag>());
+  }
+}
+BENCHMARK(BM_GetInstanceByTag);
+
+static void BM_CallGlobalFunctionByName(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  const std::string function_name = "ReadValue";
+  const std::vector<std::string> dependency_names = { FirstInstanceTag::name };
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.CallGlobalFunction(function_name, dependency_names));
+  }
+}
+BENCHMARK(BM_CallGlobalFunctionByName);
+
+static void BM_CallGlobalFunctionBySymbol(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  const auto function_name = object_manager.Intern("ReadValue");
+  const std::vector<Symbol> dependency_names = { object_manager.Intern(FirstInstanceTag::name) };
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.CallGlobalFunction(function_name, dependency_names));
+  }
+}
+BENCHMARK(BM_CallGlobalFunctionBySymbol);
+
+namespace
+{
+struct SumNode
+{
+  int sum;
+};
+
+template <std::size_t I>
+using IntDependency = const int*;
+
+template <typename... Deps>
+std::unique_ptr<SumNode> SumNodeFactory(Deps... values)
+{
+  return std::unique_ptr<SumNode>(new SumNode{(0 + ... + *values)});
+}
+
+template <std::size_t... I>
+void RegisterSumNodeFactory(ObjectManager& object_manager, const std::string& registered_typename,
+                            std::index_sequence<I...>)
+{
+  object_manager.RegisterFactoryFunction(registered_typename,
+                                         SumNodeFactory<IntDependency<I>...>);
+}
+
+void RegisterValues(ObjectManager& object_manager, const std::vector<std::string>& names)
+{
+  int value = 0;
+  for (const auto& name : names)
+  {
+    object_manager.RegisterInstance(value++, name);
+  }
+}
+}  // unnamed namespace
+
+// Create instances with NDeps dependencies in an ObjectManager that holds range(0) values. The
+// created instances are removed again after each batch of names.
+template <std::size_t NDeps>
+static void BM_CreateInstance(benchmark::State& state)
+{
+  const std::size_t n_values = state.range(0);
+  const std::size_t n_created = 1024;
+  const std::string registered_typename = "SumNode";
+  auto value_names = InstanceNames(n_values);
+  std::vector<std::string> created_names;
+  for (std::size_t i = 0; i < n_created; ++i)
+  {
+    created_names.push_back("plant/subsystem/node_" + std::to_string(i));
+  }
+  std::vector<std::vector<std::string>> dependencies(n_created);
+  for (std::size_t i = 0; i < n_created; ++i)
+  {
+    for (std::size_t dep_idx = 0; dep_idx < NDeps; ++dep_idx)
+    {
+      dependencies[i].push_back(value_names[(7919 * i + dep_idx) % n_values]);
+    }
+  }
+  ObjectManager object_manager;
+  RegisterValues(object_manager, value_names);
+  RegisterSumNodeFactory(object_manager, registered_typename, std::make_index_sequence<NDeps>{});
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    if (object_manager.CreateInstance(registered_typename, created_names[idx], dependencies[idx])
+        != ErrorCode::kSuccess)
+    {
+      state.SkipWithError("CreateInstance failed");
+      break;
+    }
+    if (++idx == n_created)
+    {
+      state.PauseTiming();
+      for (const auto& name : created_names)
+      {
+        object_manager.GetInstance<std::unique_ptr<SumNode>>(name);
+      }
+      idx = 0;
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_CreateInstance, 0)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_CreateInstance, 1)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_CreateInstance, 2)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_CreateInstance, 4)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_CreateInstance, 8)->Apply(InstanceCounts);
+
+static void BM_CallGlobalFunction(benchmark::State& state)
+{
+  auto names = InstanceNames(state.range(0));
+  ObjectManager object_manager;
+  RegisterValues(object_manager, names);
+  object_manager.RegisterGlobalFunction("ReadValue", ReadValue);
+  std::vector<std::vector<std::string>> dependencies;
+  for (const auto& name : names)
+  {
+    dependencies.push_back({name});
+  }
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.CallGlobalFunction("ReadValue", dependencies[idx]));
+    idx = (idx + 7919) % names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CallGlobalFunction)->Apply(InstanceCounts);
+
+static void BM_ConcurrentCallGlobalFunction(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  auto names = InstanceNames(kNumberOfInstances);
+  std::size_t idx = state.thread_index();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(object_manager.CallGlobalFunction("ReadValue", {names[idx]}));
+    idx = (idx + 1) % names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentCallGlobalFunction)->ThreadRange(1, std::thread::hardware_concurrency())
+                                          ->UseRealTime();
+
+// Mixed workload: one in sixteen operations creates a new instance and thus takes the
+// exclusive lock.
+static void BM_ConcurrentMixedReadWrite(benchmark::State& state)
+{
+  auto& object_manager = SharedObjectManager();
+  auto names = InstanceNames(kNumberOfInstances);
+  const std::string prefix = "benchmark_thread_" + std::to_string(state.thread_index()) + "_";
+  std::size_t idx = 0;
+  std::size_t n_created = 0;
+  for (auto _ : state)
+  {
+    if (idx % 16 == 0)
+    {
+      object_manager.CreateInstance("CopyValue", prefix + std::to_string(n_created++),
+                                    {names[idx % names.size()]});
+    }
+    else
+    {
+      benchmark::DoNotOptimize(object_manager.GetInstance<int*>(names[idx % names.size()]));
+    }
+    ++idx;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentMixedReadWrite)->ThreadRange(1, std::thread::hardware_concurrency())
+                                      ->UseRealTime();
+
+namespace
+{
+const std::size_t kGraphSize = 50000;
+
+struct Node
+{
+  explicit Node(const int* value_) : value{value_} {}
+  const int* value;
+};
+
+std::unique_ptr<Node> NodeFactory(const int* value)
+{
+  return std::make_unique<Node>(value);
+}
+
+// Graph of literal values and as many nodes that depend on them. The dependency lists are
+// prepared in advance, so only allocations by the ObjectManager and the nodes are counted.
+void BuildGraph(ObjectManager& object_manager, const std::vector<std::string>& names,
+                const std::vector<std::vector<std::string>>& dependencies)
+{
+  const std::string node_typename = "Node";
+  object_manager.RegisterFactoryFunction(node_typename, NodeFactory);
+  for (std::size_t i = 0; i < names.size(); i += 2)
+  {
+    object_manager.RegisterInstance(static_cast<int>(i), names[i]);
+    object_manager.CreateInstance(node_typename, names[i + 1], dependencies[i / 2]);
+  }
+}
+
+template <bool UseArena>
+void RunGraphBenchmark(benchmark::State& state, bool time_teardown)
+{
+  auto names = InstanceNames(kGraphSize);
+  std::vector<std::vector<std::string>> dependencies;
+  for (std::size_t i = 0; i < names.size(); i += 2)
+  {
+    dependencies.push_back({names[i]});
+  }
+  std::size_t n_allocations = 0;
+  for (auto _ : state)
+  {
+    auto start_count = sup::di::AllocationCount();
+    auto build_start = std::chrono::steady_clock::now();
+    auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+    auto object_manager = UseArena ? std::make_unique<ObjectManager>(arena.get())
+                                   : std::make_unique<ObjectManager>();
+    BuildGraph(*object_manager, names, dependencies);
+    auto teardown_start = std::chrono::steady_clock::now();
+    n_allocations += sup::di::AllocationCount() - start_count;
+    object_manager.reset();
+    arena.reset();
+    auto end = std::chrono::steady_clock::now();
+    auto elapsed = time_teardown ? end - teardown_start : teardown_start - build_start;
+    state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+  }
+  state.counters["allocs"] = static_cast<double>(n_allocations) / state.iterations();
+}
+}  // unnamed namespace
+
+template <bool UseArena>
+static void BM_ObjectGraphBuild(benchmark::State& state)
+{
+  RunGraphBenchmark<UseArena>(state, false);
+}
+BENCHMARK_TEMPLATE(BM_ObjectGraphBuild, false)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ObjectGraphBuild, true)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+template <bool UseArena>
+static void BM_ObjectGraphTeardown(benchmark::State& state)
+{
+  RunGraphBenchmark<UseArena>(state, true);
+}
+BENCHMARK_TEMPLATE(BM_ObjectGraphTeardown, false)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ObjectGraphTeardown, true)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+namespace
+{
+enum class ShortLivedLifetime
+{
+  kSingleton,
+  kTransient,
+  kScoped
+};
+}  // unnamed namespace
+
+// Create a short-lived instance with one dependency and release it again, as a request handler
+// would: stored in the ObjectManager and removed by taking ownership, created as a transient
+// instance, or created in a scope that is destroyed afterwards.
+template <ShortLivedLifetime Lifetime>
+static void BM_ShortLivedInstance(benchmark::State& state)
+{
+  auto names = InstanceNames(kNumberOfInstances);
+  ObjectManager object_manager;
+  RegisterValues(object_manager, names);
+  object_manager.RegisterFactoryFunction("CopyValue", CopyValue);
+  auto registered_typename = object_manager.Intern("CopyValue");
+  auto instance_name = object_manager.Intern("request/value");
+  std::vector<std::vector<Symbol>> dependencies;
+  for (const auto& name : names)
+  {
+    dependencies.push_back({object_manager.Intern(name)});
+  }
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    ErrorCode result = ErrorCode::kSuccess;
+    if constexpr (Lifetime == ShortLivedLifetime::kSingleton)
+    {
+      result = object_manager.CreateInstance(registered_typename, instance_name,
+                                             dependencies[idx]);
+      object_manager.GetInstance<std::unique_ptr<int>>(instance_name);
+    }
+    else if constexpr (Lifetime == ShortLivedLifetime::kTransient)
+    {
+      std::unique_ptr<int> instance;
+      result = object_manager.CreateTransient(registered_typename, dependencies[idx], instance);
+    }
+    else
+    {
+      InstanceScope scope{object_manager};
+      result = scope.CreateInstance(registered_typename, instance_name, dependencies[idx]);
+    }
+    if (result != ErrorCode::kSuccess)
+    {
+      state.SkipWithError("Instance creation failed");
+      break;
+    }
+    idx = (idx + 7919) % names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ShortLivedInstance, ShortLivedLifetime::kSingleton);
+BENCHMARK_TEMPLATE(BM_ShortLivedInstance, ShortLivedLifetime::kTransient);
+BENCHMARK_TEMPLATE(BM_ShortLivedInstance, ShortLivedLifetime::kScoped);
+
+// Set up and tear down a session: a child ObjectManager with a few private instances that depend
+// on a shared graph of range(0) values.
+static void BM_ChildObjectManager(benchmark::State& state)
+{
+  const std::size_t n_private = 4;
+  auto names = InstanceNames(state.range(0));
+  ObjectManager object_manager;
+  RegisterValues(object_manager, names);
+  object_manager.RegisterFactoryFunction("CopyValue", CopyValue);
+  object_manager.RegisterGlobalFunction("ReadValue", ReadValue);
+  auto registered_typename = object_manager.Intern("CopyValue");
+  auto function_name = object_manager.Intern("ReadValue");
+  std::vector<Symbol> private_names;
+  for (std::size_t i = 0; i < n_private; ++i)
+  {
+    private_names.push_back(object_manager.Intern("session/value_" + std::to_string(i)));
+  }
+  std::vector<std::vector<Symbol>> dependencies;
+  for (const auto& name : names)
+  {
+    dependencies.push_back({object_manager.Intern(name)});
+  }
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer)};
+    ObjectManager session{object_manager, &arena};
+    for (auto private_name : private_names)
+    {
+      session.CreateInstance(registered_typename, private_name, dependencies[idx]);
+      idx = (idx + 7919) % names.size();
+    }
+    for (auto private_name : private_names)
+    {
+      benchmark::DoNotOptimize(session.CallGlobalFunction(function_name, {private_name}));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChildObjectManager)->Apply(InstanceCounts);
+
+enum class PopulateMode
+{
+  kSingle,
+  kReserved,
+  kBatch
+};
+
+// Populate a fresh child ObjectManager with range(0) instances that each copy one of the values of
+// its parent: one CreateInstance call at a time, after reserving capacity for all of them, or with
+// a single CreateInstances batch.
+template <PopulateMode Mode>
+static void BM_PopulateInstances(benchmark::State& state)
+{
+  const std::size_t n_created = state.range(0);
+  auto names = InstanceNames(kNumberOfInstances);
+  ObjectManager object_manager;
+  RegisterValues(object_manager, names);
+  object_manager.RegisterFactoryFunction("CopyValue", CopyValue);
+  auto registered_typename = object_manager.Intern("CopyValue");
+  std::vector<Symbol> created_names;
+  std::vector<std::vector<Symbol>> dependencies;
+  for (std::size_t i = 0; i < n_created; ++i)
+  {
+    created_names.push_back(object_manager.Intern("plant/subsystem/copy_" + std::to_string(i)));
+    dependencies.push_back({object_manager.Intern(names[(7919 * i) % names.size()])});
+  }
+  std::vector<CreateInstanceRequest> requests;
+  for (std::size_t i = 0; i < n_created; ++i)
+  {
+    requests.push_back({registered_typename, created_names[i], dependencies[i]});
+  }
+  std::vector<ErrorCode> results;
+  for (auto _ : state)
+  {
+    ObjectManager populated{object_manager, std::pmr::get_default_resource()};
+    if constexpr (Mode == PopulateMode::kBatch)
+    {
+      benchmark::DoNotOptimize(populated.CreateInstances(requests, results));
+    }
+    else
+    {
+      if constexpr (Mode == PopulateMode::kReserved)
+      {
+        populated.Reserve(1, n_created);
+      }
+      for (std::size_t i = 0; i < n_created; ++i)
+      {
+        benchmark::DoNotOptimize(
+          populated.CreateInstance(registered_typename, created_names[i], dependencies[i]));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n_created);
+}
+BENCHMARK_TEMPLATE(BM_PopulateInstances, PopulateMode::kSingle)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PopulateInstances, PopulateMode::kReserved)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PopulateInstances, PopulateMode::kBatch)->Arg(64)->Arg(1024);
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "allocation_counter.h"
+#include "benchmark_utils.h"
+
+#include <sup/di/service_store.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+using namespace sup::di::bench;
+using namespace sup::di::internal;
+
+namespace
+{
+using OrderedServiceStore = ServiceStore<std::string, FlatTypeMap, InstanceMap>;
+using HashedServiceStore = ServiceStore<std::string, FlatTypeMap, HashedInstanceMap>;
+
+template <typename Store>
+void FillStore(Store& store, const std::vector<std::string>& names)
+{
+  int value = 0;
+  for (const auto& name : names)
+  {
+    store.StoreInstance(std::make_unique<int>(value++), name);
+  }
+}
+}  // unnamed namespace
+
+template <typename Store>
+static void BM_StoreInstance(benchmark::State& state)
+{
+  auto names = InstanceNames(state.range(0));
+  std::size_t n_allocations = 0;
+  for (auto _ : state)
+  {
+    auto start_count = sup::di::AllocationCount();
+    Store store;
+    FillStore(store, names);
+    n_allocations += sup::di::AllocationCount() - start_count;
+    benchmark::DoNotOptimize(&store);
+  }
+  state.SetItemsProcessed(state.range(0) * state.iterations());
+  state.counters["allocs_per_instance"] =
+    static_cast<double>(n_allocations) / (state.range(0) * state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_StoreInstance, OrderedServiceStore)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_StoreInstance, HashedServiceStore)->Apply(InstanceCounts);
+
+// Copies the values into the store: no separate allocation per value and container
+template <typename Store>
+static void BM_StoreValue(benchmark::State& state)
+{
+  auto names = InstanceNames(state.range(0));
+  std::size_t n_allocations = 0;
+  for (auto _ : state)
+  {
+    auto start_count = sup::di::AllocationCount();
+    Store store;
+    int value = 0;
+    for (const auto& name : names)
+    {
+      store.StoreValue(value++, name);
+    }
+    n_allocations += sup::di::AllocationCount() - start_count;
+    benchmark::DoNotOptimize(&store);
+  }
+  state.SetItemsProcessed(state.range(0) * state.iterations());
+  state.counters["allocs_per_instance"] =
+    static_cast<double>(n_allocations) / (state.range(0) * state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_StoreValue, OrderedServiceStore)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_StoreValue, HashedServiceStore)->Apply(InstanceCounts);
+
+template <typename Store>
+static void BM_GetInstanceByString(benchmark::State& state)
+{
+  auto names = InstanceNames(state.range(0));
+  Store store;
+  FillStore(store, names);
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(store.template GetInstance<int*>(names[idx]));
+    idx = (idx + 7919) % names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_GetInstanceByString, OrderedServiceStore)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_GetInstanceByString, HashedServiceStore)->Apply(InstanceCounts);
+
+// Take ownership of an instance out of the store and put it back, since the store would run out
+// of instances otherwise
+template <typename Store>
+static void BM_TransferOwnership(benchmark::State& state)
+{
+  auto names = InstanceNames(state.range(0));
+  Store store;
+  FillStore(store, names);
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    auto instance = store.template GetInstance<std::unique_ptr<int>>(names[idx]);
+    store.StoreInstance(std::move(instance), names[idx]);
+    idx = (idx + 7919) % names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_TransferOwnership, OrderedServiceStore)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_TransferOwnership, HashedServiceStore)->Apply(InstanceCounts);
+
+template <typename Store>
+static void BM_GetInstanceByStringView(benchmark::State& state)
+{
+  auto names = InstanceNames(state.range(0));
+  std::vector<std::string_view> keys(names.begin(), names.end());
+  Store store;
+  FillStore(store, names);
+  std::size_t idx = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(store.template GetInstance<int*>(keys[idx]));
+    idx = (idx + 7919) % keys.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_GetInstanceByStringView, OrderedServiceStore)->Apply(InstanceCounts);
+BENCHMARK_TEMPLATE(BM_GetInstanceByStringView, HashedServiceStore)->Apply(InstanceCounts);
+
+namespace
+{
+bool UseTwoInstances(int*, int*)
+{
+  return true;
+}
+}  // unnamed namespace
+
+static void BM_InvokeMissingDependencyThrowing(benchmark::State& state)
+{
+  HashedServiceStore store;
+  FillStore(store, InstanceNames(16));
+  std::vector<std::string> keys{InstanceNames(1)[0], "missing"};
+  for (auto _ : state)
+  {
+    bool success = false;
+    try
+    {
+      success = InvokeWithStoreArgs<int*, int*>(UseTwoInstances, store, keys);
+    }
+    catch (const std::runtime_error&)
+    {}
+    benchmark::DoNotOptimize(success);
+  }
+}
+BENCHMARK(BM_InvokeMissingDependencyThrowing);
+
+static void BM_InvokeMissingDependencyNonThrowing(benchmark::State& state)
+{
+  HashedServiceStore store;
+  FillStore(store, InstanceNames(16));
+  std::vector<std::string> keys{InstanceNames(1)[0], "missing"};
+  for (auto _ : state)
+  {
+    auto result = TryInvokeWithStoreArgs<int*, int*>(UseTwoInstances, store, keys);
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_InvokeMissingDependencyNonThrowing);
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/di/flat_type_map.h>
+#include <sup/di/type_map.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace sup::di::internal;
+
+namespace
+{
+template <int N>
+struct BenchmarkType
+{};
+
+template <template <typename> class TypeMapT, int... N>
+void PutBenchmarkTypes(TypeMapT<int>& type_map)
+{
+  int dummy[] = { (type_map.template put<BenchmarkType<N>>(int{N}), 0)... };
+  (void)dummy;
+}
+
+template <template <typename> class TypeMapT>
+void FillTypeMap(TypeMapT<int>& type_map)
+{
+  PutBenchmarkTypes<TypeMapT, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+                    19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31>(type_map);
+}
+}  // unnamed namespace
+
+template <template <typename> class TypeMapT>
+static void BM_TypeMapFind(benchmark::State& state)
+{
+  TypeMapT<int> type_map;
+  FillTypeMap(type_map);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(type_map.template find<BenchmarkType<7>>());
+    benchmark::DoNotOptimize(type_map.template find<BenchmarkType<19>>());
+    benchmark::DoNotOptimize(type_map.template find<BenchmarkType<31>>());
+    benchmark::DoNotOptimize(type_map.template find<double>());
+  }
+  state.SetItemsProcessed(4 * state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_TypeMapFind, TypeMap);
+BENCHMARK_TEMPLATE(BM_TypeMapFind, FlatTypeMap);
+
+template <template <typename> class TypeMapT>
+static void BM_TypeMapPut(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    TypeMapT<int> type_map;
+    FillTypeMap(type_map);
+    benchmark::DoNotOptimize(type_map.begin());
+  }
+  state.SetItemsProcessed(32 * state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_TypeMapPut, TypeMap);
+BENCHMARK_TEMPLATE(BM_TypeMapPut, FlatTypeMap);
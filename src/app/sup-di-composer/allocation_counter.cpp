@@ -0,0 +1,128 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<std::size_t> allocation_count{0};
+
+void* CountedAllocate(std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* result = std::malloc(size == 0 ? 1 : size))
+  {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+
+void* CountedAlignedAllocate(std::size_t size, std::align_val_t alignment)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  auto align = static_cast<std::size_t>(alignment);
+  // std::aligned_alloc requires the size to be a multiple of the alignment
+  if (void* result = std::aligned_alloc(align, (size + align - 1) / align * align))
+  {
+    return result;
+  }
+  throw std::bad_alloc{};
+}
+}  // unnamed namespace
+
+namespace sup
+{
+namespace di
+{
+std::size_t AllocationCount()
+{
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace di
+
+}  // namespace sup
+
+void* operator new(std::size_t size)
+{
+  return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return CountedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// Aligned versions, used by std::pmr::new_delete_resource()
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  return CountedAlignedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return CountedAlignedAllocate(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_APP_ALLOCATION_COUNTER_H_
+#define SUP_DI_COMPOSER_APP_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace sup
+{
+namespace di
+{
+/**
+ * @brief Number of calls to the global operator new, including the aligned versions, since the
+ * start of the program.
+ *
+ * @details The count is maintained by replacements of the global allocation functions, which are
+ * only linked into executables that need it: the composer when it is built with instrumentation,
+ * where it is passed to the trace recorder, and the benchmarks.
+ */
+std::size_t AllocationCount();
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_APP_ALLOCATION_COUNTER_H_
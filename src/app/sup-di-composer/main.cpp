@@ -20,9 +20,17 @@
  * of the distribution package.
  ******************************************************************************/
 
+#ifdef SUP_DI_INSTRUMENTATION
+#include "allocation_counter.h"
+#endif
+
+#include <sup/di-composer-core/compiled_object_tree.h>
 #include <sup/di-composer-core/composition_root.h>
+#include <sup/di/object_manager.h>
+#include <sup/di/trace_recorder.h>
 
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -31,7 +39,30 @@ void print_usage(const std::string& prog_name)
 {
   std::cout << "Usage: " << prog_name << " <options>" << std::endl;
   std::cout << "Options: -h|--help: Print usage." << std::endl;
-  std::cout << "         -f|--file <filename>: Load, parse and execute <filename>." << std::endl;
+  std::cout << "         -f|--file <filename>: Load, parse and execute <filename>, which is an "
+               "XML file or a compiled image."
+            << std::endl;
+  std::cout << "         -c|--compile <image>: Compile <filename> into a binary <image> instead "
+               "of executing it."
+            << std::endl;
+  std::cout << "         -j|--jobs <n>: Execute independent elements concurrently on <n> threads."
+            << std::endl;
+  std::cout << "         --lazy: Create instances only when they are first used." << std::endl;
+  std::cout << "         --prefetch: Read libraries into the page cache in the background "
+               "before loading them."
+            << std::endl;
+  std::cout << "         --stream: Parse and execute one element at a time, keeping only that "
+               "element in memory."
+            << std::endl;
+  std::cout << "         --cache <directory>: Reuse parsed and validated XML files from, and "
+               "store them in, <directory>."
+            << std::endl;
+  std::cout << "         --report: Print wall time, CPU time and allocations per phase and for "
+               "the slowest elements."
+            << std::endl;
+  std::cout << "         --trace <filename>: Write phase and element timings as a Chrome "
+               "trace-event JSON file."
+            << std::endl;
   std::cout << std::endl;
   std::cout << "The program loads <filename>, parses it, creates objects with dependency "
                "injection and calls functions on those instances."
@@ -41,6 +72,14 @@ void print_usage(const std::string& prog_name)
 
 bool HasHelpOption(const std::vector<std::string>& arguments);
 std::string GetFileName(const std::vector<std::string>& arguments);
+std::string GetCompileFileName(const std::vector<std::string>& arguments);
+std::size_t GetNumberOfJobs(const std::vector<std::string>& arguments);
+bool HasLazyOption(const std::vector<std::string>& arguments);
+bool HasPrefetchOption(const std::vector<std::string>& arguments);
+bool HasStreamOption(const std::vector<std::string>& arguments);
+std::string GetCacheDirectory(const std::vector<std::string>& arguments);
+bool HasReportOption(const std::vector<std::string>& arguments);
+std::string GetTraceFileName(const std::vector<std::string>& arguments);
 
 int main(int argc, char* argv[])
 {
@@ -54,7 +93,66 @@ int main(int argc, char* argv[])
     print_usage(arguments.at(0));
     return 0;
   }
-  sup::di::ExecuteObjectTreeFromFile(filename);
+  auto image_filename = GetCompileFileName(arguments);
+  if (!image_filename.empty())
+  {
+    sup::di::CompileObjectTreeFile(filename, image_filename);
+    return 0;
+  }
+  sup::di::ComposerOptions options;
+  options.n_threads = GetNumberOfJobs(arguments);
+  options.lazy_instances = HasLazyOption(arguments);
+  options.prefetch_libraries = HasPrefetchOption(arguments);
+  options.streaming = HasStreamOption(arguments);
+  options.cache_directory = GetCacheDirectory(arguments);
+  auto report = HasReportOption(arguments);
+  auto trace_filename = GetTraceFileName(arguments);
+#ifdef SUP_DI_INSTRUMENTATION
+  sup::di::TraceRecorder recorder{sup::di::AllocationCount};
+#else
+  sup::di::TraceRecorder recorder;
+#endif
+  if (report || !trace_filename.empty())
+  {
+#ifndef SUP_DI_INSTRUMENTATION
+    std::cerr << "Warning: sup-di-composer was built without instrumentation "
+                 "(COA_INSTRUMENTATION=OFF); no timings will be recorded."
+              << std::endl;
+#endif
+    options.trace_recorder = &recorder;
+  }
+  // Calls on the global ObjectManager are recorded as spans nested in those of the elements
+  auto& global_object_manager = sup::di::GlobalObjectManager();
+  auto previous_recorder = global_object_manager.GetTraceRecorder();
+  if (options.trace_recorder != nullptr)
+  {
+    global_object_manager.SetTraceRecorder(options.trace_recorder);
+  }
+  if (sup::di::IsCompiledObjectTreeFile(filename))
+  {
+    sup::di::ExecuteCompiledObjectTreeFromFile(filename, options);
+  }
+  else
+  {
+    sup::di::ExecuteObjectTreeFromFile(filename, options);
+  }
+  global_object_manager.SetTraceRecorder(previous_recorder);
+  // Release the capacity that was reserved for the configuration but not used
+  global_object_manager.ShrinkToFit();
+  if (report)
+  {
+    recorder.WriteReport(std::cout);
+  }
+  if (!trace_filename.empty())
+  {
+    std::ofstream trace_file{trace_filename};
+    recorder.WriteChromeTrace(trace_file);
+    if (!trace_file)
+    {
+      std::cerr << "Error: could not write trace file [" << trace_filename << "]" << std::endl;
+      return 1;
+    }
+  }
   return 0;
 }
 
@@ -78,3 +176,89 @@ std::string GetFileName(const std::vector<std::string>& arguments)
   std::string filename = std::next(it) < arguments.end() ? *std::next(it) : "";
   return filename.find_first_of("-") == 0 ? "" : filename;
 }
+
+//! Returns the image filename, which is the parameter after --compile or -c option (default empty).
+
+std::string GetCompileFileName(const std::vector<std::string>& arguments)
+{
+  auto on_argument = [](const std::string& str) { return str == "--compile" || str == "-c"; };
+  auto it = std::find_if(arguments.begin(), arguments.end(), on_argument);
+  if (it == arguments.end() || std::next(it) == arguments.end())
+  {
+    return {};
+  }
+  return *std::next(it);
+}
+
+//! Returns the number of jobs, which is the parameter after --jobs or -j option (default 1).
+
+std::size_t GetNumberOfJobs(const std::vector<std::string>& arguments)
+{
+  auto on_argument = [](const std::string& str) { return str == "--jobs" || str == "-j"; };
+  auto it = std::find_if(arguments.begin(), arguments.end(), on_argument);
+  if (it == arguments.end() || std::next(it) == arguments.end())
+  {
+    return 1;
+  }
+  try
+  {
+    auto n_jobs = std::stoul(*std::next(it));
+    return n_jobs > 0 ? n_jobs : 1;
+  }
+  catch (const std::exception&)
+  {
+    return 1;
+  }
+}
+
+//! Returns true if --lazy option is present.
+
+bool HasLazyOption(const std::vector<std::string>& arguments)
+{
+  return std::find(arguments.begin(), arguments.end(), "--lazy") != arguments.end();
+}
+
+//! Returns true if --prefetch option is present.
+
+bool HasPrefetchOption(const std::vector<std::string>& arguments)
+{
+  return std::find(arguments.begin(), arguments.end(), "--prefetch") != arguments.end();
+}
+
+//! Returns true if --stream option is present.
+
+bool HasStreamOption(const std::vector<std::string>& arguments)
+{
+  return std::find(arguments.begin(), arguments.end(), "--stream") != arguments.end();
+}
+
+//! Returns the cache directory, which is the parameter after --cache option (default empty).
+
+std::string GetCacheDirectory(const std::vector<std::string>& arguments)
+{
+  auto it = std::find(arguments.begin(), arguments.end(), "--cache");
+  if (it == arguments.end() || std::next(it) == arguments.end())
+  {
+    return {};
+  }
+  return *std::next(it);
+}
+
+//! Returns true if --report option is present.
+
+bool HasReportOption(const std::vector<std::string>& arguments)
+{
+  return std::find(arguments.begin(), arguments.end(), "--report") != arguments.end();
+}
+
+//! Returns the trace filename, which is the parameter after --trace option (default empty).
+
+std::string GetTraceFileName(const std::vector<std::string>& arguments)
+{
+  auto it = std::find(arguments.begin(), arguments.end(), "--trace");
+  if (it == arguments.end() || std::next(it) == arguments.end())
+  {
+    return {};
+  }
+  return *std::next(it);
+}
@@ -0,0 +1,651 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "compiled_object_tree.h"
+
+#include "constants.h"
+#include "exceptions.h"
+#include "function_element.h"
+#include "instance_element.h"
+#include "instrumentation.h"
+#include "library_element.h"
+#include "library_prefetcher.h"
+#include "object_composer_element.h"
+#include "tree_extract.h"
+
+#include <sup/di/di_utils.h>
+#include <sup/di/object_manager.h>
+
+#include <sup/xml/tree_data_parser.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace sup::di::compiled;
+
+/**
+ * @brief Collects the sections of an image while compiling a tree.
+ */
+class ImageBuilder
+{
+public:
+  ImageBuilder();
+  ~ImageBuilder() = default;
+
+  ImageBuilder(const ImageBuilder& other) = delete;
+  ImageBuilder& operator=(const ImageBuilder& other) = delete;
+
+  std::uint32_t AddString(const std::string& str);
+  void AddElement(const sup::xml::TreeData& element_tree);
+  std::string Build() const;
+
+private:
+  std::unordered_map<std::string, std::uint32_t> m_string_indices;
+  std::vector<StringEntry> m_strings;
+  std::vector<ElementRecord> m_records;
+  std::vector<std::uint32_t> m_dependencies;
+  std::string m_string_data;
+};
+
+/**
+ * @brief Read-only view of an image whose section sizes and indices were checked.
+ */
+class ImageView
+{
+public:
+  ImageView(const void* image, std::size_t size);
+
+  std::uint32_t GetStringCount() const { return m_header->n_strings; }
+  std::string_view GetString(std::uint32_t index) const;
+  const ElementRecord* begin() const { return m_records; }
+  const ElementRecord* end() const { return m_records + m_header->n_records; }
+  std::uint32_t GetDependencyCount() const { return m_header->n_dependencies; }
+  std::uint32_t GetDependency(std::uint32_t index) const { return m_dependencies[index]; }
+
+private:
+  const ImageHeader* m_header;
+  const StringEntry* m_strings;
+  const ElementRecord* m_records;
+  const std::uint32_t* m_dependencies;
+  const char* m_string_data;
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  const void* GetData() const { return m_data; }
+  std::size_t GetSize() const { return m_size; }
+
+private:
+  void* m_data;
+  std::size_t m_size;
+};
+
+void ExecuteImage(const ImageView& image, const sup::di::ComposerOptions& options);
+
+bool TryExecuteImageFile(const std::string& filename, std::optional<std::string_view> source,
+                         const sup::di::ComposerOptions& options);
+
+std::uint64_t ParseLiteralValue(const std::string& tag, const std::string& value_rep);
+
+std::size_t AlignedSize(std::size_t size);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace di
+{
+
+std::string CompileObjectTree(const sup::xml::TreeData& composer_tree)
+{
+  ValidateComposerTree(composer_tree);
+  ImageBuilder builder;
+  for (const auto& child : composer_tree.Children())
+  {
+    builder.AddElement(child);
+  }
+  return builder.Build();
+}
+
+void CompileObjectTreeFile(const std::string& xml_filename, const std::string& image_filename)
+{
+  auto composer_tree = sup::xml::TreeDataFromFile(xml_filename);
+  auto image = CompileObjectTree(*composer_tree);
+  std::ofstream image_file{image_filename, std::ios::binary};
+  image_file.write(image.data(), static_cast<std::streamsize>(image.size()));
+  if (!image_file)
+  {
+    std::string error_message =
+      "CompileObjectTreeFile(): could not write image file [" + image_filename + "]";
+    throw RuntimeException(error_message);
+  }
+}
+
+bool IsCompiledObjectTreeFile(const std::string& filename)
+{
+  char magic[sizeof(compiled::kMagic)] = {};
+  std::ifstream file{filename, std::ios::binary};
+  file.read(magic, sizeof(magic));
+  return file && std::memcmp(magic, compiled::kMagic, sizeof(magic)) == 0;
+}
+
+void ExecuteCompiledObjectTree(const void* image, std::size_t size, const ComposerOptions& options)
+{
+  std::unique_ptr<ImageView> view;
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "validate", "phase");
+    view = std::make_unique<ImageView>(image, size);
+  }
+  ExecuteImage(*view, options);
+}
+
+void ExecuteCompiledObjectTreeFromFile(const std::string& filename, const ComposerOptions& options)
+{
+  std::unique_ptr<MappedFile> mapped_file;
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "map", "phase");
+    SUP_DI_TRACE_ARGUMENT(span, "file", filename);
+    mapped_file = std::make_unique<MappedFile>(filename);
+  }
+  ExecuteCompiledObjectTree(mapped_file->GetData(), mapped_file->GetSize(), options);
+}
+
+bool TryExecuteCompiledObjectTreeFromFile(const std::string& filename,
+                                          const ComposerOptions& options)
+{
+  return TryExecuteImageFile(filename, std::nullopt, options);
+}
+
+bool TryExecuteCompiledObjectTreeFromFile(const std::string& filename, std::string_view source,
+                                          const ComposerOptions& options)
+{
+  return TryExecuteImageFile(filename, source, options);
+}
+
+}  // namespace di
+
+}  // namespace sup
+
+namespace
+{
+ImageBuilder::ImageBuilder()
+  : m_string_indices{}
+  , m_strings{}
+  , m_records{}
+  , m_dependencies{}
+  , m_string_data{}
+{}
+
+std::uint32_t ImageBuilder::AddString(const std::string& str)
+{
+  auto it = m_string_indices.find(str);
+  if (it != m_string_indices.end())
+  {
+    return it->second;
+  }
+  auto index = static_cast<std::uint32_t>(m_strings.size());
+  m_strings.push_back({static_cast<std::uint32_t>(m_string_data.size()),
+                       static_cast<std::uint32_t>(str.size())});
+  m_string_data += str;
+  m_string_indices.emplace(str, index);
+  return index;
+}
+
+void ImageBuilder::AddElement(const sup::xml::TreeData& element_tree)
+{
+  namespace constants = sup::di::constants;
+  ElementRecord record{};
+  record.first_dependency = static_cast<std::uint32_t>(m_dependencies.size());
+  auto nodename = element_tree.GetNodeName();
+  if (nodename == constants::LOAD_LIBRARY_TAG)
+  {
+    sup::di::ValidateLibraryTree(element_tree);
+    std::string library_name;
+    sup::di::utils::SetFromTreeNodeContent(library_name, element_tree);
+    auto load_options = sup::di::GetLibraryLoadOptions(element_tree);
+    record.kind = ElementKind::kLoadLibrary;
+    record.name = AddString(library_name);
+    record.value = (load_options.lazy_binding ? kLazyBinding : 0) |
+                   (load_options.global_symbols ? kGlobalSymbols : 0) |
+                   (load_options.no_delete ? kNoDelete : 0);
+  }
+  else if (nodename == constants::CREATE_INSTANCE_TAG || nodename == constants::CALL_FUNCTION_TAG)
+  {
+    const bool is_instance = nodename == constants::CREATE_INSTANCE_TAG;
+    if (is_instance)
+    {
+      sup::di::ValidateInstanceTree(element_tree);
+    }
+    else
+    {
+      sup::di::ValidateFunctionTree(element_tree);
+    }
+    record.kind = is_instance ? ElementKind::kInstance : ElementKind::kCallFunction;
+    for (const auto& child : element_tree.Children())
+    {
+      std::string content;
+      sup::di::utils::SetFromTreeNodeContent(content, child);
+      auto child_name = child.GetNodeName();
+      if (child_name == constants::TYPE_NAME_TAG)
+      {
+        record.type_name = AddString(content);
+      }
+      else if (child_name == constants::INSTANCE_NAME_TAG ||
+               child_name == constants::FUNCTION_NAME_TAG)
+      {
+        record.name = AddString(content);
+      }
+      else
+      {
+        m_dependencies.push_back(AddString(content));
+        ++record.n_dependencies;
+      }
+    }
+  }
+  else if (nodename == constants::STRING_INSTANCE_TAG ||
+           nodename == constants::INTEGER_INSTANCE_TAG ||
+           nodename == constants::DOUBLE_INSTANCE_TAG)
+  {
+    sup::di::ValidateLiteralInstanceTree(element_tree);
+    record.kind = nodename == constants::STRING_INSTANCE_TAG ? ElementKind::kStringInstance
+                : nodename == constants::INTEGER_INSTANCE_TAG ? ElementKind::kIntegerInstance
+                : ElementKind::kDoubleInstance;
+    for (const auto& child : element_tree.Children())
+    {
+      std::string content;
+      sup::di::utils::SetFromTreeNodeContent(content, child);
+      if (child.GetNodeName() == constants::INSTANCE_NAME_TAG)
+      {
+        record.name = AddString(content);
+      }
+      else
+      {
+        record.value = record.kind == ElementKind::kStringInstance
+                         ? AddString(content)
+                         : ParseLiteralValue(nodename, content);
+      }
+    }
+  }
+  else
+  {
+    std::string error_message = "sup::di::CompileObjectTree(): unknown child tag [" + nodename +
+      "] of [" + constants::OBJECT_COMPOSER_TAG + "] element";
+    throw sup::di::ParseException(error_message);
+  }
+  m_records.push_back(record);
+}
+
+std::string ImageBuilder::Build() const
+{
+  ImageHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kFormatVersion;
+  header.n_strings = static_cast<std::uint32_t>(m_strings.size());
+  header.n_records = static_cast<std::uint32_t>(m_records.size());
+  header.n_dependencies = static_cast<std::uint32_t>(m_dependencies.size());
+  header.string_data_size = m_string_data.size();
+  std::string image;
+  auto append = [&image](const void* data, std::size_t size) {
+    image.append(static_cast<const char*>(data), size);
+  };
+  append(&header, sizeof(header));
+  append(m_strings.data(), m_strings.size() * sizeof(StringEntry));
+  append(m_records.data(), m_records.size() * sizeof(ElementRecord));
+  auto dependencies_size = m_dependencies.size() * sizeof(std::uint32_t);
+  append(m_dependencies.data(), dependencies_size);
+  image.append(AlignedSize(dependencies_size) - dependencies_size, '\0');
+  image += m_string_data;
+  return image;
+}
+
+ImageView::ImageView(const void* image, std::size_t size)
+  : m_header{static_cast<const ImageHeader*>(image)}
+  , m_strings{nullptr}
+  , m_records{nullptr}
+  , m_dependencies{nullptr}
+  , m_string_data{nullptr}
+{
+  auto fail = [](const std::string& reason) {
+    throw sup::di::ParseException("sup::di::ExecuteCompiledObjectTree(): " + reason);
+  };
+  if (reinterpret_cast<std::uintptr_t>(image) % alignof(ImageHeader) != 0)
+  {
+    fail("image is not aligned");
+  }
+  if (size < sizeof(ImageHeader) || std::memcmp(m_header->magic, kMagic, sizeof(kMagic)) != 0)
+  {
+    fail("not a compiled object tree");
+  }
+  if (m_header->version != kFormatVersion)
+  {
+    fail("unsupported image version [" + std::to_string(m_header->version) + "]");
+  }
+  const std::size_t records_offset =
+    sizeof(ImageHeader) + std::size_t{m_header->n_strings} * sizeof(StringEntry);
+  const std::size_t dependencies_offset =
+    records_offset + std::size_t{m_header->n_records} * sizeof(ElementRecord);
+  const std::size_t string_data_offset = dependencies_offset +
+    AlignedSize(std::size_t{m_header->n_dependencies} * sizeof(std::uint32_t));
+  if (string_data_offset > size || size - string_data_offset != m_header->string_data_size)
+  {
+    fail("image size does not match its header");
+  }
+  const auto* bytes = static_cast<const char*>(image);
+  m_strings = reinterpret_cast<const StringEntry*>(bytes + sizeof(ImageHeader));
+  m_records = reinterpret_cast<const ElementRecord*>(bytes + records_offset);
+  m_dependencies = reinterpret_cast<const std::uint32_t*>(bytes + dependencies_offset);
+  m_string_data = bytes + string_data_offset;
+  for (std::uint32_t idx = 0; idx < m_header->n_strings; ++idx)
+  {
+    const auto& entry = m_strings[idx];
+    if (std::uint64_t{entry.offset} + entry.size > m_header->string_data_size)
+    {
+      fail("string out of bounds");
+    }
+  }
+  for (std::uint32_t idx = 0; idx < m_header->n_dependencies; ++idx)
+  {
+    if (m_dependencies[idx] >= m_header->n_strings)
+    {
+      fail("dependency out of bounds");
+    }
+  }
+  for (const auto& record : *this)
+  {
+    const bool has_type = record.kind == ElementKind::kInstance;
+    const bool has_string_value = record.kind == ElementKind::kStringInstance;
+    if (record.kind > ElementKind::kDoubleInstance || record.name >= m_header->n_strings ||
+        (has_type && record.type_name >= m_header->n_strings) ||
+        (has_string_value && record.value >= m_header->n_strings) ||
+        std::uint64_t{record.first_dependency} + record.n_dependencies >
+          m_header->n_dependencies)
+    {
+      fail("element record out of bounds");
+    }
+    if (record.kind == ElementKind::kLoadLibrary && (record.value & ~kLibraryLoadFlags) != 0)
+    {
+      fail("unknown library load flags");
+    }
+  }
+}
+
+std::string_view ImageView::GetString(std::uint32_t index) const
+{
+  const auto& entry = m_strings[index];
+  return { m_string_data + entry.offset, entry.size };
+}
+
+MappedFile::MappedFile(const std::string& filename)
+  : m_data{nullptr}
+  , m_size{0}
+{
+  int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat file_status{};
+  if (fd < 0 || ::fstat(fd, &file_status) != 0)
+  {
+    if (fd >= 0)
+    {
+      ::close(fd);
+    }
+    throw sup::di::ParseException(
+      "sup::di::ExecuteCompiledObjectTreeFromFile(): could not open file [" + filename + "]");
+  }
+  m_size = static_cast<std::size_t>(file_status.st_size);
+  if (m_size > 0)
+  {
+    m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);
+  if (m_data == MAP_FAILED || m_data == nullptr)
+  {
+    m_data = nullptr;
+    throw sup::di::ParseException(
+      "sup::di::ExecuteCompiledObjectTreeFromFile(): could not map file [" + filename + "]");
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  ::munmap(m_data, m_size);
+}
+
+// Without a source, the whole file is the image. Otherwise the file must end with the source,
+// which is not part of the image.
+bool TryExecuteImageFile(const std::string& filename, std::optional<std::string_view> source,
+                         const sup::di::ComposerOptions& options)
+{
+  std::unique_ptr<MappedFile> mapped_file;
+  std::unique_ptr<ImageView> view;
+  try
+  {
+    {
+      SUP_DI_TRACE_SPAN(span, options.trace_recorder, "map", "phase");
+      SUP_DI_TRACE_ARGUMENT(span, "file", filename);
+      mapped_file = std::make_unique<MappedFile>(filename);
+    }
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "validate", "phase");
+    auto image_size = mapped_file->GetSize();
+    if (source)
+    {
+      if (image_size < source->size())
+      {
+        return false;
+      }
+      image_size -= source->size();
+      const auto* stored_source = static_cast<const char*>(mapped_file->GetData()) + image_size;
+      if (source->compare(0, source->size(), stored_source, source->size()) != 0)
+      {
+        return false;
+      }
+    }
+    view = std::make_unique<ImageView>(mapped_file->GetData(), image_size);
+  }
+  catch (const sup::di::ParseException&)
+  {
+    return false;
+  }
+  ExecuteImage(*view, options);
+  return true;
+}
+
+void ExecuteImage(const ImageView& image, const sup::di::ComposerOptions& options)
+{
+  std::vector<std::string> library_names;
+  for (const auto& record : image)
+  {
+    if (options.prefetch_libraries && record.kind == ElementKind::kLoadLibrary)
+    {
+      library_names.emplace_back(image.GetString(record.name));
+    }
+  }
+  sup::di::LibraryPrefetcher prefetcher{std::move(library_names), options.trace_recorder};
+  auto& object_manager = sup::di::GlobalObjectManager();
+  std::vector<sup::di::Symbol> symbols(image.GetStringCount());
+  std::vector<sup::di::Symbol> dependencies(image.GetDependencyCount());
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "intern", "phase");
+    for (std::uint32_t idx = 0; idx < symbols.size(); ++idx)
+    {
+      symbols[idx] = object_manager.Intern(image.GetString(idx));
+    }
+    for (std::uint32_t idx = 0; idx < dependencies.size(); ++idx)
+    {
+      dependencies[idx] = symbols[image.GetDependency(idx)];
+    }
+  }
+  SUP_DI_TRACE_SPAN(span, options.trace_recorder, "execute", "phase");
+  std::set<sup::di::Symbol> types;
+  std::size_t instance_count = 0;
+  for (const auto& record : image)
+  {
+    if (record.kind != ElementKind::kLoadLibrary && record.kind != ElementKind::kCallFunction)
+    {
+      types.insert(record.kind == ElementKind::kInstance ? symbols[record.type_name]
+                                                         : symbols[record.name]);
+      ++instance_count;
+    }
+  }
+  object_manager.Reserve(types.size(), instance_count);
+  // Scratch buffers whose capacity is reused by all elements
+  std::vector<sup::di::CreateInstanceRequest> requests;
+  std::vector<sup::di::ErrorCode> results;
+  std::vector<sup::di::Symbol> dependency_list;
+  auto it = image.begin();
+  while (it != image.end())
+  {
+    const auto& record = *it;
+    const sup::di::internal::SymbolList record_dependencies{
+      dependencies.data() + record.first_dependency, record.n_dependencies};
+    if (record.kind == ElementKind::kInstance && !options.lazy_instances)
+    {
+      requests.clear();
+      for (; it != image.end() && it->kind == ElementKind::kInstance; ++it)
+      {
+        requests.push_back({symbols[it->type_name], symbols[it->name],
+                            {dependencies.data() + it->first_dependency, it->n_dependencies}});
+      }
+      object_manager.CreateInstances(requests, results, true);
+      for (std::size_t idx = 0; idx < results.size(); ++idx)
+      {
+        sup::di::CheckCreateInstanceResult(results[idx], requests[idx].registered_typename,
+                                           requests[idx].instance_name);
+      }
+      continue;
+    }
+    ++it;
+    const auto name = symbols[record.name];
+    bool registered = true;
+    switch (record.kind)
+    {
+    case ElementKind::kLoadLibrary:
+    {
+      std::string library_name{image.GetString(record.name)};
+      sup::di::utils::LibraryLoadOptions load_options;
+      load_options.lazy_binding = (record.value & kLazyBinding) != 0;
+      load_options.global_symbols = (record.value & kGlobalSymbols) != 0;
+      load_options.no_delete = (record.value & kNoDelete) != 0;
+      if (sup::di::utils::LoadLibrary(library_name, load_options) != sup::di::ErrorCode::kSuccess)
+      {
+        throw sup::di::RuntimeException(
+          "sup::di::ExecuteCompiledObjectTree(): could not load library with name [" +
+          library_name + "]");
+      }
+      break;
+    }
+    case ElementKind::kInstance:
+    {
+      dependency_list.assign(record_dependencies.begin(), record_dependencies.end());
+      sup::di::CheckCreateInstanceResult(
+        object_manager.DeferCreateInstance(symbols[record.type_name], name, dependency_list),
+        symbols[record.type_name], name, true);
+      break;
+    }
+    case ElementKind::kCallFunction:
+    {
+      dependency_list.assign(record_dependencies.begin(), record_dependencies.end());
+      auto result = object_manager.CallGlobalFunction(name, dependency_list);
+      if (result != sup::di::ErrorCode::kSuccess)
+      {
+        throw sup::di::RuntimeException(
+          "sup::di::ExecuteCompiledObjectTree(): calling function with name [" +
+          std::string{image.GetString(record.name)} + "] failed with error [" +
+          sup::di::ErrorString(result) + "]");
+      }
+      break;
+    }
+    case ElementKind::kStringInstance:
+      registered = object_manager.RegisterInstance(
+        std::string{image.GetString(static_cast<std::uint32_t>(record.value))}, name);
+      break;
+    case ElementKind::kIntegerInstance:
+      registered = object_manager.RegisterInstance(
+        static_cast<int>(static_cast<std::int64_t>(record.value)), name);
+      break;
+    case ElementKind::kDoubleInstance:
+    {
+      double value = 0.0;
+      std::memcpy(&value, &record.value, sizeof(value));
+      registered = object_manager.RegisterInstance(value, name);
+      break;
+    }
+    }
+    if (!registered)
+    {
+      throw sup::di::RuntimeException(
+        "sup::di::ExecuteCompiledObjectTree(): creating literal instance with name [" +
+        std::string{image.GetString(record.name)} + "] failed");
+    }
+  }
+}
+
+std::uint64_t ParseLiteralValue(const std::string& tag, const std::string& value_rep)
+{
+  try
+  {
+    if (tag == sup::di::constants::INTEGER_INSTANCE_TAG)
+    {
+      // Same conversion as IntegerInstanceElement
+      std::int64_t value = std::stoi(value_rep, nullptr, 0);
+      return static_cast<std::uint64_t>(value);
+    }
+    double value = std::stod(value_rep);
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+  catch (const std::logic_error&)
+  {
+    std::string error_message = "sup::di::CompileObjectTree(): invalid value [" + value_rep +
+      "] of [" + tag + "] element";
+    throw sup::di::ParseException(error_message);
+  }
+}
+
+std::size_t AlignedSize(std::size_t size)
+{
+  return (size + alignof(std::uint64_t) - 1) & ~(alignof(std::uint64_t) - 1);
+}
+}  // unnamed namespace
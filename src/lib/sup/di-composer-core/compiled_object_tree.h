@@ -0,0 +1,187 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_COMPILED_OBJECT_TREE_H_
+#define SUP_DI_COMPOSER_COMPILED_OBJECT_TREE_H_
+
+#include "composer_options.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sup
+{
+namespace xml
+{
+class TreeData;
+}  // namespace xml
+
+namespace di
+{
+
+/**
+ * @brief Binary image of a validated ObjectComposer tree, which can be executed without parsing or
+ * validating XML.
+ *
+ * @details The image consists of the following sections, in this order:
+ *   ImageHeader;
+ *   StringEntry[n_strings]: offset and size of each unique string in the string data;
+ *   ElementRecord[n_records]: one fixed-size record per element, in document order;
+ *   std::uint32_t[n_dependencies]: string indices of all dependency lists;
+ *   char[string_data_size]: string data, without terminating null characters.
+ *
+ * Integers are stored in native byte order, so images can only be executed on machines with the
+ * byte order of the machine that compiled them. Images with another magic or version are rejected.
+ */
+namespace compiled
+{
+constexpr char kMagic[8] = { 'S', 'U', 'P', 'D', 'I', 'I', 'M', 'G' };
+constexpr std::uint32_t kFormatVersion = 1;
+
+struct ImageHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t n_strings;
+  std::uint32_t n_records;
+  std::uint32_t n_dependencies;
+  std::uint64_t string_data_size;
+};
+
+struct StringEntry
+{
+  std::uint32_t offset;
+  std::uint32_t size;
+};
+
+enum class ElementKind : std::uint32_t
+{
+  kLoadLibrary = 0,
+  kInstance,
+  kCallFunction,
+  kStringInstance,
+  kIntegerInstance,
+  kDoubleInstance
+};
+
+// Bits of the value of a LoadLibrary record. Images without these bits load libraries with the
+// default options.
+constexpr std::uint64_t kLazyBinding = 1 << 0;
+constexpr std::uint64_t kGlobalSymbols = 1 << 1;
+constexpr std::uint64_t kNoDelete = 1 << 2;
+constexpr std::uint64_t kLibraryLoadFlags = kLazyBinding | kGlobalSymbols | kNoDelete;
+
+/**
+ * @brief Fixed-size record of a single element. All names are indices in the string table.
+ *
+ * @details The name is the library name, instance name or function name, depending on the kind.
+ * The value holds the string index of a string literal, the value of an integer literal, the bit
+ * pattern of a double literal or the library load flags of a library.
+ */
+struct ElementRecord
+{
+  ElementKind kind;
+  std::uint32_t name;
+  std::uint32_t type_name;
+  std::uint32_t first_dependency;
+  std::uint32_t n_dependencies;
+  std::uint32_t padding;
+  std::uint64_t value;
+};
+}  // namespace compiled
+
+/**
+ * @brief Compile an ObjectComposer tree into a binary image.
+ *
+ * @details The tree is validated with the same rules as ObjectComposerElement. Names are not
+ * interned and no elements are executed.
+ *
+ * @throws ParseException when the tree is not a valid ObjectComposer tree.
+ */
+std::string CompileObjectTree(const sup::xml::TreeData& composer_tree);
+
+/**
+ * @brief Parse an ObjectComposer XML file and write its binary image to another file.
+ *
+ * @throws ParseException when the XML file is not a valid ObjectComposer tree.
+ * @throws RuntimeException when the image could not be written.
+ */
+void CompileObjectTreeFile(const std::string& xml_filename, const std::string& image_filename);
+
+/**
+ * @brief Check whether the file starts with the magic of a binary image.
+ */
+bool IsCompiledObjectTreeFile(const std::string& filename);
+
+/**
+ * @brief Execute the elements of a binary image in memory, in document order.
+ *
+ * @details The image's strings are interned once and consecutive instance creations are handed to
+ * the global ObjectManager as a single batch. ComposerOptions::n_threads is ignored: images are
+ * always executed sequentially.
+ *
+ * @throws ParseException when the image is malformed.
+ * @throws RuntimeException when executing one of the elements failed.
+ */
+void ExecuteCompiledObjectTree(const void* image, std::size_t size,
+                               const ComposerOptions& options = {});
+
+/**
+ * @brief Map a binary image file into memory and execute it.
+ *
+ * @throws ParseException when the file could not be mapped or is malformed.
+ * @throws RuntimeException when executing one of the elements failed.
+ */
+void ExecuteCompiledObjectTreeFromFile(const std::string& filename,
+                                       const ComposerOptions& options = {});
+
+/**
+ * @brief Execute a binary image file if it can be mapped and is a valid image.
+ *
+ * @details Unlike ExecuteCompiledObjectTreeFromFile, a missing or malformed image, including one
+ * with another format version, is not an error: no element is executed and false is returned.
+ *
+ * @throws RuntimeException when executing one of the elements failed.
+ */
+bool TryExecuteCompiledObjectTreeFromFile(const std::string& filename,
+                                          const ComposerOptions& options = {});
+
+/**
+ * @brief Execute a file that holds a binary image, immediately followed by the source it was
+ * compiled from, if it is valid and its source is equal to the given one.
+ *
+ * @details This allows caching images under a short key of their source: an image whose stored
+ * source differs from the given one is treated like a malformed image. No element is executed
+ * and false is returned.
+ *
+ * @throws RuntimeException when executing one of the elements failed.
+ */
+bool TryExecuteCompiledObjectTreeFromFile(const std::string& filename, std::string_view source,
+                                          const ComposerOptions& options = {});
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_COMPILED_OBJECT_TREE_H_
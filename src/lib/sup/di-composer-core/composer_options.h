@@ -0,0 +1,67 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_COMPOSER_OPTIONS_H_
+#define SUP_DI_COMPOSER_COMPOSER_OPTIONS_H_
+
+#include <cstddef>
+#include <string>
+
+namespace sup
+{
+namespace di
+{
+class TraceRecorder;
+
+/**
+ * @brief Options that control how an object composer tree is executed.
+ *
+ * @details With n_threads larger than one, independent elements are executed concurrently.
+ * Elements that use the same instance names keep their document order and LoadLibrary elements
+ * act as barriers.
+ */
+struct ComposerOptions
+{
+  std::size_t n_threads = 1;
+  // Optional recorder for phase and per-element trace events. It is ignored when the composer was
+  // built without instrumentation (COA_INSTRUMENTATION=OFF).
+  TraceRecorder* trace_recorder = nullptr;
+  // Defer the creation of instances until they are first used (see
+  // ObjectManager::DeferCreateInstance)
+  bool lazy_instances = false;
+  // Optional directory for binary images of parsed and validated files, keyed by their content (see
+  // ExecuteObjectTreeFromFile). It is ignored when n_threads is larger than one.
+  std::string cache_directory = {};
+  // Parse and execute one top-level element at a time (see StreamObjectTreeFromFile). Streaming
+  // ignores n_threads and cache_directory.
+  bool streaming = false;
+  // Read the libraries of LoadLibrary elements into the page cache on background threads before
+  // executing the elements (see LibraryPrefetcher). This is off by default, since it starts
+  // background threads, and streaming does not prefetch.
+  bool prefetch_libraries = false;
+};
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_COMPOSER_OPTIONS_H_
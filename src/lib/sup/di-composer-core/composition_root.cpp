@@ -22,13 +22,37 @@
 
 #include "composition_root.h"
 
+#include "compiled_object_tree.h"
+#include "instrumentation.h"
 #include "object_composer_element.h"
+#include "streaming_object_tree.h"
 
 #include <sup/xml/tree_data_parser.h>
 
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
 namespace
 {
-void ExecuteComposerTree(const sup::xml::TreeData& composer_tree);
+void ExecuteComposerTree(const sup::xml::TreeData& composer_tree,
+                         const sup::di::ComposerOptions& options);
+
+bool ExecuteCachedObjectTreeFromFile(const std::string& filename,
+                                     const sup::di::ComposerOptions& options);
+
+bool ReadFile(const std::string& filename, std::string& content);
+
+std::string CacheFileName(const std::string& cache_directory, const std::string& content);
+
+void StoreCompiledObjectTree(const sup::xml::TreeData& composer_tree, const std::string& content,
+                             const std::string& cache_filename);
 }  // unnamed namespace
 
 namespace sup
@@ -36,16 +60,41 @@ namespace sup
 namespace di
 {
 
-void ExecuteObjectTreeFromFile(const std::string& filename)
+void ExecuteObjectTreeFromFile(const std::string& filename, const ComposerOptions& options)
 {
-  auto composer_tree = sup::xml::TreeDataFromFile(filename);
-  ExecuteComposerTree(*composer_tree);
+  if (options.streaming)
+  {
+    StreamObjectTreeFromFile(filename, options);
+    return;
+  }
+  if (!options.cache_directory.empty() && options.n_threads <= 1 &&
+      ExecuteCachedObjectTreeFromFile(filename, options))
+  {
+    return;
+  }
+  std::unique_ptr<sup::xml::TreeData> composer_tree;
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "parse", "phase");
+    SUP_DI_TRACE_ARGUMENT(span, "file", filename);
+    composer_tree = sup::xml::TreeDataFromFile(filename);
+  }
+  ExecuteComposerTree(*composer_tree, options);
 }
 
-void ExecuteObjectTreeFromString(const std::string& representation)
+void ExecuteObjectTreeFromString(const std::string& representation,
+                                 const ComposerOptions& options)
 {
-  auto composer_tree = sup::xml::TreeDataFromString(representation);
-  ExecuteComposerTree(*composer_tree);
+  if (options.streaming)
+  {
+    StreamObjectTreeFromString(representation, options);
+    return;
+  }
+  std::unique_ptr<sup::xml::TreeData> composer_tree;
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "parse", "phase");
+    composer_tree = sup::xml::TreeDataFromString(representation);
+  }
+  ExecuteComposerTree(*composer_tree, options);
 }
 
 }  // namespace di
@@ -54,9 +103,98 @@ void ExecuteObjectTreeFromString(const std::string& representation)
 
 namespace
 {
-void ExecuteComposerTree(const sup::xml::TreeData& composer_tree)
+void ExecuteComposerTree(const sup::xml::TreeData& composer_tree,
+                         const sup::di::ComposerOptions& options)
 {
-  sup::di::ObjectComposerElement object_composer{composer_tree};
+  sup::di::ObjectComposerElement object_composer{composer_tree, options};
   object_composer.Execute();
 }
+
+// Returns false when the file could not be read, so the uncached path reports the error
+bool ExecuteCachedObjectTreeFromFile(const std::string& filename,
+                                     const sup::di::ComposerOptions& options)
+{
+  std::string content;
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "read", "phase");
+    SUP_DI_TRACE_ARGUMENT(span, "file", filename);
+    if (!ReadFile(filename, content))
+    {
+      return false;
+    }
+  }
+  auto cache_filename = CacheFileName(options.cache_directory, content);
+  if (sup::di::TryExecuteCompiledObjectTreeFromFile(cache_filename, content, options))
+  {
+    return true;
+  }
+  std::unique_ptr<sup::xml::TreeData> composer_tree;
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "parse", "phase");
+    SUP_DI_TRACE_ARGUMENT(span, "file", filename);
+    composer_tree = sup::xml::TreeDataFromString(content);
+  }
+  {
+    SUP_DI_TRACE_SPAN(span, options.trace_recorder, "compile", "phase");
+    SUP_DI_TRACE_ARGUMENT(span, "file", cache_filename);
+    StoreCompiledObjectTree(*composer_tree, content, cache_filename);
+  }
+  ExecuteComposerTree(*composer_tree, options);
+  return true;
+}
+
+bool ReadFile(const std::string& filename, std::string& content)
+{
+  std::ifstream file{filename, std::ios::binary};
+  if (!file)
+  {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+  return !file.bad();
+}
+
+// 64-bit FNV-1a hash of the content, combined with its size in the name. The name only locates the
+// image: the content stored with it decides whether it can be used.
+std::string CacheFileName(const std::string& cache_directory, const std::string& content)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  for (auto c : content)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  std::ostringstream oss;
+  oss << std::hex << hash << "-" << std::dec << content.size() << ".img";
+  return (std::filesystem::path{cache_directory} / oss.str()).string();
+}
+
+// Compiling also validates the tree, so invalid trees are reported before anything is written.
+// The image is followed by the content it was compiled from, so files with colliding names are
+// never executed for other content. It is written to a temporary file first, so concurrent
+// processes never map a partially written image.
+void StoreCompiledObjectTree(const sup::xml::TreeData& composer_tree, const std::string& content,
+                             const std::string& cache_filename)
+{
+  auto image = sup::di::CompileObjectTree(composer_tree);
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path{cache_filename}.parent_path(), error);
+  auto temporary_filename = cache_filename + "." + std::to_string(::getpid()) + ".tmp";
+  {
+    std::ofstream image_file{temporary_filename, std::ios::binary};
+    image_file.write(image.data(), static_cast<std::streamsize>(image.size()));
+    image_file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!image_file)
+    {
+      image_file.close();
+      std::remove(temporary_filename.c_str());
+      return;
+    }
+  }
+  std::filesystem::rename(temporary_filename, cache_filename, error);
+  if (error)
+  {
+    std::remove(temporary_filename.c_str());
+  }
+}
 }  // unnamed namespace
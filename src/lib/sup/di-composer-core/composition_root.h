@@ -23,6 +23,8 @@
 #ifndef SUP_DI_COMPOSER_COMPOSITION_ROOT_H_
 #define SUP_DI_COMPOSER_COMPOSITION_ROOT_H_
 
+#include "composer_options.h"
+
 #include <string>
 
 namespace sup
@@ -30,9 +32,21 @@ namespace sup
 namespace di
 {
 
-void ExecuteObjectTreeFromFile(const std::string& filename);
-
-void ExecuteObjectTreeFromString(const std::string& representation);
+/**
+ * @brief Parse, validate and execute an ObjectComposer XML file.
+ *
+ * @details When ComposerOptions::cache_directory is set and n_threads is one, the file's content
+ * is hashed and a binary image with that hash in its name is looked up in the cache directory. If
+ * the image exists, is valid and the content stored with it is equal to the file's content, it is
+ * executed without parsing or validating the file. Otherwise the file is parsed as usual and its
+ * image and content are written to the cache directory before executing it.
+ * Failures to write the image are ignored. With ComposerOptions::streaming, the file is parsed and
+ * executed one element at a time instead (see StreamObjectTreeFromFile).
+ */
+void ExecuteObjectTreeFromFile(const std::string& filename, const ComposerOptions& options = {});
+
+void ExecuteObjectTreeFromString(const std::string& representation,
+                                 const ComposerOptions& options = {});
 
 }  // namespace di
 
@@ -49,6 +49,17 @@ const std::string VALUE_TAG = "Value";
 const std::string CALL_FUNCTION_TAG = "CallFunction";
 const std::string FUNCTION_NAME_TAG = "FunctionName";
 
+// LoadLibrary attributes and their values
+const std::string BINDING_ATTRIBUTE = "binding";
+const std::string BINDING_NOW = "now";
+const std::string BINDING_LAZY = "lazy";
+const std::string SCOPE_ATTRIBUTE = "scope";
+const std::string SCOPE_LOCAL = "local";
+const std::string SCOPE_GLOBAL = "global";
+const std::string NODELETE_ATTRIBUTE = "nodelete";
+const std::string TRUE_VALUE = "true";
+const std::string FALSE_VALUE = "false";
+
 }  // namespace constants
 
 }  // namespace di
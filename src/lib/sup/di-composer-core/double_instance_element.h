@@ -40,8 +40,10 @@ public:
 
   void Execute() override;
 
+  ElementAccess GetAccess() const override;
+
 private:
-  std::string m_instance_name;
+  Symbol m_instance_name;
   double m_value;
 };
 
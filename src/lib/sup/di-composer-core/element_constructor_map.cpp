@@ -29,16 +29,29 @@
 #include "integer_instance_element.h"
 #include "library_element.h"
 #include "string_instance_element.h"
+
 #include <memory>
+#include <type_traits>
 
 namespace
 {
 template <typename Elem>
 struct TElementConstructor
 {
-  static std::unique_ptr<sup::di::IComposerElement> Create(const sup::xml::TreeData& tree)
+  static std::unique_ptr<sup::di::IComposerElement> Create(
+    const sup::xml::TreeData& tree, const sup::di::ComposerOptions& options)
   {
-    return std::make_unique<Elem>(tree);
+    // Only elements whose behavior depends on the options take them
+    if constexpr (std::is_constructible<Elem, const sup::xml::TreeData&,
+                                        const sup::di::ComposerOptions&>::value)
+    {
+      return std::make_unique<Elem>(tree, options);
+    }
+    else
+    {
+      (void)options;
+      return std::make_unique<Elem>(tree);
+    }
   }
 };
 }  // unnamed namespace
@@ -23,6 +23,7 @@
 #ifndef SUP_DI_COMPOSER_ELEMENT_CONSTRUCTOR_MAP_H_
 #define SUP_DI_COMPOSER_ELEMENT_CONSTRUCTOR_MAP_H_
 
+#include "composer_options.h"
 #include "i_composer_element.h"
 
 #include <sup/xml/tree_data.h>
@@ -36,8 +37,8 @@ namespace sup
 namespace di
 {
 
-using ElementConstructor =
-  std::function<std::unique_ptr<IComposerElement>(const sup::xml::TreeData&)>;
+using ElementConstructor = std::function<std::unique_ptr<IComposerElement>(
+  const sup::xml::TreeData&, const ComposerOptions&)>;
 
 const std::map<std::string, ElementConstructor>& ElementConstructorMap();
 
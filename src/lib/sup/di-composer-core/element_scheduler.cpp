@@ -0,0 +1,246 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "element_scheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+using ElementPointers = std::vector<sup::di::IComposerElement*>;
+
+void ExecuteGraph(const ElementPointers& elements,
+                  const std::vector<std::vector<std::size_t>>& graph, std::size_t n_threads);
+
+class GraphExecutor
+{
+public:
+  GraphExecutor(const ElementPointers& elements,
+                const std::vector<std::vector<std::size_t>>& graph);
+  ~GraphExecutor();
+
+  GraphExecutor(const GraphExecutor& other) = delete;
+  GraphExecutor& operator=(const GraphExecutor& other) = delete;
+
+  void Work();
+  void RethrowFailure() const;
+
+private:
+  const ElementPointers& m_elements;
+  std::vector<std::vector<std::size_t>> m_successors;
+  std::vector<std::size_t> m_n_predecessors;
+  std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t>> m_ready;
+  std::size_t m_n_running;
+  std::size_t m_failed_idx;
+  std::exception_ptr m_failure;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+};
+}  // unnamed namespace
+
+namespace sup
+{
+namespace di
+{
+
+std::vector<std::vector<std::size_t>> BuildElementGraph(const std::vector<ElementAccess>& accesses)
+{
+  std::vector<std::vector<std::size_t>> result(accesses.size());
+  std::unordered_map<Symbol, std::size_t> last_writer;
+  std::unordered_map<Symbol, std::vector<std::size_t>> readers;
+  for (std::size_t idx = 0; idx < accesses.size(); ++idx)
+  {
+    auto& predecessors = result[idx];
+    for (const auto& name : accesses[idx].reads)
+    {
+      auto writer_it = last_writer.find(name);
+      if (writer_it != last_writer.end())
+      {
+        predecessors.push_back(writer_it->second);
+      }
+      readers[name].push_back(idx);
+    }
+    for (const auto& name : accesses[idx].writes)
+    {
+      auto writer_it = last_writer.find(name);
+      if (writer_it != last_writer.end())
+      {
+        predecessors.push_back(writer_it->second);
+      }
+      auto& name_readers = readers[name];
+      for (auto reader_idx : name_readers)
+      {
+        if (reader_idx != idx)
+        {
+          predecessors.push_back(reader_idx);
+        }
+      }
+      name_readers.clear();
+      last_writer[name] = idx;
+    }
+    std::sort(predecessors.begin(), predecessors.end());
+    predecessors.erase(std::unique(predecessors.begin(), predecessors.end()), predecessors.end());
+  }
+  return result;
+}
+
+void ExecuteElementsConcurrently(const std::vector<std::unique_ptr<IComposerElement>>& elements,
+                                 std::size_t n_threads)
+{
+  ElementPointers segment;
+  std::vector<ElementAccess> accesses;
+  for (const auto& element : elements)
+  {
+    auto access = element->GetAccess();
+    if (!access.barrier)
+    {
+      segment.push_back(element.get());
+      accesses.push_back(std::move(access));
+      continue;
+    }
+    ExecuteGraph(segment, BuildElementGraph(accesses), n_threads);
+    segment.clear();
+    accesses.clear();
+    element->Execute();
+  }
+  ExecuteGraph(segment, BuildElementGraph(accesses), n_threads);
+}
+
+}  // namespace di
+
+}  // namespace sup
+
+namespace
+{
+void ExecuteGraph(const ElementPointers& elements,
+                  const std::vector<std::vector<std::size_t>>& graph, std::size_t n_threads)
+{
+  if (elements.empty())
+  {
+    return;
+  }
+  GraphExecutor executor{elements, graph};
+  std::vector<std::thread> threads;
+  auto n_workers = std::min(n_threads, elements.size());
+  for (std::size_t idx = 1; idx < n_workers; ++idx)
+  {
+    threads.emplace_back(&GraphExecutor::Work, &executor);
+  }
+  executor.Work();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  executor.RethrowFailure();
+}
+
+GraphExecutor::GraphExecutor(const ElementPointers& elements,
+                             const std::vector<std::vector<std::size_t>>& graph)
+  : m_elements{elements}
+  , m_successors(elements.size())
+  , m_n_predecessors(elements.size(), 0)
+  , m_ready{}
+  , m_n_running{0}
+  , m_failed_idx{elements.size()}
+  , m_failure{}
+  , m_mutex{}
+  , m_cond{}
+{
+  for (std::size_t idx = 0; idx < graph.size(); ++idx)
+  {
+    m_n_predecessors[idx] = graph[idx].size();
+    for (auto predecessor : graph[idx])
+    {
+      m_successors[predecessor].push_back(idx);
+    }
+    if (graph[idx].empty())
+    {
+      m_ready.push(idx);
+    }
+  }
+}
+
+GraphExecutor::~GraphExecutor() = default;
+
+void GraphExecutor::Work()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true)
+  {
+    // Since the graph is acyclic, no ready and no running elements means all were executed
+    m_cond.wait(lock, [this]() { return m_failure || !m_ready.empty() || m_n_running == 0; });
+    if (m_failure || m_ready.empty())
+    {
+      return;
+    }
+    auto idx = m_ready.top();
+    m_ready.pop();
+    ++m_n_running;
+    lock.unlock();
+    std::exception_ptr failure;
+    try
+    {
+      m_elements[idx]->Execute();
+    }
+    catch (...)
+    {
+      failure = std::current_exception();
+    }
+    lock.lock();
+    --m_n_running;
+    if (failure)
+    {
+      if (idx < m_failed_idx)
+      {
+        m_failed_idx = idx;
+        m_failure = failure;
+      }
+    }
+    else
+    {
+      for (auto successor : m_successors[idx])
+      {
+        if (--m_n_predecessors[successor] == 0)
+        {
+          m_ready.push(successor);
+        }
+      }
+    }
+    m_cond.notify_all();
+  }
+}
+
+void GraphExecutor::RethrowFailure() const
+{
+  if (m_failure)
+  {
+    std::rethrow_exception(m_failure);
+  }
+}
+}  // unnamed namespace
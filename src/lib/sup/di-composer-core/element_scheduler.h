@@ -0,0 +1,65 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_ELEMENT_SCHEDULER_H_
+#define SUP_DI_COMPOSER_ELEMENT_SCHEDULER_H_
+
+#include "i_composer_element.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+
+/**
+ * @brief Build the dependency graph of a sequence of non-barrier element accesses.
+ *
+ * @details An element depends on the last preceding element that writes one of the names it reads
+ * or writes, and on all elements that read a name it writes since that name was last written.
+ *
+ * @return For each element, the sorted indices of the elements it depends on.
+ */
+std::vector<std::vector<std::size_t>> BuildElementGraph(const std::vector<ElementAccess>& accesses);
+
+/**
+ * @brief Execute the elements on a pool of threads, respecting their dependency graph.
+ *
+ * @details Consecutive non-barrier elements are executed concurrently, while barrier elements are
+ * executed on their own after all preceding elements finished. The access of an element is only
+ * queried after all preceding barriers were executed, since these can register new factory
+ * functions.
+ *
+ * @throws The exception of the first failing element in document order. No new elements are
+ * started after a failure.
+ */
+void ExecuteElementsConcurrently(const std::vector<std::unique_ptr<IComposerElement>>& elements,
+                                 std::size_t n_threads);
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_ELEMENT_SCHEDULER_H_
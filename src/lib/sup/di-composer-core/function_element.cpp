@@ -36,7 +36,7 @@ namespace di
 {
 
 FunctionElement::FunctionElement(const sup::xml::TreeData& function_tree)
-  : m_function_name{}
+  : m_function_name{kInvalidSymbol}
   , m_dependencies{}
 {
   ValidateFunctionTree(function_tree);
@@ -63,11 +63,21 @@ void FunctionElement::Execute()
   if ( result != ErrorCode::kSuccess)
   {
     std::string error_message = "FunctionElement::Execute(): calling function with name [" +
-      m_function_name + "] failed with error [" + ErrorString(result) + "]";
+      utils::GetSymbolName(m_function_name) + "] failed with error [" + ErrorString(result) + "]";
     throw sup::di::RuntimeException(error_message);
   }
 }
 
+ElementAccess FunctionElement::GetAccess() const
+{
+  // Global functions may modify their dependencies and, without dependencies, global state
+  if (m_dependencies.empty())
+  {
+    return {};
+  }
+  return ElementAccess{false, {}, m_dependencies};
+}
+
 void ValidateFunctionTree(const sup::xml::TreeData& function_tree)
 {
   sup::xml::ValidateNoContent(function_tree);
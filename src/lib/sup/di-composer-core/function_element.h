@@ -42,9 +42,11 @@ public:
 
   void Execute() override;
 
+  ElementAccess GetAccess() const override;
+
 private:
-  std::string m_function_name;
-  std::vector<std::string> m_dependencies;
+  Symbol m_function_name;
+  std::vector<Symbol> m_dependencies;
 };
 
 void ValidateFunctionTree(const sup::xml::TreeData& function_tree);
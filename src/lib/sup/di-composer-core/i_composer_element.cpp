@@ -33,6 +33,16 @@ namespace di
 
 IComposerElement::~IComposerElement() = default;
 
+ElementAccess IComposerElement::GetAccess() const
+{
+  return {};
+}
+
+bool IComposerElement::GetCreateInstanceRequest(CreateInstanceRequest&) const
+{
+  return false;
+}
+
 void ValidateLiteralInstanceTree(const sup::xml::TreeData& instance_tree)
 {
   sup::xml::ValidateNoContent(instance_tree);
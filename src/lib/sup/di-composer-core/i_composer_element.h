@@ -23,14 +23,31 @@
 #ifndef SUP_DI_COMPOSER_I_COMPOSER_ELEMENT_H_
 #define SUP_DI_COMPOSER_I_COMPOSER_ELEMENT_H_
 
+#include <sup/di/symbol_table.h>
+
 #include <sup/xml/tree_data.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace sup
 {
 namespace di
 {
+struct CreateInstanceRequest;
+
+/**
+ * @brief Interned instance names that are read or written by executing a composer element.
+ *
+ * @details A barrier element can not be executed concurrently with any other element.
+ */
+struct ElementAccess
+{
+  bool barrier = true;
+  std::vector<Symbol> reads = {};
+  std::vector<Symbol> writes = {};
+};
 
 class IComposerElement
 {
@@ -38,6 +55,19 @@ public:
   virtual ~IComposerElement();
 
   virtual void Execute() = 0;
+
+  /**
+   * @brief Return the instance names this element accesses during execution. The default
+   * implementation returns a barrier.
+   */
+  virtual ElementAccess GetAccess() const;
+
+  /**
+   * @brief Get the request for the instance this element creates, if executing it is equivalent to
+   * a single ObjectManager::CreateInstance call. This allows consecutive elements to be executed as
+   * one batch. The default implementation returns false.
+   */
+  virtual bool GetCreateInstanceRequest(CreateInstanceRequest& request) const;
 };
 
 std::unique_ptr<IComposerElement> CreateComposerElement(const sup::xml::TreeData& tree);
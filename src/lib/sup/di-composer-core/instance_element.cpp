@@ -35,10 +35,12 @@ namespace sup
 namespace di
 {
 
-InstanceElement::InstanceElement(const sup::xml::TreeData& instance_tree)
-  : m_type_name{}
-  , m_instance_name{}
+InstanceElement::InstanceElement(const sup::xml::TreeData& instance_tree,
+                                 const ComposerOptions& options)
+  : m_type_name{kInvalidSymbol}
+  , m_instance_name{kInvalidSymbol}
   , m_dependencies{}
+  , m_lazy{options.lazy_instances}
 {
   ValidateInstanceTree(instance_tree);
   for (const auto& child : instance_tree.Children())
@@ -64,14 +66,39 @@ InstanceElement::~InstanceElement() = default;
 void InstanceElement::Execute()
 {
   auto& global_object_manager = GlobalObjectManager();
-  auto result = global_object_manager.CreateInstance(m_type_name, m_instance_name, m_dependencies);
-  if ( result != ErrorCode::kSuccess)
+  auto result =
+    m_lazy ? global_object_manager.DeferCreateInstance(m_type_name, m_instance_name, m_dependencies)
+           : global_object_manager.CreateInstance(m_type_name, m_instance_name, m_dependencies);
+  CheckCreateInstanceResult(result, m_type_name, m_instance_name, m_lazy);
+}
+
+ElementAccess InstanceElement::GetAccess() const
+{
+  // Dependencies whose ownership is transferred are removed, which counts as writing them
+  std::vector<bool> transfer_ownership;
+  auto& global_object_manager = GlobalObjectManager();
+  if (global_object_manager.GetFactoryFunctionOwnership(m_type_name, transfer_ownership)
+        != ErrorCode::kSuccess || transfer_ownership.size() != m_dependencies.size())
   {
-    std::string error_message = "InstanceElement::Execute(): creating instance with type [" +
-      m_type_name + "] and name [" + m_instance_name + "] failed with error [" +
-      ErrorString(result) + "]";
-    throw sup::di::RuntimeException(error_message);
+    return {};
+  }
+  ElementAccess result{false, {}, {m_instance_name}};
+  for (std::size_t idx = 0; idx < m_dependencies.size(); ++idx)
+  {
+    auto& names = transfer_ownership[idx] ? result.writes : result.reads;
+    names.push_back(m_dependencies[idx]);
+  }
+  return result;
+}
+
+bool InstanceElement::GetCreateInstanceRequest(CreateInstanceRequest& request) const
+{
+  if (m_lazy)
+  {
+    return false;
   }
+  request = CreateInstanceRequest{m_type_name, m_instance_name, m_dependencies};
+  return true;
 }
 
 void ValidateInstanceTree(const sup::xml::TreeData& instance_tree)
@@ -89,6 +116,19 @@ void ValidateInstanceTree(const sup::xml::TreeData& instance_tree)
   }
 }
 
+void CheckCreateInstanceResult(ErrorCode result, Symbol type_name, Symbol instance_name,
+                               bool lazy)
+{
+  if (result != ErrorCode::kSuccess)
+  {
+    std::string error_message = "InstanceElement::Execute(): " +
+      std::string{lazy ? "deferring" : "creating"} + " instance with type [" +
+      utils::GetSymbolName(type_name) + "] and name [" + utils::GetSymbolName(instance_name) +
+      "] failed with error [" + ErrorString(result) + "]";
+    throw sup::di::RuntimeException(error_message);
+  }
+}
+
 }  // namespace di
 
 }  // namespace sup
@@ -23,8 +23,11 @@
 #ifndef SUP_DI_COMPOSER_INSTANCE_ELEMENT_H_
 #define SUP_DI_COMPOSER_INSTANCE_ELEMENT_H_
 
+#include "composer_options.h"
 #include "i_composer_element.h"
 
+#include <sup/di/error_codes.h>
+
 #include <sup/xml/tree_data.h>
 
 #include <vector>
@@ -37,19 +40,34 @@ namespace di
 class InstanceElement : public IComposerElement
 {
 public:
-  InstanceElement(const sup::xml::TreeData& instance_tree);
+  /**
+   * @brief Construct the element. With ComposerOptions::lazy_instances, executing the element only
+   * defers the creation of the instance until it is first used.
+   */
+  InstanceElement(const sup::xml::TreeData& instance_tree, const ComposerOptions& options = {});
   ~InstanceElement();
 
   void Execute() override;
 
+  ElementAccess GetAccess() const override;
+
+  bool GetCreateInstanceRequest(CreateInstanceRequest& request) const override;
+
 private:
-  std::string m_type_name;
-  std::string m_instance_name;
-  std::vector<std::string> m_dependencies;
+  Symbol m_type_name;
+  Symbol m_instance_name;
+  std::vector<Symbol> m_dependencies;
+  bool m_lazy;
 };
 
 void ValidateInstanceTree(const sup::xml::TreeData& instance_tree);
 
+/**
+ * @brief Throw a RuntimeException when creating or deferring an instance failed.
+ */
+void CheckCreateInstanceResult(ErrorCode result, Symbol type_name, Symbol instance_name,
+                               bool lazy = false);
+
 }  // namespace di
 
 }  // namespace sup
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "instrumentation.h"
+
+#include "constants.h"
+
+#include <algorithm>
+
+namespace sup
+{
+namespace di
+{
+
+ElementDescription DescribeElement(const sup::xml::TreeData& element_tree)
+{
+  ElementDescription description{element_tree.GetNodeName(), {}};
+  description.args.emplace_back("tag", element_tree.GetNodeName());
+  if (element_tree.GetNodeName() == constants::LOAD_LIBRARY_TAG)
+  {
+    description.args.emplace_back("library", element_tree.GetContent());
+  }
+  for (const auto& child : element_tree.Children())
+  {
+    auto nodename = child.GetNodeName();
+    if (nodename == constants::TYPE_NAME_TAG)
+    {
+      description.args.emplace_back("type", child.GetContent());
+    }
+    else if (nodename == constants::FUNCTION_NAME_TAG)
+    {
+      description.args.emplace_back("function", child.GetContent());
+    }
+    else if (nodename == constants::INSTANCE_NAME_TAG)
+    {
+      description.args.emplace_back("instance", child.GetContent());
+    }
+  }
+  // Prefer the instance name, since it identifies the element uniquely
+  auto it = std::find_if(description.args.begin(), description.args.end(),
+                         [](const auto& arg) { return arg.first == "instance"; });
+  if (it != description.args.end())
+  {
+    description.name += " " + it->second;
+  }
+  else if (description.args.size() > 1)
+  {
+    description.name += " " + description.args.back().second;
+  }
+  return description;
+}
+
+InstrumentedElement::InstrumentedElement(std::unique_ptr<IComposerElement> element,
+                                         ElementDescription description,
+                                         TraceRecorder* recorder)
+  : m_element{std::move(element)}
+  , m_description{std::move(description)}
+  , m_recorder{recorder}
+{}
+
+InstrumentedElement::~InstrumentedElement() = default;
+
+void InstrumentedElement::Execute()
+{
+  TraceSpan span{m_recorder, m_description.name, "execute"};
+  for (const auto& [key, value] : m_description.args)
+  {
+    span.AddArgument(key, value);
+  }
+  m_element->Execute();
+}
+
+ElementAccess InstrumentedElement::GetAccess() const
+{
+  return m_element->GetAccess();
+}
+
+}  // namespace di
+
+}  // namespace sup
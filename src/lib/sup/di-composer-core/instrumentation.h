@@ -0,0 +1,94 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_INSTRUMENTATION_H_
+#define SUP_DI_COMPOSER_INSTRUMENTATION_H_
+
+#include "i_composer_element.h"
+
+#include <sup/di/trace_recorder.h>
+
+#include <sup/xml/tree_data.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Instrumentation hooks of the composer. When SUP_DI_INSTRUMENTATION is not defined, the hooks
+ * compile to nothing and their arguments are not evaluated.
+ */
+#ifdef SUP_DI_INSTRUMENTATION
+#define SUP_DI_TRACE_SPAN(span, recorder, name, category) \
+  sup::di::TraceSpan span{recorder, name, category}
+#define SUP_DI_TRACE_ARGUMENT(span, key, value) span.AddArgument(key, value)
+#else
+#define SUP_DI_TRACE_SPAN(span, recorder, name, category) static_cast<void>(0)
+#define SUP_DI_TRACE_ARGUMENT(span, key, value) static_cast<void>(0)
+#endif
+
+namespace sup
+{
+namespace di
+{
+
+/**
+ * @brief Description of a composer element for trace events: its tag and the type, function,
+ * instance or library name found in its tree.
+ */
+struct ElementDescription
+{
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> args;
+};
+
+ElementDescription DescribeElement(const sup::xml::TreeData& element_tree);
+
+/**
+ * @brief Decorator that records a trace event for each execution of the wrapped element.
+ */
+class InstrumentedElement : public IComposerElement
+{
+public:
+  InstrumentedElement(std::unique_ptr<IComposerElement> element, ElementDescription description,
+                      TraceRecorder* recorder);
+  ~InstrumentedElement();
+
+  InstrumentedElement(const InstrumentedElement& other) = delete;
+  InstrumentedElement& operator=(const InstrumentedElement& other) = delete;
+
+  void Execute() override;
+
+  ElementAccess GetAccess() const override;
+
+private:
+  std::unique_ptr<IComposerElement> m_element;
+  ElementDescription m_description;
+  TraceRecorder* m_recorder;
+};
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_INSTRUMENTATION_H_
@@ -36,7 +36,7 @@ namespace di
 {
 
 IntegerInstanceElement::IntegerInstanceElement(const sup::xml::TreeData& string_instance_tree)
-  : m_instance_name{}
+  : m_instance_name{kInvalidSymbol}
   , m_value{}
 {
   ValidateLiteralInstanceTree(string_instance_tree);
@@ -64,11 +64,16 @@ void IntegerInstanceElement::Execute()
   if (!global_object_manager.RegisterInstance(m_value, m_instance_name))
   {
     std::string error_message = "IntegerInstanceElement::Execute(): creating integer with name [" +
-      m_instance_name + " failed";
+      utils::GetSymbolName(m_instance_name) + " failed";
     throw sup::di::RuntimeException(error_message);
   }
 }
 
+ElementAccess IntegerInstanceElement::GetAccess() const
+{
+  return ElementAccess{false, {}, {m_instance_name}};
+}
+
 }  // namespace di
 
 }  // namespace sup
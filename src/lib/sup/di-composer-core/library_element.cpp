@@ -28,8 +28,22 @@
 #include "exceptions.h"
 #include "tree_extract.h"
 
+#include <sup/xml/exceptions.h>
 #include <sup/xml/tree_data_validate.h>
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace
+{
+// Allowed values of each LoadLibrary attribute
+const std::map<std::string, std::vector<std::string>>& LibraryAttributeValues();
+
+bool HasAttributeValue(const sup::xml::TreeData& library_tree, const std::string& name,
+                       const std::string& value);
+}  // unnamed namespace
+
 namespace sup
 {
 namespace di
@@ -37,16 +51,18 @@ namespace di
 
 LibraryElement::LibraryElement(const sup::xml::TreeData& library_tree)
   : m_library_name{}
+  , m_load_options{}
 {
   ValidateLibraryTree(library_tree);
   utils::SetFromTreeNodeContent(m_library_name, library_tree);
+  m_load_options = GetLibraryLoadOptions(library_tree);
 }
 
 LibraryElement::~LibraryElement() = default;
 
 void LibraryElement::Execute()
 {
-  auto error_code = utils::LoadLibrary(m_library_name);
+  auto error_code = utils::LoadLibrary(m_library_name, m_load_options);
   if (error_code != ErrorCode::kSuccess)
   {
     std::string error_message =
@@ -57,10 +73,59 @@ void LibraryElement::Execute()
 
 void ValidateLibraryTree(const sup::xml::TreeData& library_tree)
 {
-  sup::xml::ValidateNoAttributes(library_tree);
+  const auto& attribute_values = LibraryAttributeValues();
+  for (const auto& [name, value] : library_tree.Attributes())
+  {
+    auto it = attribute_values.find(name);
+    if (it == attribute_values.end())
+    {
+      std::string error_message = "sup::di::ValidateLibraryTree(): unknown attribute [" + name +
+                                  "] of [" + constants::LOAD_LIBRARY_TAG + "] element";
+      throw sup::xml::ValidationException(error_message);
+    }
+    if (std::find(it->second.begin(), it->second.end(), value) == it->second.end())
+    {
+      std::string error_message = "sup::di::ValidateLibraryTree(): invalid value [" + value +
+                                  "] of attribute [" + name + "] of [" +
+                                  constants::LOAD_LIBRARY_TAG + "] element";
+      throw sup::xml::ValidationException(error_message);
+    }
+  }
   sup::xml::ValidateNoChildren(library_tree);
 }
 
+utils::LibraryLoadOptions GetLibraryLoadOptions(const sup::xml::TreeData& library_tree)
+{
+  utils::LibraryLoadOptions result;
+  result.lazy_binding =
+    HasAttributeValue(library_tree, constants::BINDING_ATTRIBUTE, constants::BINDING_LAZY);
+  result.global_symbols =
+    HasAttributeValue(library_tree, constants::SCOPE_ATTRIBUTE, constants::SCOPE_GLOBAL);
+  result.no_delete =
+    HasAttributeValue(library_tree, constants::NODELETE_ATTRIBUTE, constants::TRUE_VALUE);
+  return result;
+}
+
 }  // namespace di
 
 }  // namespace sup
+
+namespace
+{
+const std::map<std::string, std::vector<std::string>>& LibraryAttributeValues()
+{
+  using namespace sup::di::constants;
+  static const std::map<std::string, std::vector<std::string>> attribute_values{
+    { BINDING_ATTRIBUTE, { BINDING_NOW, BINDING_LAZY } },
+    { SCOPE_ATTRIBUTE, { SCOPE_LOCAL, SCOPE_GLOBAL } },
+    { NODELETE_ATTRIBUTE, { FALSE_VALUE, TRUE_VALUE } }
+  };
+  return attribute_values;
+}
+
+bool HasAttributeValue(const sup::xml::TreeData& library_tree, const std::string& name,
+                       const std::string& value)
+{
+  return library_tree.HasAttribute(name) && library_tree.GetAttribute(name) == value;
+}
+}  // unnamed namespace
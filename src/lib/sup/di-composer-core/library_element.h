@@ -25,6 +25,8 @@
 
 #include "i_composer_element.h"
 
+#include <sup/di/di_utils.h>
+
 #include <sup/xml/tree_data.h>
 
 namespace sup
@@ -42,10 +44,21 @@ public:
 
 private:
   std::string m_library_name;
+  utils::LibraryLoadOptions m_load_options;
 };
 
+/**
+ * @brief Validate a LoadLibrary tree: it has no children and only the binding ("now" or "lazy"),
+ * scope ("local" or "global") and nodelete ("true" or "false") attributes.
+ */
 void ValidateLibraryTree(const sup::xml::TreeData& library_tree);
 
+/**
+ * @brief Load options from the attributes of a validated LoadLibrary tree. Missing attributes
+ * have their default values: binding="now", scope="local" and nodelete="false".
+ */
+utils::LibraryLoadOptions GetLibraryLoadOptions(const sup::xml::TreeData& library_tree);
+
 }  // namespace di
 
 }  // namespace sup
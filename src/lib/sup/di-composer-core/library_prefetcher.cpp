@@ -0,0 +1,107 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "library_prefetcher.h"
+
+#include "instrumentation.h"
+
+#include <sup/di/di_utils.h>
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+namespace sup
+{
+namespace di
+{
+
+LibraryPrefetcher::LibraryPrefetcher(std::vector<std::string> library_names,
+                                     TraceRecorder* recorder)
+  : m_library_names{std::move(library_names)}
+  , m_recorder{recorder}
+  , m_next{0}
+  , m_prefetched{0}
+  , m_stopped{false}
+  , m_threads{}
+{
+  auto n_threads = std::min(m_library_names.size(), kMaxThreads);
+  m_threads.reserve(n_threads);
+  for (std::size_t idx = 0; idx < n_threads; ++idx)
+  {
+    // Prefetching is only an optimization: when no more threads can be started, the threads that
+    // are already running prefetch all libraries, and without any thread none are prefetched
+    try
+    {
+      m_threads.emplace_back(&LibraryPrefetcher::Run, this);
+    }
+    catch (const std::system_error&)
+    {
+      break;
+    }
+  }
+}
+
+LibraryPrefetcher::~LibraryPrefetcher()
+{
+  m_stopped = true;
+  Wait();
+}
+
+std::size_t LibraryPrefetcher::Wait()
+{
+  for (auto& thread : m_threads)
+  {
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+  return m_prefetched;
+}
+
+void LibraryPrefetcher::Run()
+{
+  while (!m_stopped)
+  {
+    auto idx = m_next++;
+    if (idx >= m_library_names.size())
+    {
+      return;
+    }
+    const auto& library_name = m_library_names[idx];
+    // Loading a library again does not read it
+    if (utils::GetLibraryHandle(library_name) != nullptr)
+    {
+      continue;
+    }
+    SUP_DI_TRACE_SPAN(span, m_recorder, library_name, "prefetch");
+    if (utils::PrefetchLibrary(library_name) == ErrorCode::kSuccess)
+    {
+      ++m_prefetched;
+    }
+  }
+}
+
+}  // namespace di
+
+}  // namespace sup
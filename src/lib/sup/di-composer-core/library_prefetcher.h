@@ -0,0 +1,84 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_LIBRARY_PREFETCHER_H_
+#define SUP_DI_COMPOSER_LIBRARY_PREFETCHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+class TraceRecorder;
+
+/**
+ * @brief Reads the shared libraries of a composer tree into the page cache on background threads
+ * (see utils::PrefetchLibrary).
+ *
+ * @details Libraries are prefetched in document order by at most kMaxThreads threads, while the
+ * elements are executed. LoadLibrary elements do not wait for their library: pages that were not
+ * prefetched yet are read by the dynamic loader as usual. Libraries are only read, never loaded,
+ * so prefetching has no effect on the order in which they register their types and functions.
+ * Libraries that were already loaded with utils::LoadLibrary are skipped.
+ * When threads can not be started, e.g. because of resource limits, the prefetcher continues with
+ * the threads it could start, or prefetches nothing if there are none, instead of failing.
+ * The destructor skips the libraries that were not started yet and waits for the others.
+ */
+class LibraryPrefetcher
+{
+public:
+  static constexpr std::size_t kMaxThreads = 4;
+
+  LibraryPrefetcher(std::vector<std::string> library_names, TraceRecorder* recorder = nullptr);
+  ~LibraryPrefetcher();
+
+  LibraryPrefetcher(const LibraryPrefetcher& other) = delete;
+  LibraryPrefetcher& operator=(const LibraryPrefetcher& other) = delete;
+
+  /**
+   * @brief Wait until all libraries were prefetched.
+   *
+   * @return Number of libraries that were found and read.
+   */
+  std::size_t Wait();
+
+private:
+  void Run();
+
+  std::vector<std::string> m_library_names;
+  TraceRecorder* m_recorder;
+  std::atomic<std::size_t> m_next;
+  std::atomic<std::size_t> m_prefetched;
+  std::atomic<bool> m_stopped;
+  std::vector<std::thread> m_threads;
+};
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_LIBRARY_PREFETCHER_H_
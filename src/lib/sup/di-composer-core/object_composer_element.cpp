@@ -24,22 +24,57 @@
 
 #include "constants.h"
 #include "element_constructor_map.h"
+#include "element_scheduler.h"
 #include "exceptions.h"
+#include "instance_element.h"
+#include "instrumentation.h"
+#include "library_prefetcher.h"
+
+#include <sup/di/object_manager.h>
 
 #include <sup/xml/tree_data_validate.h>
 
+#include <set>
+#include <tuple>
+
+namespace
+{
+std::unique_ptr<sup::di::IComposerElement> ConstructElement(
+  const sup::xml::TreeData& child_tree, const sup::di::ComposerOptions& options);
+
+// Count the instance types and instances that executing the composer tree stores. Different type
+// names can create instances of the same type, so the type count is an upper bound.
+std::pair<std::size_t, std::size_t> CountInstances(const sup::xml::TreeData& composer_tree);
+
+std::vector<std::string> LibraryNames(const sup::xml::TreeData& composer_tree);
+}  // unnamed namespace
+
 namespace sup
 {
 namespace di
 {
 
-ObjectComposerElement::ObjectComposerElement(const sup::xml::TreeData& composer_tree)
+ObjectComposerElement::ObjectComposerElement(const sup::xml::TreeData& composer_tree,
+                                             const ComposerOptions& options)
   : m_elements{}
+  , m_options{options}
+  , m_type_count{0}
+  , m_instance_count{0}
+  , m_library_names{}
 {
-  ValidateComposerTree(composer_tree);
+  {
+    SUP_DI_TRACE_SPAN(span, m_options.trace_recorder, "validate", "phase");
+    ValidateComposerTree(composer_tree);
+  }
+  std::tie(m_type_count, m_instance_count) = CountInstances(composer_tree);
+  if (m_options.prefetch_libraries)
+  {
+    m_library_names = LibraryNames(composer_tree);
+  }
+  SUP_DI_TRACE_SPAN(span, m_options.trace_recorder, "construct", "phase");
   for (const auto& child : composer_tree.Children())
   {
-    m_elements.push_back(CreateComposerElement(child));
+    m_elements.push_back(CreateComposerElement(child, m_options));
   }
 }
 
@@ -47,9 +82,43 @@ ObjectComposerElement::~ObjectComposerElement() = default;
 
 void ObjectComposerElement::Execute()
 {
-  for (auto& child : m_elements)
+  SUP_DI_TRACE_SPAN(span, m_options.trace_recorder, "execute", "phase");
+  SUP_DI_TRACE_ARGUMENT(span, "threads", std::to_string(m_options.n_threads));
+  LibraryPrefetcher prefetcher{m_library_names, m_options.trace_recorder};
+  if (m_instance_count > 0)
   {
-    child->Execute();
+    GlobalObjectManager().Reserve(m_type_count, m_instance_count);
+  }
+  if (m_options.n_threads > 1)
+  {
+    ExecuteElementsConcurrently(m_elements, m_options.n_threads);
+    return;
+  }
+  // Consecutive instance creations are handed to the ObjectManager as a single batch
+  std::vector<CreateInstanceRequest> requests;
+  std::vector<ErrorCode> results;
+  CreateInstanceRequest request{kInvalidSymbol, kInvalidSymbol, {nullptr, 0}};
+  std::size_t idx = 0;
+  while (idx < m_elements.size())
+  {
+    requests.clear();
+    while (idx < m_elements.size() && m_elements[idx]->GetCreateInstanceRequest(request))
+    {
+      requests.push_back(request);
+      ++idx;
+    }
+    if (requests.empty())
+    {
+      m_elements[idx++]->Execute();
+      continue;
+    }
+    // Stop at the first failure, like executing the elements one by one would
+    GlobalObjectManager().CreateInstances(requests, results, true);
+    for (std::size_t request_idx = 0; request_idx < results.size(); ++request_idx)
+    {
+      CheckCreateInstanceResult(results[request_idx], requests[request_idx].registered_typename,
+                                requests[request_idx].instance_name);
+    }
   }
 }
 
@@ -63,20 +132,97 @@ void ValidateComposerTree(const sup::xml::TreeData& composer_tree)
 }
 
 std::unique_ptr<IComposerElement> CreateComposerElement(const sup::xml::TreeData& child_tree)
+{
+  return CreateComposerElement(child_tree, ComposerOptions{});
+}
+
+std::unique_ptr<IComposerElement> CreateComposerElement(const sup::xml::TreeData& child_tree,
+                                                        const ComposerOptions& options)
+{
+#ifdef SUP_DI_INSTRUMENTATION
+  if (auto recorder = options.trace_recorder)
+  {
+    auto description = DescribeElement(child_tree);
+    std::unique_ptr<IComposerElement> element;
+    {
+      TraceSpan span{recorder, description.name, "construct"};
+      for (const auto& [key, value] : description.args)
+      {
+        span.AddArgument(key, value);
+      }
+      element = ConstructElement(child_tree, options);
+    }
+    return std::make_unique<InstrumentedElement>(std::move(element), std::move(description),
+                                                 recorder);
+  }
+#endif
+  return ConstructElement(child_tree, options);
+}
+
+}  // namespace di
+
+}  // namespace sup
+
+namespace
+{
+std::unique_ptr<sup::di::IComposerElement> ConstructElement(
+  const sup::xml::TreeData& child_tree, const sup::di::ComposerOptions& options)
 {
   auto nodename = child_tree.GetNodeName();
-  const auto& constructor_map = ElementConstructorMap();
+  const auto& constructor_map = sup::di::ElementConstructorMap();
   auto it = constructor_map.find(nodename);
   if (it == constructor_map.end())
   {
     std::string error_message = "sup::di::CreateComposerElement(): unknown child tag [" +
-      nodename + "] of [" + constants::OBJECT_COMPOSER_TAG + "] element";
+      nodename + "] of [" + sup::di::constants::OBJECT_COMPOSER_TAG + "] element";
     throw sup::di::ParseException(error_message);
   }
-  return it->second(child_tree);
+  return it->second(child_tree, options);
 }
 
-}  // namespace di
-
-}  // namespace sup
+std::pair<std::size_t, std::size_t> CountInstances(const sup::xml::TreeData& composer_tree)
+{
+  std::set<std::string> types;
+  std::size_t instance_count = 0;
+  for (const auto& child : composer_tree.Children())
+  {
+    auto nodename = child.GetNodeName();
+    if (nodename == sup::di::constants::CREATE_INSTANCE_TAG)
+    {
+      for (const auto& grandchild : child.Children())
+      {
+        if (grandchild.GetNodeName() == sup::di::constants::TYPE_NAME_TAG)
+        {
+          types.insert(grandchild.GetContent());
+        }
+      }
+    }
+    else if (nodename == sup::di::constants::STRING_INSTANCE_TAG ||
+             nodename == sup::di::constants::INTEGER_INSTANCE_TAG ||
+             nodename == sup::di::constants::DOUBLE_INSTANCE_TAG)
+    {
+      // Literal instances of the same tag share their type
+      types.insert(nodename);
+    }
+    else
+    {
+      continue;
+    }
+    ++instance_count;
+  }
+  return { types.size(), instance_count };
+}
 
+std::vector<std::string> LibraryNames(const sup::xml::TreeData& composer_tree)
+{
+  std::vector<std::string> result;
+  for (const auto& child : composer_tree.Children())
+  {
+    if (child.GetNodeName() == sup::di::constants::LOAD_LIBRARY_TAG)
+    {
+      result.push_back(child.GetContent());
+    }
+  }
+  return result;
+}
+}  // unnamed namespace
@@ -23,11 +23,13 @@
 #ifndef SUP_DI_COMPOSER_OBJECT_COMPOSER_ELEMENT_H_
 #define SUP_DI_COMPOSER_OBJECT_COMPOSER_ELEMENT_H_
 
+#include "composer_options.h"
 #include "i_composer_element.h"
 
 #include <sup/xml/tree_data.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace sup
@@ -38,19 +40,34 @@ namespace di
 class ObjectComposerElement : public IComposerElement
 {
 public:
-  ObjectComposerElement(const sup::xml::TreeData& composer_tree);
+  ObjectComposerElement(const sup::xml::TreeData& composer_tree,
+                        const ComposerOptions& options = {});
   ~ObjectComposerElement();
 
   void Execute() override;
 
 private:
   std::vector<std::unique_ptr<IComposerElement>> m_elements;
+  ComposerOptions m_options;
+  // Hints to pre-size the instance store of the global ObjectManager before execution
+  std::size_t m_type_count;
+  std::size_t m_instance_count;
+  // Libraries to prefetch when execution starts
+  std::vector<std::string> m_library_names;
 };
 
 void ValidateComposerTree(const sup::xml::TreeData& composer_tree);
 
 std::unique_ptr<IComposerElement> CreateComposerElement(const sup::xml::TreeData& child_tree);
 
+/**
+ * @brief Create a composer element with the given options. When instrumentation is enabled and the
+ * options contain a recorder, its construction is recorded and it is wrapped so that its execution
+ * is recorded too.
+ */
+std::unique_ptr<IComposerElement> CreateComposerElement(const sup::xml::TreeData& child_tree,
+                                                        const ComposerOptions& options);
+
 }  // namespace di
 
 }  // namespace sup
@@ -0,0 +1,289 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "streaming_object_tree.h"
+
+#include "exceptions.h"
+#include "instrumentation.h"
+#include "object_composer_element.h"
+
+#include <sup/xml/tree_data.h>
+
+#include <libxml/xmlreader.h>
+
+#include <memory>
+
+namespace
+{
+/**
+ * @brief Reader that returns the top-level elements of an XML document one at a time.
+ *
+ * @details Each element is expanded by the libxml2 text reader, converted to a TreeData child of a
+ * copy of the root element, and released by the reader once it moves on to the next element.
+ */
+class StreamingTreeReader
+{
+public:
+  StreamingTreeReader(xmlTextReaderPtr reader, const std::string& source);
+  ~StreamingTreeReader();
+
+  StreamingTreeReader(const StreamingTreeReader& other) = delete;
+  StreamingTreeReader& operator=(const StreamingTreeReader& other) = delete;
+
+  /**
+   * @brief Read up to the next top-level element.
+   *
+   * @details The returned tree holds the root's name, the root's text content since the previous
+   * element and at most one child. A tree without children is only returned for text content at
+   * the end of the root element.
+   *
+   * @return False when the document ended.
+   */
+  bool ReadNext(std::unique_ptr<sup::xml::TreeData>& composer_tree);
+
+private:
+  int Read();
+  [[noreturn]] void ThrowParseError() const;
+  static void OnError(void* arg, const char* msg, xmlParserSeverities severity,
+                      xmlTextReaderLocatorPtr locator);
+
+  xmlTextReaderPtr m_reader;
+  std::string m_source;
+  std::string m_root_name;
+  std::string m_error;
+  bool m_skip_subtree;
+};
+
+void StreamObjectTree(StreamingTreeReader& reader, const sup::di::ComposerOptions& options);
+
+sup::xml::TreeData TreeDataFromNode(xmlNodePtr node);
+
+std::string QualifiedName(const xmlChar* name, xmlNsPtr ns);
+
+std::string TrimWhitespace(const std::string& str);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace di
+{
+
+void StreamObjectTreeFromFile(const std::string& filename, const ComposerOptions& options)
+{
+  SUP_DI_TRACE_SPAN(span, options.trace_recorder, "stream", "phase");
+  SUP_DI_TRACE_ARGUMENT(span, "file", filename);
+  StreamingTreeReader reader{xmlReaderForFile(filename.c_str(), nullptr, XML_PARSE_NONET),
+                             "file [" + filename + "]"};
+  StreamObjectTree(reader, options);
+}
+
+void StreamObjectTreeFromString(const std::string& representation,
+                                const ComposerOptions& options)
+{
+  SUP_DI_TRACE_SPAN(span, options.trace_recorder, "stream", "phase");
+  StreamingTreeReader reader{xmlReaderForMemory(representation.data(),
+                                                static_cast<int>(representation.size()),
+                                                nullptr, nullptr, XML_PARSE_NONET),
+                             "string"};
+  StreamObjectTree(reader, options);
+}
+
+}  // namespace di
+
+}  // namespace sup
+
+namespace
+{
+StreamingTreeReader::StreamingTreeReader(xmlTextReaderPtr reader, const std::string& source)
+  : m_reader{reader}
+  , m_source{source}
+  , m_root_name{}
+  , m_error{}
+  , m_skip_subtree{false}
+{
+  if (m_reader == nullptr)
+  {
+    std::string error_message =
+      "sup::di::StreamObjectTree(): could not open " + m_source;
+    throw sup::di::ParseException(error_message);
+  }
+  xmlTextReaderSetErrorHandler(m_reader, &StreamingTreeReader::OnError, this);
+}
+
+StreamingTreeReader::~StreamingTreeReader()
+{
+  xmlFreeTextReader(m_reader);
+}
+
+bool StreamingTreeReader::ReadNext(std::unique_ptr<sup::xml::TreeData>& composer_tree)
+{
+  std::string content;
+  int result = 0;
+  if (m_skip_subtree)
+  {
+    m_skip_subtree = false;
+    result = xmlTextReaderNext(m_reader);
+  }
+  else
+  {
+    result = Read();
+  }
+  for (; result == 1; result = Read())
+  {
+    auto depth = xmlTextReaderDepth(m_reader);
+    auto node_type = xmlTextReaderNodeType(m_reader);
+    if (depth == 0 && node_type == XML_READER_TYPE_ELEMENT)
+    {
+      m_root_name = reinterpret_cast<const char*>(xmlTextReaderConstName(m_reader));
+      continue;
+    }
+    if (depth != 1)
+    {
+      continue;
+    }
+    if (node_type == XML_READER_TYPE_TEXT || node_type == XML_READER_TYPE_CDATA)
+    {
+      content += reinterpret_cast<const char*>(xmlTextReaderConstValue(m_reader));
+      continue;
+    }
+    if (node_type != XML_READER_TYPE_ELEMENT)
+    {
+      continue;
+    }
+    auto node = xmlTextReaderExpand(m_reader);
+    if (node == nullptr)
+    {
+      ThrowParseError();
+    }
+    composer_tree = std::make_unique<sup::xml::TreeData>(m_root_name);
+    composer_tree->SetContent(TrimWhitespace(content));
+    composer_tree->AddChild(TreeDataFromNode(node));
+    m_skip_subtree = true;
+    return true;
+  }
+  if (result < 0)
+  {
+    ThrowParseError();
+  }
+  content = TrimWhitespace(content);
+  if (content.empty())
+  {
+    return false;
+  }
+  composer_tree = std::make_unique<sup::xml::TreeData>(m_root_name);
+  composer_tree->SetContent(content);
+  return true;
+}
+
+int StreamingTreeReader::Read()
+{
+  auto result = xmlTextReaderRead(m_reader);
+  if (result < 0)
+  {
+    ThrowParseError();
+  }
+  return result;
+}
+
+void StreamingTreeReader::ThrowParseError() const
+{
+  std::string error_message = "sup::di::StreamObjectTree(): could not parse " + m_source;
+  if (!m_error.empty())
+  {
+    error_message += ": " + m_error;
+  }
+  throw sup::di::ParseException(error_message);
+}
+
+void StreamingTreeReader::OnError(void* arg, const char* msg, xmlParserSeverities severity,
+                                  xmlTextReaderLocatorPtr)
+{
+  auto reader = static_cast<StreamingTreeReader*>(arg);
+  if (reader->m_error.empty() && (severity == XML_PARSER_SEVERITY_ERROR ||
+                                  severity == XML_PARSER_SEVERITY_VALIDITY_ERROR))
+  {
+    reader->m_error = TrimWhitespace(msg);
+  }
+}
+
+void StreamObjectTree(StreamingTreeReader& reader, const sup::di::ComposerOptions& options)
+{
+  std::unique_ptr<sup::xml::TreeData> composer_tree;
+  while (reader.ReadNext(composer_tree))
+  {
+    sup::di::ValidateComposerTree(*composer_tree);
+    for (const auto& child : composer_tree->Children())
+    {
+      sup::di::CreateComposerElement(child, options)->Execute();
+    }
+  }
+}
+
+// Element content is the concatenation of its text, trimmed as by the DOM parser
+sup::xml::TreeData TreeDataFromNode(xmlNodePtr node)
+{
+  sup::xml::TreeData result{QualifiedName(node->name, node->ns)};
+  for (auto attribute = node->properties; attribute != nullptr; attribute = attribute->next)
+  {
+    auto value = xmlNodeListGetString(node->doc, attribute->children, 1);
+    result.AddAttribute(QualifiedName(attribute->name, attribute->ns),
+                        value != nullptr ? reinterpret_cast<const char*>(value) : "");
+    xmlFree(value);
+  }
+  std::string content;
+  for (auto child = node->children; child != nullptr; child = child->next)
+  {
+    if (child->type == XML_ELEMENT_NODE)
+    {
+      result.AddChild(TreeDataFromNode(child));
+    }
+    else if (child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE)
+    {
+      content += reinterpret_cast<const char*>(child->content);
+    }
+  }
+  result.SetContent(TrimWhitespace(content));
+  return result;
+}
+
+std::string QualifiedName(const xmlChar* name, xmlNsPtr ns)
+{
+  std::string result = reinterpret_cast<const char*>(name);
+  if (ns != nullptr && ns->prefix != nullptr)
+  {
+    result = reinterpret_cast<const char*>(ns->prefix) + (":" + result);
+  }
+  return result;
+}
+
+std::string TrimWhitespace(const std::string& str)
+{
+  const char* whitespace = " \t\r\n";
+  auto first = str.find_first_not_of(whitespace);
+  if (first == std::string::npos)
+  {
+    return {};
+  }
+  auto last = str.find_last_not_of(whitespace);
+  return str.substr(first, last - first + 1);
+}
+}  // unnamed namespace
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_COMPOSER_STREAMING_OBJECT_TREE_H_
+#define SUP_DI_COMPOSER_STREAMING_OBJECT_TREE_H_
+
+#include "composer_options.h"
+
+#include <string>
+
+namespace sup
+{
+namespace di
+{
+
+/**
+ * @brief Parse an ObjectComposer XML file one top-level element at a time and execute each
+ * element as soon as it was parsed.
+ *
+ * @details Only the current element is kept in memory, so peak memory does not grow with the size
+ * of the file. Each element is validated, constructed and executed before the next one is read.
+ * Consequently, elements that precede an invalid element have already been executed when the
+ * error is reported. The reader parses ahead in blocks, so malformed XML may be reported before
+ * some of the elements that precede it were executed. ComposerOptions::n_threads and
+ * ComposerOptions::cache_directory are ignored: streamed elements are always executed
+ * sequentially and are not cached.
+ *
+ * @throws ParseException when the file could not be read or is not well-formed XML.
+ * @throws RuntimeException when executing one of the elements failed.
+ */
+void StreamObjectTreeFromFile(const std::string& filename, const ComposerOptions& options = {});
+
+/**
+ * @brief Parse an ObjectComposer XML representation one top-level element at a time and execute
+ * each element as soon as it was parsed.
+ *
+ * @see StreamObjectTreeFromFile
+ */
+void StreamObjectTreeFromString(const std::string& representation,
+                                const ComposerOptions& options = {});
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_COMPOSER_STREAMING_OBJECT_TREE_H_
@@ -36,7 +36,7 @@ namespace di
 {
 
 StringInstanceElement::StringInstanceElement(const sup::xml::TreeData& string_instance_tree)
-  : m_instance_name{}
+  : m_instance_name{kInvalidSymbol}
   , m_value{}
 {
   ValidateLiteralInstanceTree(string_instance_tree);
@@ -62,11 +62,16 @@ void StringInstanceElement::Execute()
   if (!global_object_manager.RegisterInstance(m_value, m_instance_name))
   {
     std::string error_message = "StringInstanceElement::Execute(): creating string with name [" +
-      m_instance_name + "] and value [" + m_value + "] failed";
+      utils::GetSymbolName(m_instance_name) + "] and value [" + m_value + "] failed";
     throw sup::di::RuntimeException(error_message);
   }
 }
 
+ElementAccess StringInstanceElement::GetAccess() const
+{
+  return ElementAccess{false, {}, {m_instance_name}};
+}
+
 }  // namespace di
 
 }  // namespace sup
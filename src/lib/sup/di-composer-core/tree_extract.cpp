@@ -24,6 +24,8 @@
 
 #include "exceptions.h"
 
+#include <sup/di/object_manager.h>
+
 namespace sup
 {
 namespace di
@@ -55,6 +57,25 @@ void AppendFromTreeNodeContent(std::vector<std::string>& dest, const sup::xml::T
   dest.push_back(content);
 }
 
+void SetFromTreeNodeContent(Symbol& dest, const sup::xml::TreeData& tree)
+{
+  std::string name;
+  SetFromTreeNodeContent(name, tree);
+  dest = GlobalObjectManager().Intern(name);
+}
+
+void AppendFromTreeNodeContent(std::vector<Symbol>& dest, const sup::xml::TreeData& tree)
+{
+  std::string name;
+  SetFromTreeNodeContent(name, tree);
+  dest.push_back(GlobalObjectManager().Intern(name));
+}
+
+std::string GetSymbolName(Symbol symbol)
+{
+  return std::string{GlobalObjectManager().GetSymbolName(symbol)};
+}
+
 }  // namespace utils
 
 }  // namespace di
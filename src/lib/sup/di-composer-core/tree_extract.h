@@ -23,6 +23,8 @@
 #ifndef SUP_DI_COMPOSER_TREE_EXTRACT_H_
 #define SUP_DI_COMPOSER_TREE_EXTRACT_H_
 
+#include <sup/di/symbol_table.h>
+
 #include <sup/xml/tree_data.h>
 
 #include <vector>
@@ -38,6 +40,19 @@ void SetFromTreeNodeContent(std::string& dest, const sup::xml::TreeData& tree);
 
 void AppendFromTreeNodeContent(std::vector<std::string>& dest, const sup::xml::TreeData& tree);
 
+/**
+ * @brief Overloads that intern the content in the global ObjectManager, so names are only hashed
+ * once during parsing.
+ */
+void SetFromTreeNodeContent(Symbol& dest, const sup::xml::TreeData& tree);
+
+void AppendFromTreeNodeContent(std::vector<Symbol>& dest, const sup::xml::TreeData& tree);
+
+/**
+ * @brief Retrieve the name of a symbol that was interned in the global ObjectManager.
+ */
+std::string GetSymbolName(Symbol symbol);
+
 }  // namespace utils
 
 }  // namespace di
@@ -23,6 +23,39 @@
 #include "di_utils.h"
 
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+const std::size_t kPrefetchBlockSize = 1 << 16;
+
+struct LoadedLibrary
+{
+  void* handle;
+  int flags;
+};
+
+struct LibraryRegistry
+{
+  std::mutex mutex = {};
+  std::map<std::string, LoadedLibrary> libraries = {};
+};
+
+LibraryRegistry& GetLibraryRegistry();
+
+int LibraryLoadFlags(const sup::di::utils::LibraryLoadOptions& options);
+
+// Flags of a library that was loaded with both sets of flags
+int MergeLibraryLoadFlags(int flags, int other_flags);
+
+std::string FindLibraryFile(const std::string& library_name);
+}  // unnamed namespace
 
 namespace sup
 {
@@ -33,11 +66,76 @@ namespace utils
 
 ErrorCode LoadLibrary(const std::string& library_name)
 {
-  auto handle = dlopen(library_name.c_str(), RTLD_NOW);
+  return LoadLibrary(library_name, LibraryLoadOptions{});
+}
+
+ErrorCode LoadLibrary(const std::string& library_name, const LibraryLoadOptions& options)
+{
+  auto& registry = GetLibraryRegistry();
+  auto flags = LibraryLoadFlags(options);
+  {
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    auto it = registry.libraries.find(library_name);
+    if (it != registry.libraries.end() &&
+        MergeLibraryLoadFlags(it->second.flags, flags) == it->second.flags)
+    {
+      return ErrorCode::kSuccess;
+    }
+  }
+  // The lock is not held while loading, since the library's constructors may load libraries too
+  auto handle = dlopen(library_name.c_str(), flags);
   if (handle == nullptr)
   {
     return ErrorCode::kLibraryNotLoaded;
   }
+  std::lock_guard<std::mutex> lock{registry.mutex};
+  auto it = registry.libraries.find(library_name);
+  if (it == registry.libraries.end())
+  {
+    registry.libraries.emplace(library_name, LoadedLibrary{handle, flags});
+  }
+  else
+  {
+    it->second.flags = MergeLibraryLoadFlags(it->second.flags, flags);
+  }
+  return ErrorCode::kSuccess;
+}
+
+void* GetLibraryHandle(const std::string& library_name)
+{
+  auto& registry = GetLibraryRegistry();
+  std::lock_guard<std::mutex> lock{registry.mutex};
+  auto it = registry.libraries.find(library_name);
+  return it != registry.libraries.end() ? it->second.handle : nullptr;
+}
+
+std::vector<std::string> GetLoadedLibraries()
+{
+  auto& registry = GetLibraryRegistry();
+  std::lock_guard<std::mutex> lock{registry.mutex};
+  std::vector<std::string> result;
+  result.reserve(registry.libraries.size());
+  for (const auto& entry : registry.libraries)
+  {
+    result.push_back(entry.first);
+  }
+  return result;
+}
+
+ErrorCode PrefetchLibrary(const std::string& library_name)
+{
+  auto filename = FindLibraryFile(library_name);
+  int fd = filename.empty() ? -1 : ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    return ErrorCode::kLibraryNotLoaded;
+  }
+  // The advice lets the kernel issue large requests; reading waits until they completed
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  std::vector<char> buffer(kPrefetchBlockSize);
+  while (::read(fd, buffer.data(), buffer.size()) > 0)
+  {}
+  ::close(fd);
   return ErrorCode::kSuccess;
 }
 
@@ -46,3 +144,60 @@ ErrorCode LoadLibrary(const std::string& library_name)
 }  // namespace di
 
 }  // namespace sup
+
+namespace
+{
+LibraryRegistry& GetLibraryRegistry()
+{
+  static LibraryRegistry registry;
+  return registry;
+}
+
+int LibraryLoadFlags(const sup::di::utils::LibraryLoadOptions& options)
+{
+  int flags = options.lazy_binding ? RTLD_LAZY : RTLD_NOW;
+  flags |= options.global_symbols ? RTLD_GLOBAL : RTLD_LOCAL;
+  if (options.no_delete)
+  {
+    flags |= RTLD_NODELETE;
+  }
+  return flags;
+}
+
+int MergeLibraryLoadFlags(int flags, int other_flags)
+{
+  auto result = flags | other_flags;
+  if ((result & RTLD_NOW) != 0)
+  {
+    result &= ~RTLD_LAZY;
+  }
+  return result;
+}
+
+std::string FindLibraryFile(const std::string& library_name)
+{
+  if (library_name.find('/') != std::string::npos)
+  {
+    return library_name;
+  }
+  const char* search_path = std::getenv("LD_LIBRARY_PATH");
+  std::string directories = search_path != nullptr ? search_path : "";
+  std::size_t start = 0;
+  while (start < directories.size())
+  {
+    auto end = directories.find(':', start);
+    if (end == std::string::npos)
+    {
+      end = directories.size();
+    }
+    auto directory = directories.substr(start, end - start);
+    auto filename = (directory.empty() ? std::string{"."} : directory) + "/" + library_name;
+    if (::access(filename.c_str(), R_OK) == 0)
+    {
+      return filename;
+    }
+    start = end + 1;
+  }
+  return {};
+}
+}  // unnamed namespace
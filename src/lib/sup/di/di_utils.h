@@ -26,6 +26,7 @@
 #include "error_codes.h"
 
 #include <string>
+#include <vector>
 
 namespace sup
 {
@@ -34,8 +35,56 @@ namespace di
 namespace utils
 {
 
+/**
+ * @brief Options of LoadLibrary, which map to dlopen flags. The defaults correspond to
+ * RTLD_NOW | RTLD_LOCAL.
+ */
+struct LibraryLoadOptions
+{
+  // RTLD_LAZY: functions are only resolved when they are first called. A function that cannot be
+  // resolved then terminates the process, instead of failing the load.
+  bool lazy_binding = false;
+  // RTLD_GLOBAL: the library's symbols are used to resolve libraries that are loaded later
+  bool global_symbols = false;
+  // RTLD_NODELETE: the library is never unloaded
+  bool no_delete = false;
+};
+
+/**
+ * @brief Load a shared library and keep its handle in a process-wide registry.
+ *
+ * @details A library that is already in the registry under the same name is not loaded again,
+ * unless the options add RTLD_NOW, RTLD_GLOBAL or RTLD_NODELETE to the flags it was loaded with.
+ * dlopen is then called again to promote the loaded library. Libraries are never unloaded.
+ */
+ErrorCode LoadLibrary(const std::string& library_name, const LibraryLoadOptions& options);
+
+/**
+ * @brief Load a shared library with the default options (RTLD_NOW | RTLD_LOCAL).
+ */
 ErrorCode LoadLibrary(const std::string& library_name);
 
+/**
+ * @brief Handle of a library loaded with LoadLibrary under this name, or nullptr.
+ */
+void* GetLibraryHandle(const std::string& library_name);
+
+/**
+ * @brief Names of all libraries loaded with LoadLibrary, in alphabetical order.
+ */
+std::vector<std::string> GetLoadedLibraries();
+
+/**
+ * @brief Read a shared library into the page cache without loading it, so that a later
+ * LoadLibrary does not wait for disk I/O.
+ *
+ * @details Names without a slash are looked up in the directories of LD_LIBRARY_PATH only. This
+ * function blocks until the whole file was read and is meant to be called on a background thread.
+ *
+ * @return ErrorCode::kLibraryNotLoaded when the file was not found or could not be opened.
+ */
+ErrorCode PrefetchLibrary(const std::string& library_name);
+
 }  // namespace utils
 
 }  // namespace di
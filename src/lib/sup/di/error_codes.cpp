@@ -39,7 +39,9 @@ std::string ErrorString(const ErrorCode& code)
     { ErrorCode::kWrongNumberOfDependencies, "Wrong number of dependencies" },
     { ErrorCode::kInvalidInstanceName, "Invalid instance name" },
     { ErrorCode::kGlobalFunctionFailed, "Global function failed" },
-    { ErrorCode::kLibraryNotLoaded, "Could not load library"}
+    { ErrorCode::kLibraryNotLoaded, "Could not load library"},
+    { ErrorCode::kInvalidPreparedCall, "Invalid prepared call"},
+    { ErrorCode::kWrongInstanceType, "Wrong instance type"}
   };
   auto it = code_map.find(code);
   if (it == code_map.end())
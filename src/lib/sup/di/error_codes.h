@@ -40,7 +40,9 @@ enum class ErrorCode : std::uint32_t
   kWrongNumberOfDependencies,
   kInvalidInstanceName,
   kGlobalFunctionFailed,
-  kLibraryNotLoaded
+  kLibraryNotLoaded,
+  kInvalidPreparedCall,
+  kWrongInstanceType
 };
 
 std::string ErrorString(const ErrorCode& code);
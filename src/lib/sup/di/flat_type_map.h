@@ -0,0 +1,215 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+
+#ifndef SUP_DI_FLAT_TYPE_MAP_H_
+#define SUP_DI_FLAT_TYPE_MAP_H_
+
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <typeinfo>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+namespace internal
+{
+
+/**
+ * @brief Class template for a map whose keys are types instead of values, implemented as an
+ * open-addressing hash table.
+ *
+ * @details Each type gets a static hash code, computed only once per type. A lookup probes the
+ * table on that hash code and only compares std::type_index objects on a hash match. Entries are
+ * stored in a deque, so references to stored values remain valid when the table grows. All memory
+ * is obtained from the memory resource that is passed at construction.
+ *
+ * @note The hash code is derived from the type's name instead of the address of a per-type static,
+ * so identical types from different shared libraries map to the same entry.
+ */
+template <typename Val>
+class FlatTypeMap
+{
+  using Container = std::pmr::deque<std::pair<std::type_index, Val>>;
+public:
+  using iterator = typename Container::iterator;
+  using const_iterator = typename Container::const_iterator;
+
+  FlatTypeMap() : FlatTypeMap(std::pmr::get_default_resource()) {}
+  explicit FlatTypeMap(std::pmr::memory_resource* resource)
+    : container(resource), slots(kInitialSlotCount, resource) {}
+
+  iterator begin() { return container.begin(); }
+  iterator end() { return container.end(); }
+  const_iterator begin() const { return container.begin(); }
+  const_iterator end() const { return container.end(); }
+  const_iterator cbegin() const { return container.cbegin(); }
+  const_iterator cend() const { return container.cend(); }
+
+  template <class Key>
+  iterator find()
+  {
+    auto idx = FindIndex(TypeHash<Key>(), TypeId<Key>());
+    return idx == kNotFound ? end() : begin() + idx;
+  }
+  template <class Key>
+  const_iterator find() const
+  {
+    auto idx = FindIndex(TypeHash<Key>(), TypeId<Key>());
+    return idx == kNotFound ? end() : begin() + idx;
+  }
+  template <class Key>
+  void put(Val &&value)
+  {
+    auto hash = TypeHash<Key>();
+    auto idx = FindIndex(hash, TypeId<Key>());
+    if (idx != kNotFound)
+    {
+      container[idx].second = std::forward<Val>(value);
+      return;
+    }
+    if (2 * (container.size() + 1) > slots.size())
+    {
+      Grow();
+    }
+    container.emplace_back(TypeId<Key>(), std::forward<Val>(value));
+    Insert(hash, container.size() - 1);
+  }
+
+  /**
+   * @brief Prepare the table for holding the given number of types without growing.
+   */
+  void reserve(std::size_t count)
+  {
+    auto slot_count = SlotCountFor(count);
+    if (slot_count > slots.size())
+    {
+      Rehash(slot_count);
+    }
+  }
+
+  /**
+   * @brief Shrink the table to the size that is needed for the current types. Stored values are
+   * not moved.
+   */
+  void shrink_to_fit()
+  {
+    auto slot_count = SlotCountFor(container.size());
+    if (slot_count < slots.size())
+    {
+      Rehash(slot_count);
+    }
+  }
+
+  template <class Key>
+  static std::type_index TypeId()
+  {
+    return std::type_index(typeid(Key));
+  }
+
+  template <class Key>
+  static std::size_t TypeHash()
+  {
+    static const std::size_t hash = typeid(Key).hash_code();
+    return hash;
+  }
+
+private:
+  static constexpr std::size_t kInitialSlotCount = 16;
+  static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+  struct Slot
+  {
+    std::size_t hash = 0;
+    std::size_t index = kNotFound;
+  };
+
+  // Smallest slot count that keeps the load factor of the given number of types at most 1/2
+  static std::size_t SlotCountFor(std::size_t count)
+  {
+    auto slot_count = kInitialSlotCount;
+    while (2 * count > slot_count)
+    {
+      slot_count *= 2;
+    }
+    return slot_count;
+  }
+
+  std::size_t FindIndex(std::size_t hash, const std::type_index& type_id) const
+  {
+    const auto mask = slots.size() - 1;
+    for (auto pos = hash & mask; slots[pos].index != kNotFound; pos = (pos + 1) & mask)
+    {
+      const auto& slot = slots[pos];
+      if (slot.hash == hash && container[slot.index].first == type_id)
+      {
+        return slot.index;
+      }
+    }
+    return kNotFound;
+  }
+
+  void Insert(std::size_t hash, std::size_t index)
+  {
+    const auto mask = slots.size() - 1;
+    auto pos = hash & mask;
+    while (slots[pos].index != kNotFound)
+    {
+      pos = (pos + 1) & mask;
+    }
+    slots[pos] = Slot{hash, index};
+  }
+
+  void Grow()
+  {
+    Rehash(2 * slots.size());
+  }
+
+  void Rehash(std::size_t slot_count)
+  {
+    std::pmr::vector<Slot> old_slots(slot_count, slots.get_allocator());
+    std::swap(slots, old_slots);
+    for (const auto& slot : old_slots)
+    {
+      if (slot.index != kNotFound)
+      {
+        Insert(slot.hash, slot.index);
+      }
+    }
+  }
+
+  Container container;
+  std::pmr::vector<Slot> slots;
+};
+
+}  // namespace internal
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_FLAT_TYPE_MAP_H_
@@ -0,0 +1,279 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_HASHED_INSTANCE_MAP_H_
+#define SUP_DI_HASHED_INSTANCE_MAP_H_
+
+#include <sup/di/instance_container.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+namespace internal
+{
+/**
+ * @brief Traits that define how keys of a HashedInstanceMap are looked up and hashed.
+ *
+ * @details String keys are looked up through std::string_view, so lookups with string literals,
+ * character pointers or string views do not need to create a temporary std::string.
+ */
+template <typename Key>
+struct InstanceKeyTraits
+{
+  using LookupType = const Key&;
+
+  static std::size_t Hash(LookupType key) { return std::hash<Key>{}(key); }
+};
+
+template <>
+struct InstanceKeyTraits<std::string>
+{
+  using LookupType = std::string_view;
+
+  static std::size_t Hash(LookupType key) { return std::hash<std::string_view>{}(key); }
+};
+
+template <>
+struct InstanceKeyTraits<std::pmr::string>
+{
+  using LookupType = std::string_view;
+
+  static std::size_t Hash(LookupType key) { return std::hash<std::string_view>{}(key); }
+};
+
+/**
+ * @brief Open-addressing hash map from keys to AbstractInstanceContainer objects.
+ *
+ * @details The entries are stored contiguously as (key, container) pairs, while a separate table of
+ * slots with linear probing indexes them by hash. The interface is the subset of std::map's
+ * interface that is used by ServiceStore, so both can be used interchangeably as its InstanceMap.
+ *
+ * All memory is obtained from the memory resource that is passed at construction. Allocator aware
+ * keys, e.g. std::pmr::string, also use this memory resource.
+ *
+ * @note Inserting or erasing entries invalidates iterators.
+ */
+template <typename Key>
+class HashedInstanceMap
+{
+  using Container = std::pmr::vector<std::pair<Key, InstanceContainerPtr>>;
+  using LookupType = typename InstanceKeyTraits<Key>::LookupType;
+public:
+  using iterator = typename Container::iterator;
+  using const_iterator = typename Container::const_iterator;
+
+  HashedInstanceMap() : HashedInstanceMap(std::pmr::get_default_resource()) {}
+  explicit HashedInstanceMap(std::pmr::memory_resource* resource)
+    : m_entries(resource), m_slots(kInitialSlotCount, resource) {}
+
+  iterator begin() { return m_entries.begin(); }
+  iterator end() { return m_entries.end(); }
+  const_iterator begin() const { return m_entries.begin(); }
+  const_iterator end() const { return m_entries.end(); }
+  std::size_t size() const { return m_entries.size(); }
+
+  /**
+   * @brief Prepare the map for holding the given number of entries without rehashing or
+   * reallocating.
+   */
+  void reserve(std::size_t count)
+  {
+    m_entries.reserve(count);
+    auto slot_count = SlotCountFor(count);
+    if (slot_count > m_slots.size())
+    {
+      Rehash(slot_count);
+    }
+  }
+
+  /**
+   * @brief Release the capacity that is not needed for the current entries.
+   */
+  void shrink_to_fit()
+  {
+    m_entries.shrink_to_fit();
+    auto slot_count = SlotCountFor(m_entries.size());
+    if (slot_count < m_slots.size())
+    {
+      Rehash(slot_count);
+    }
+  }
+
+  iterator find(LookupType key)
+  {
+    auto pos = FindSlot(key);
+    return pos == kNotFound ? end() : begin() + m_slots[pos].index;
+  }
+
+  const_iterator find(LookupType key) const
+  {
+    auto pos = FindSlot(key);
+    return pos == kNotFound ? end() : begin() + m_slots[pos].index;
+  }
+
+  std::pair<iterator, bool> emplace(LookupType key, InstanceContainerPtr&& container)
+  {
+    auto pos = FindSlot(key);
+    if (pos != kNotFound)
+    {
+      return { begin() + m_slots[pos].index, false };
+    }
+    if (2 * (m_entries.size() + 1) > m_slots.size())
+    {
+      Rehash(2 * m_slots.size());
+    }
+    m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::move(container)));
+    InsertSlot(InstanceKeyTraits<Key>::Hash(key), m_entries.size() - 1);
+    return { end() - 1, true };
+  }
+
+  void erase(iterator it)
+  {
+    auto index = static_cast<std::size_t>(it - begin());
+    EraseSlot(FindSlotForIndex(index));
+    auto last = m_entries.size() - 1;
+    if (index != last)
+    {
+      m_slots[FindSlotForIndex(last)].index = index;
+      m_entries[index] = std::move(m_entries[last]);
+    }
+    m_entries.pop_back();
+  }
+
+private:
+  static constexpr std::size_t kInitialSlotCount = 16;
+  static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+  struct Slot
+  {
+    std::size_t hash = 0;
+    std::size_t index = kNotFound;
+  };
+
+  // Smallest slot count that keeps the load factor of the given number of entries at most 1/2
+  static std::size_t SlotCountFor(std::size_t count)
+  {
+    auto slot_count = kInitialSlotCount;
+    while (2 * count > slot_count)
+    {
+      slot_count *= 2;
+    }
+    return slot_count;
+  }
+
+  std::size_t FindSlot(LookupType key) const
+  {
+    const auto hash = InstanceKeyTraits<Key>::Hash(key);
+    const auto mask = m_slots.size() - 1;
+    for (auto pos = hash & mask; m_slots[pos].index != kNotFound; pos = (pos + 1) & mask)
+    {
+      const auto& slot = m_slots[pos];
+      if (slot.hash == hash && m_entries[slot.index].first == key)
+      {
+        return pos;
+      }
+    }
+    return kNotFound;
+  }
+
+  std::size_t FindSlotForIndex(std::size_t index) const
+  {
+    const auto mask = m_slots.size() - 1;
+    auto pos = InstanceKeyTraits<Key>::Hash(m_entries[index].first) & mask;
+    while (m_slots[pos].index != index)
+    {
+      pos = (pos + 1) & mask;
+    }
+    return pos;
+  }
+
+  void InsertSlot(std::size_t hash, std::size_t index)
+  {
+    const auto mask = m_slots.size() - 1;
+    auto pos = hash & mask;
+    while (m_slots[pos].index != kNotFound)
+    {
+      pos = (pos + 1) & mask;
+    }
+    m_slots[pos] = Slot{hash, index};
+  }
+
+  // Backward shift deletion: move subsequent entries of the probe sequence into the freed slot,
+  // so lookups never need tombstones.
+  void EraseSlot(std::size_t pos)
+  {
+    const auto mask = m_slots.size() - 1;
+    auto next = pos;
+    while (true)
+    {
+      next = (next + 1) & mask;
+      if (m_slots[next].index == kNotFound)
+      {
+        break;
+      }
+      auto ideal = m_slots[next].hash & mask;
+      bool stays = pos <= next ? (pos < ideal && ideal <= next) : (pos < ideal || ideal <= next);
+      if (!stays)
+      {
+        m_slots[pos] = m_slots[next];
+        pos = next;
+      }
+    }
+    m_slots[pos] = Slot{};
+  }
+
+  void Rehash(std::size_t slot_count)
+  {
+    std::pmr::vector<Slot> old_slots(slot_count, m_slots.get_allocator());
+    std::swap(m_slots, old_slots);
+    for (const auto& slot : old_slots)
+    {
+      if (slot.index != kNotFound)
+      {
+        InsertSlot(slot.hash, slot.index);
+      }
+    }
+  }
+
+  Container m_entries;
+  std::pmr::vector<Slot> m_slots;
+};
+
+}  // namespace internal
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_HASHED_INSTANCE_MAP_H_
@@ -23,7 +23,11 @@
 #ifndef SUP_DI_INSTANCE_CONTAINER_H_
 #define SUP_DI_INSTANCE_CONTAINER_H_
 
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
 
 namespace sup
 {
@@ -76,6 +80,44 @@ private:
   std::unique_ptr<T, Deleter> pointer;
 };
 
+/**
+ * @brief Deleter for instance containers that were either allocated with new or by a memory
+ * resource. In the latter case, the memory is returned to that resource.
+ */
+class InstanceContainerDeleter
+{
+public:
+  InstanceContainerDeleter() noexcept : m_resource{nullptr}, m_size{0}, m_alignment{0} {}
+  InstanceContainerDeleter(std::pmr::memory_resource* resource, std::size_t size,
+                           std::size_t alignment) noexcept
+    : m_resource{resource}, m_size{size}, m_alignment{alignment} {}
+  InstanceContainerDeleter(std::default_delete<AbstractInstanceContainer>) noexcept
+    : InstanceContainerDeleter() {}
+
+  void operator()(AbstractInstanceContainer* container) const
+  {
+    if (m_resource == nullptr)
+    {
+      delete container;
+    }
+    else
+    {
+      container->~AbstractInstanceContainer();
+      m_resource->deallocate(container, m_size, m_alignment);
+    }
+  }
+
+private:
+  std::pmr::memory_resource* m_resource;
+  std::size_t m_size;
+  std::size_t m_alignment;
+};
+
+/**
+ * @brief Owning pointer to a type erased instance container.
+ */
+using InstanceContainerPtr = std::unique_ptr<AbstractInstanceContainer, InstanceContainerDeleter>;
+
 /**
  * @brief Function template that creates a new InstanceContainer using template argument deduction.
  */
@@ -85,14 +127,36 @@ InstanceContainer<T, Deleter>* MakeInstanceContainer(std::unique_ptr<T, Deleter>
   return new InstanceContainer<T, Deleter>(std::move(p));
 }
 
+/**
+ * @brief Function template that constructs an instance container in memory obtained from the
+ * given memory resource.
+ */
+template <class Container, class... Args>
+InstanceContainerPtr AllocateInstanceContainer(std::pmr::memory_resource* resource,
+                                               Args&&... args)
+{
+  void* memory = resource->allocate(sizeof(Container), alignof(Container));
+  try
+  {
+    return InstanceContainerPtr{new (memory) Container(std::forward<Args>(args)...),
+                                InstanceContainerDeleter{resource, sizeof(Container),
+                                                         alignof(Container)}};
+  }
+  catch(...)
+  {
+    resource->deallocate(memory, sizeof(Container), alignof(Container));
+    throw;
+  }
+}
+
 /**
  * @brief Function template that wraps a unique_ptr to a type into a unique_ptr to an
  * AbstractInstanceContainer.
  */
 template <class T, class Deleter>
-std::unique_ptr<AbstractInstanceContainer> WrapIntoContainer(std::unique_ptr<T, Deleter>&& p)
+InstanceContainerPtr WrapIntoContainer(std::unique_ptr<T, Deleter>&& p)
 {
-  return std::unique_ptr<AbstractInstanceContainer>{MakeInstanceContainer(std::move(p))};
+  return InstanceContainerPtr{MakeInstanceContainer(std::move(p))};
 }
 
 /**
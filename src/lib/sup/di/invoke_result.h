@@ -0,0 +1,85 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_INVOKE_RESULT_H_
+#define SUP_DI_INVOKE_RESULT_H_
+
+#include <sup/di/error_codes.h>
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace sup
+{
+namespace di
+{
+namespace internal
+{
+
+/**
+ * @brief Class template that holds either the return value of a function invoked with injected
+ * dependencies, or the error code and the index of the dependency that prevented the invocation.
+ */
+template <typename T>
+class InvokeResult
+{
+public:
+  explicit InvokeResult(T&& value)
+    : m_error_code{ErrorCode::kSuccess}
+    , m_dependency_index{0}
+    , m_value{std::move(value)}
+  {}
+
+  InvokeResult(ErrorCode error_code, std::size_t dependency_index)
+    : m_error_code{error_code}
+    , m_dependency_index{dependency_index}
+    , m_value{}
+  {}
+
+  bool IsSuccess() const { return m_error_code == ErrorCode::kSuccess; }
+
+  ErrorCode GetErrorCode() const { return m_error_code; }
+
+  /**
+   * @brief Index of the dependency that caused the failure. Only meaningful on failure.
+   */
+  std::size_t GetDependencyIndex() const { return m_dependency_index; }
+
+  /**
+   * @brief Access the contained return value. Only allowed on success.
+   */
+  T& GetValue() { return *m_value; }
+
+private:
+  ErrorCode m_error_code;
+  std::size_t m_dependency_index;
+  std::optional<T> m_value;
+};
+
+}  // namespace internal
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_INVOKE_RESULT_H_
@@ -22,47 +22,965 @@
 
 #include "sup/di/object_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <new>
+
+namespace
+{
+/**
+ * @brief Scratch list for the symbols of a call's dependencies. Common numbers of dependencies fit
+ * in a buffer on the stack, so translating names to symbols does not allocate.
+ */
+class DependencySymbols
+{
+public:
+  DependencySymbols()
+    : m_buffer{}
+    , m_resource{m_buffer, sizeof(m_buffer), std::pmr::new_delete_resource()}
+    , m_symbols{&m_resource}
+  {}
+
+  DependencySymbols(const DependencySymbols& other) = delete;
+  DependencySymbols& operator=(const DependencySymbols& other) = delete;
+
+  std::pmr::vector<sup::di::Symbol>& Get() { return m_symbols; }
+
+private:
+  sup::di::Symbol m_buffer[16];
+  std::pmr::monotonic_buffer_resource m_resource;
+  std::pmr::vector<sup::di::Symbol> m_symbols;
+};
+
+const char* const kTraceFileVariable = "SUP_DI_TRACE_FILE";
+
+// Deferred instances created on this thread can only trigger the creation of instances that were
+// deferred before them. Sequence numbers are shared by all ObjectManagers, since creations can
+// nest across them.
+std::atomic<std::size_t> next_deferred_sequence{0};
+thread_local std::size_t deferred_sequence_limit = std::numeric_limits<std::size_t>::max();
+
+class DeferredSequenceLimit
+{
+public:
+  explicit DeferredSequenceLimit(std::size_t limit)
+    : m_previous_limit{deferred_sequence_limit}
+  {
+    deferred_sequence_limit = limit;
+  }
+  ~DeferredSequenceLimit() { deferred_sequence_limit = m_previous_limit; }
+
+  DeferredSequenceLimit(const DeferredSequenceLimit& other) = delete;
+  DeferredSequenceLimit& operator=(const DeferredSequenceLimit& other) = delete;
+
+private:
+  std::size_t m_previous_limit;
+};
+
+sup::di::TraceRecorder& EnableTrace(sup::di::ObjectManager& object_manager,
+                                    const std::string& filename);
+}  // unnamed namespace
+
 namespace sup
 {
 namespace di
 {
+struct ObjectManager::RootState
+{
+  explicit RootState(std::pmr::memory_resource* resource)
+    : mutex{}
+    , symbols{resource}
+  {}
+
+  std::shared_mutex mutex;
+  SymbolTable symbols;
+};
+
+void ObjectManager::RootStateDeleter::operator()(RootState* root_state) const
+{
+  root_state->~RootState();
+  resource->deallocate(root_state, sizeof(RootState), alignof(RootState));
+}
+
+std::unique_ptr<ObjectManager::RootState, ObjectManager::RootStateDeleter>
+ObjectManager::CreateRootState(std::pmr::memory_resource* resource)
+{
+  void* memory = resource->allocate(sizeof(RootState), alignof(RootState));
+  try
+  {
+    return {new (memory) RootState{resource}, RootStateDeleter{resource}};
+  }
+  catch (...)
+  {
+    resource->deallocate(memory, sizeof(RootState), alignof(RootState));
+    throw;
+  }
+}
+
+struct ObjectManager::DeferredInstance
+{
+  Symbol registered_typename = kInvalidSymbol;
+  std::vector<Symbol> dependency_names = {};
+  std::size_t sequence = 0;
+  std::once_flag created = {};
+  ErrorCode result = ErrorCode::kSuccess;
+};
+
+namespace internal
+{
+std::size_t NextTypedKeyIndex()
+{
+  static std::atomic<std::size_t> next_index{0};
+  return next_index++;
+}
+
+}  // namespace internal
+
+PreparedCall::PreparedCall()
+  : m_object_manager{nullptr}
+  , m_invoker{nullptr}
+  , m_instance_name{kInvalidSymbol}
+  , m_dependency_names{}
+  , m_dependencies{}
+  , m_generation{0}
+{}
+
+PreparedCall::~PreparedCall() = default;
+
+PreparedCall::PreparedCall(const PreparedCall& other) = default;
+
+PreparedCall::PreparedCall(PreparedCall&& other) = default;
+
+PreparedCall& PreparedCall::operator=(const PreparedCall& other) = default;
+
+PreparedCall& PreparedCall::operator=(PreparedCall&& other) = default;
+
 ObjectManager::ObjectManager()
-  : m_factory_functions{}
-  , m_global_functions{}
-  , m_service_store{}
+  : ObjectManager(std::pmr::get_default_resource())
+{}
+
+ObjectManager::ObjectManager(std::pmr::memory_resource* resource)
+  : m_parent{nullptr}
+  , m_root_state{CreateRootState(resource)}
+  , m_mutex{m_root_state->mutex}
+  , m_symbols{m_root_state->symbols}
+  , m_factory_functions{resource}
+  , m_global_functions{resource}
+  , m_service_store{resource}
+  , m_typed_key_slots{resource}
+  , m_trace_recorder{nullptr}
+  , m_deferred_instances{resource}
+  , m_deferred_count{0}
+{}
+
+ObjectManager::ObjectManager(ObjectManager& parent, std::pmr::memory_resource* resource)
+  : m_parent{&parent}
+  , m_root_state{nullptr, RootStateDeleter{nullptr}}
+  , m_mutex{parent.m_mutex}
+  , m_symbols{parent.m_symbols}
+  , m_factory_functions{resource}
+  , m_global_functions{resource}
+  , m_service_store{resource}
+  , m_typed_key_slots{resource}
+  , m_trace_recorder{parent.GetTraceRecorder()}
+  , m_deferred_instances{resource}
+  , m_deferred_count{0}
 {}
 
 ObjectManager::~ObjectManager() = default;
 
+Symbol ObjectManager::Intern(std::string_view name)
+{
+  {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto symbol = m_symbols.Find(name);
+    if (symbol != kInvalidSymbol)
+    {
+      return symbol;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  return m_symbols.Intern(name);
+}
+
+std::string_view ObjectManager::GetSymbolName(Symbol symbol)
+{
+  std::shared_lock<std::shared_mutex> lock{m_mutex};
+  return m_symbols.Name(symbol);
+}
+
+void ObjectManager::SetTraceRecorder(TraceRecorder* recorder) noexcept
+{
+  m_trace_recorder.store(recorder, std::memory_order_release);
+}
+
+std::size_t ObjectManager::GetSymbolCount()
+{
+  std::shared_lock<std::shared_mutex> lock{m_mutex};
+  return m_symbols.Size();
+}
+
+TraceRecorder* ObjectManager::GetTraceRecorder() const noexcept
+{
+  return m_trace_recorder.load(std::memory_order_acquire);
+}
+
+ObjectManager* ObjectManager::GetParent() const noexcept
+{
+  return m_parent;
+}
+
 ErrorCode ObjectManager::CreateInstance(
   const std::string& registered_typename, const std::string& instance_name,
   const std::vector<std::string>& dependency_names)
 {
-  auto it = m_factory_functions.find(registered_typename);
-  if (it == m_factory_functions.end())
+  return Traced("CreateInstance", instance_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto registered_function = FindFactoryFunction(m_symbols.Find(registered_typename));
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kFactoryFunctionNotFound;
+    }
+    auto instance_symbol = m_symbols.Find(instance_name);
+    DependencySymbols dependency_symbols;
+    FindSymbols(dependency_names, dependency_symbols.Get());
+    // Registered functions are never removed, so the pointer stays valid after unlocking
+    lock.unlock();
+    if (instance_symbol == kInvalidSymbol)
+    {
+      // Only new names take the exclusive lock
+      instance_symbol = Intern(instance_name);
+    }
+    return registered_function->create(registered_function->function, *this, instance_symbol,
+                                       dependency_symbols.Get());
+  });
+}
+
+ErrorCode ObjectManager::CreateInstance(Symbol registered_typename, Symbol instance_name,
+                                        const std::vector<Symbol>& dependency_names)
+{
+  return Traced("CreateInstance", instance_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto registered_function = FindFactoryFunction(registered_typename);
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kFactoryFunctionNotFound;
+    }
+    lock.unlock();
+    return registered_function->create(registered_function->function, *this, instance_name,
+                                       dependency_names);
+  });
+}
+
+ErrorCode ObjectManager::CreateInstances(const CreateInstanceRequest* requests,
+                                         std::size_t n_requests, std::vector<ErrorCode>& results,
+                                         bool stop_on_failure)
+{
+  results.assign(n_requests, ErrorCode::kSuccess);
+  std::vector<const RegisteredFactoryFunction*> functions(n_requests, nullptr);
+  // Number of instances per factory function, to pre-size the store for each created type
+  std::vector<std::pair<const RegisteredFactoryFunction*, std::size_t>> reservations;
+  {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    const RegisteredFactoryFunction* registered_function = nullptr;
+    Symbol registered_typename = kInvalidSymbol;
+    for (std::size_t idx = 0; idx < n_requests; ++idx)
+    {
+      const auto& request = requests[idx];
+      // Batches typically contain runs of requests with the same type
+      if (registered_function == nullptr || request.registered_typename != registered_typename)
+      {
+        registered_typename = request.registered_typename;
+        registered_function = FindFactoryFunction(registered_typename);
+      }
+      if (registered_function == nullptr)
+      {
+        results[idx] = ErrorCode::kFactoryFunctionNotFound;
+      }
+      else if (request.dependency_names.size() != registered_function->prepared.n_dependencies)
+      {
+        results[idx] = ErrorCode::kWrongNumberOfDependencies;
+      }
+      else if (!m_symbols.Contains(request.instance_name))
+      {
+        results[idx] = ErrorCode::kInvalidInstanceName;
+      }
+      else
+      {
+        functions[idx] = registered_function;
+        auto it = std::find_if(reservations.rbegin(), reservations.rend(),
+                               [registered_function](const auto& reservation) {
+                                 return reservation.first == registered_function;
+                               });
+        if (it == reservations.rend())
+        {
+          reservations.emplace_back(registered_function, 1);
+        }
+        else
+        {
+          ++it->second;
+        }
+      }
+    }
+  }
+  if (!reservations.empty())
+  {
+    std::unique_lock<std::shared_mutex> lock{m_mutex};
+    for (const auto& [registered_function, count] : reservations)
+    {
+      registered_function->reserve(*this, count);
+    }
+  }
+  auto status = ErrorCode::kSuccess;
+  for (std::size_t idx = 0; idx < n_requests; ++idx)
+  {
+    if (functions[idx] != nullptr)
+    {
+      const auto& request = requests[idx];
+      results[idx] = Traced("CreateInstance", request.instance_name, [&]() {
+        return functions[idx]->create(functions[idx]->function, *this, request.instance_name,
+                                      request.dependency_names);
+      });
+    }
+    if (status == ErrorCode::kSuccess)
+    {
+      status = results[idx];
+      if (stop_on_failure && status != ErrorCode::kSuccess)
+      {
+        results.resize(idx + 1);
+        break;
+      }
+    }
+  }
+  return status;
+}
+
+ErrorCode ObjectManager::CreateInstances(const std::vector<CreateInstanceRequest>& requests,
+                                         std::vector<ErrorCode>& results, bool stop_on_failure)
+{
+  return CreateInstances(requests.data(), requests.size(), results, stop_on_failure);
+}
+
+void ObjectManager::Reserve(std::size_t type_count, std::size_t instance_count)
+{
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  m_service_store.Reserve(type_count, instance_count);
+}
+
+void ObjectManager::ShrinkToFit()
+{
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  m_service_store.ShrinkToFit();
+  m_typed_key_slots.shrink_to_fit();
+}
+
+ErrorCode ObjectManager::DeferCreateInstance(const std::string& registered_typename,
+                                             const std::string& instance_name,
+                                             const std::vector<std::string>& dependency_names)
+{
+  std::vector<Symbol> dependency_symbols;
+  dependency_symbols.reserve(dependency_names.size());
+  for (const auto& name : dependency_names)
+  {
+    dependency_symbols.push_back(Intern(name));
+  }
+  return DeferCreateInstance(Intern(registered_typename), Intern(instance_name),
+                             dependency_symbols);
+}
+
+ErrorCode ObjectManager::DeferCreateInstance(Symbol registered_typename, Symbol instance_name,
+                                             const std::vector<Symbol>& dependency_names)
+{
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  auto registered_function = FindFactoryFunction(registered_typename);
+  if (registered_function == nullptr)
   {
     return ErrorCode::kFactoryFunctionNotFound;
   }
-  return it->second(instance_name, dependency_names);
+  if (dependency_names.size() != registered_function->prepared.n_dependencies)
+  {
+    return ErrorCode::kWrongNumberOfDependencies;
+  }
+  if (!m_symbols.Contains(instance_name) ||
+      m_deferred_instances.find(instance_name) != m_deferred_instances.end() ||
+      registered_function->contains(*this, instance_name))
+  {
+    return ErrorCode::kInvalidInstanceName;
+  }
+  auto deferred = std::make_shared<DeferredInstance>();
+  deferred->registered_typename = registered_typename;
+  deferred->dependency_names = dependency_names;
+  deferred->sequence = next_deferred_sequence++;
+  m_deferred_instances.emplace(instance_name, std::move(deferred));
+  m_deferred_count.store(m_deferred_instances.size(), std::memory_order_release);
+  return ErrorCode::kSuccess;
+}
+
+std::size_t ObjectManager::GetDeferredInstanceCount() const noexcept
+{
+  return m_deferred_count.load(std::memory_order_acquire);
+}
+
+ErrorCode ObjectManager::CreateTransient(InstanceScope* scope,
+                                         const std::string& registered_typename,
+                                         const std::vector<std::string>& dependency_names,
+                                         void* instance, const std::type_info& instance_type)
+{
+  Symbol symbol = kInvalidSymbol;
+  DependencySymbols dependency_symbols;
+  {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    symbol = m_symbols.Find(registered_typename);
+    if (scope == nullptr)
+    {
+      FindSymbols(dependency_names, dependency_symbols.Get());
+    }
+    else
+    {
+      scope->FindSymbols(dependency_names, dependency_symbols.Get());
+    }
+  }
+  return CreateTransient(scope, symbol, dependency_symbols.Get(), instance, instance_type);
+}
+
+ErrorCode ObjectManager::CreateTransient(InstanceScope* scope, Symbol registered_typename,
+                                         internal::SymbolList dependency_names, void* instance,
+                                         const std::type_info& instance_type)
+{
+  return Traced("CreateTransient", registered_typename, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto registered_function = FindFactoryFunction(registered_typename);
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kFactoryFunctionNotFound;
+    }
+    if (*registered_function->instance_type != instance_type)
+    {
+      return ErrorCode::kWrongInstanceType;
+    }
+    lock.unlock();
+    return registered_function->create_transient(registered_function->function, *this, scope,
+                                                 dependency_names, instance);
+  });
 }
 
 ErrorCode ObjectManager::CallGlobalFunction(const std::string& registered_function_name,
                                             const std::vector<std::string>& dependency_names)
 {
-  auto it = m_global_functions.find(registered_function_name);
-  if (it == m_global_functions.end())
+  return Traced("CallGlobalFunction", registered_function_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto registered_function = FindGlobalFunction(m_symbols.Find(registered_function_name));
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kGlobalFunctionNotFound;
+    }
+    DependencySymbols dependency_symbols;
+    FindSymbols(dependency_names, dependency_symbols.Get());
+    lock.unlock();
+    return registered_function->call(registered_function->function, *this,
+                                     dependency_symbols.Get());
+  });
+}
+
+ErrorCode ObjectManager::CallGlobalFunction(Symbol registered_function_name,
+                                            const std::vector<Symbol>& dependency_names)
+{
+  return Traced("CallGlobalFunction", registered_function_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto registered_function = FindGlobalFunction(registered_function_name);
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kGlobalFunctionNotFound;
+    }
+    lock.unlock();
+    return registered_function->call(registered_function->function, *this, dependency_names);
+  });
+}
+
+ErrorCode ObjectManager::PrepareCreateInstance(const std::string& registered_typename,
+                                               const std::string& instance_name,
+                                               const std::vector<std::string>& dependency_names,
+                                               PreparedCall& prepared_call)
+{
+  std::shared_lock<std::shared_mutex> lock{m_mutex};
+  auto registered_function = FindFactoryFunction(m_symbols.Find(registered_typename));
+  if (registered_function == nullptr)
+  {
+    return ErrorCode::kFactoryFunctionNotFound;
+  }
+  auto instance_symbol = m_symbols.Find(instance_name);
+  if (instance_symbol == kInvalidSymbol)
+  {
+    // Only new names take the exclusive lock
+    lock.unlock();
+    instance_symbol = Intern(instance_name);
+    lock.lock();
+  }
+  DependencySymbols dependency_symbols;
+  FindSymbols(dependency_names, dependency_symbols.Get());
+  auto status =
+    Prepare(registered_function->prepared, instance_symbol, dependency_symbols.Get(),
+            prepared_call);
+  lock.unlock();
+  if (status == ErrorCode::kDependencyNotFound && CreateDeferredInstances(dependency_symbols.Get()))
+  {
+    return PrepareCreateInstance(registered_typename, instance_name, dependency_names,
+                                 prepared_call);
+  }
+  return status;
+}
+
+ErrorCode ObjectManager::PrepareGlobalFunction(const std::string& registered_function_name,
+                                               const std::vector<std::string>& dependency_names,
+                                               PreparedCall& prepared_call)
+{
+  std::shared_lock<std::shared_mutex> lock{m_mutex};
+  auto registered_function = FindGlobalFunction(m_symbols.Find(registered_function_name));
+  if (registered_function == nullptr)
   {
     return ErrorCode::kGlobalFunctionNotFound;
   }
-  return it->second(dependency_names);
+  DependencySymbols dependency_symbols;
+  FindSymbols(dependency_names, dependency_symbols.Get());
+  auto status =
+    Prepare(registered_function->prepared, kInvalidSymbol, dependency_symbols.Get(),
+            prepared_call);
+  lock.unlock();
+  if (status == ErrorCode::kDependencyNotFound && CreateDeferredInstances(dependency_symbols.Get()))
+  {
+    return PrepareGlobalFunction(registered_function_name, dependency_names, prepared_call);
+  }
+  return status;
+}
+
+ErrorCode ObjectManager::Invoke(PreparedCall& prepared_call)
+{
+  if (prepared_call.m_object_manager != this || prepared_call.m_invoker == nullptr)
+  {
+    return ErrorCode::kInvalidPreparedCall;
+  }
+  const auto& invoker = *prepared_call.m_invoker;
+  auto status = invoker.invoke(invoker.function, *this, prepared_call);
+  if (status == ErrorCode::kDependencyNotFound &&
+      CreateDeferredInstances(prepared_call.m_dependency_names))
+  {
+    status = invoker.invoke(invoker.function, *this, prepared_call);
+  }
+  return status;
+}
+
+ErrorCode ObjectManager::GetFactoryFunctionOwnership(const std::string& registered_typename,
+                                                     std::vector<bool>& transfer_ownership)
+{
+  Symbol symbol = kInvalidSymbol;
+  {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    symbol = m_symbols.Find(registered_typename);
+  }
+  return GetFactoryFunctionOwnership(symbol, transfer_ownership);
+}
+
+ErrorCode ObjectManager::GetFactoryFunctionOwnership(Symbol registered_typename,
+                                                     std::vector<bool>& transfer_ownership)
+{
+  std::shared_lock<std::shared_mutex> lock{m_mutex};
+  auto registered_function = FindFactoryFunction(registered_typename);
+  if (registered_function == nullptr)
+  {
+    return ErrorCode::kFactoryFunctionNotFound;
+  }
+  transfer_ownership.assign(
+    registered_function->transfer_ownership,
+    registered_function->transfer_ownership + registered_function->prepared.n_dependencies);
+  return ErrorCode::kSuccess;
+}
+
+const ObjectManager::RegisteredFactoryFunction*
+ObjectManager::FindFactoryFunction(Symbol registered_typename) const
+{
+  for (auto object_manager = this; object_manager != nullptr;
+       object_manager = object_manager->m_parent)
+  {
+    auto it = object_manager->m_factory_functions.find(registered_typename);
+    if (it != object_manager->m_factory_functions.end())
+    {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+const ObjectManager::RegisteredGlobalFunction*
+ObjectManager::FindGlobalFunction(Symbol registered_function_name) const
+{
+  for (auto object_manager = this; object_manager != nullptr;
+       object_manager = object_manager->m_parent)
+  {
+    auto it = object_manager->m_global_functions.find(registered_function_name);
+    if (it != object_manager->m_global_functions.end())
+    {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+std::size_t ObjectManager::GetGeneration() const
+{
+  // Generations only increase, so their sum changes whenever an instance is removed from any
+  // ObjectManager in the chain
+  std::size_t generation = 0;
+  for (auto object_manager = this; object_manager != nullptr;
+       object_manager = object_manager->m_parent)
+  {
+    generation += object_manager->m_service_store.GetGeneration();
+  }
+  return generation;
+}
+
+void ObjectManager::FindSymbols(const std::vector<std::string>& names,
+                                std::pmr::vector<Symbol>& symbols) const
+{
+  symbols.reserve(names.size());
+  for (const auto& name : names)
+  {
+    symbols.push_back(m_symbols.Find(name));
+  }
+}
+
+internal::AbstractInstanceContainer* ObjectManager::FindTypedKeySlot(std::size_t index) const
+{
+  if (index >= m_typed_key_slots.size())
+  {
+    return nullptr;
+  }
+  const auto& slot = m_typed_key_slots[index];
+  if (slot.generation != GetGeneration())
+  {
+    return nullptr;
+  }
+  return slot.container;
+}
+
+ErrorCode ObjectManager::Prepare(const internal::PreparedInvoker& invoker,
+                                 Symbol instance_name,
+                                 internal::SymbolList dependency_names,
+                                 PreparedCall& prepared_call)
+{
+  if (dependency_names.size() != invoker.n_dependencies)
+  {
+    return ErrorCode::kWrongNumberOfDependencies;
+  }
+  PreparedCall result;
+  result.m_object_manager = this;
+  result.m_invoker = &invoker;
+  result.m_instance_name = instance_name;
+  result.m_dependency_names.assign(dependency_names.begin(), dependency_names.end());
+  auto status = ResolvePreparedCall(result);
+  if (status != ErrorCode::kSuccess)
+  {
+    return status;
+  }
+  prepared_call = std::move(result);
+  return ErrorCode::kSuccess;
+}
+
+bool ObjectManager::HasDeferredInstances() const noexcept
+{
+  for (auto object_manager = this; object_manager != nullptr;
+       object_manager = object_manager->m_parent)
+  {
+    if (object_manager->m_deferred_count.load(std::memory_order_acquire) != 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ObjectManager::CreateDeferredInstance(Symbol instance_name)
+{
+  if (m_deferred_count.load(std::memory_order_acquire) == 0)
+  {
+    return m_parent != nullptr && m_parent->CreateDeferredInstance(instance_name);
+  }
+  std::shared_ptr<DeferredInstance> deferred;
+  {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    auto it = m_deferred_instances.find(instance_name);
+    if (it != m_deferred_instances.end())
+    {
+      deferred = it->second;
+    }
+  }
+  if (!deferred)
+  {
+    return m_parent != nullptr && m_parent->CreateDeferredInstance(instance_name);
+  }
+  if (deferred->sequence >= deferred_sequence_limit)
+  {
+    return false;
+  }
+  // Concurrent requests for the same instance wait until the first one created it
+  std::call_once(deferred->created, [this, instance_name, &deferred]() {
+    {
+      DeferredSequenceLimit limit{deferred->sequence};
+      deferred->result =
+        CreateInstance(deferred->registered_typename, instance_name, deferred->dependency_names);
+    }
+    std::unique_lock<std::shared_mutex> lock{m_mutex};
+    m_deferred_instances.erase(instance_name);
+    m_deferred_count.store(m_deferred_instances.size(), std::memory_order_release);
+  });
+  return deferred->result == ErrorCode::kSuccess;
+}
+
+bool ObjectManager::CreateDeferredInstances(internal::SymbolList instance_names)
+{
+  bool created = false;
+  for (auto instance_name : instance_names)
+  {
+    created = CreateDeferredInstance(instance_name) || created;
+  }
+  return created;
+}
+
+std::string ObjectManager::TraceSpanName(const char* call, std::string_view name)
+{
+  std::string span_name{call};
+  span_name.append(" ").append(name);
+  return span_name;
+}
+
+std::string ObjectManager::TraceSpanName(const char* call, Symbol name)
+{
+  return TraceSpanName(call, GetSymbolName(name));
+}
+
+ErrorCode ObjectManager::ResolvePreparedCall(PreparedCall& prepared_call)
+{
+  auto generation = GetGeneration();
+  const auto& dependency_names = prepared_call.m_dependency_names;
+  if (prepared_call.m_invoker->resolve(*this, dependency_names, prepared_call.m_dependencies)
+      != dependency_names.size())
+  {
+    return ErrorCode::kDependencyNotFound;
+  }
+  prepared_call.m_generation = generation;
+  return ErrorCode::kSuccess;
+}
+
+ErrorCode ObjectManager::RefreshPreparedCall(PreparedCall& prepared_call)
+{
+  if (prepared_call.m_generation == GetGeneration())
+  {
+    return ErrorCode::kSuccess;
+  }
+  return ResolvePreparedCall(prepared_call);
+}
+
+InstanceScope::InstanceScope(ObjectManager& object_manager)
+  : m_object_manager{object_manager}
+  , m_buffer{}
+  , m_arena{m_buffer, sizeof(m_buffer)}
+  , m_local_symbols{&m_arena}
+  , m_instances{&m_arena}
+{}
+
+InstanceScope::~InstanceScope()
+{
+  // Later instances may refer to earlier ones
+  while (!m_instances.empty())
+  {
+    m_instances.pop_back();
+  }
+}
+
+ErrorCode InstanceScope::CreateInstance(const std::string& registered_typename,
+                                        const std::string& instance_name,
+                                        const std::vector<std::string>& dependency_names)
+{
+  return m_object_manager.Traced("CreateScopedInstance", instance_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_object_manager.m_mutex};
+    auto registered_function = m_object_manager.FindFactoryFunction(
+      m_object_manager.m_symbols.Find(registered_typename));
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kFactoryFunctionNotFound;
+    }
+    auto instance_symbol = FindSymbol(instance_name);
+    DependencySymbols dependency_symbols;
+    FindSymbols(dependency_names, dependency_symbols.Get());
+    lock.unlock();
+    if (instance_symbol == kInvalidSymbol)
+    {
+      // The scope's symbol table is only used by this scope, so it does not need the lock
+      instance_symbol = static_cast<Symbol>(
+        kLocalSymbolFlag | static_cast<std::uint32_t>(m_local_symbols.Intern(instance_name)));
+    }
+    return registered_function->create_scoped(registered_function->function, *this,
+                                              instance_symbol, dependency_symbols.Get());
+  });
+}
+
+ErrorCode InstanceScope::CreateInstance(Symbol registered_typename, Symbol instance_name,
+                                        const std::vector<Symbol>& dependency_names)
+{
+  return m_object_manager.Traced("CreateScopedInstance", instance_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_object_manager.m_mutex};
+    auto registered_function = m_object_manager.FindFactoryFunction(registered_typename);
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kFactoryFunctionNotFound;
+    }
+    if (!m_object_manager.m_symbols.Contains(instance_name))
+    {
+      return ErrorCode::kInvalidInstanceName;
+    }
+    auto instance_symbol = ToScopeSymbol(instance_name);
+    lock.unlock();
+    return registered_function->create_scoped(registered_function->function, *this,
+                                              instance_symbol, dependency_names);
+  });
+}
+
+ErrorCode InstanceScope::CallGlobalFunction(const std::string& registered_function_name,
+                                            const std::vector<std::string>& dependency_names)
+{
+  return m_object_manager.Traced("CallGlobalFunction", registered_function_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_object_manager.m_mutex};
+    auto registered_function = m_object_manager.FindGlobalFunction(
+      m_object_manager.m_symbols.Find(registered_function_name));
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kGlobalFunctionNotFound;
+    }
+    DependencySymbols dependency_symbols;
+    FindSymbols(dependency_names, dependency_symbols.Get());
+    lock.unlock();
+    return registered_function->call_scoped(registered_function->function, *this,
+                                            dependency_symbols.Get());
+  });
+}
+
+ErrorCode InstanceScope::CallGlobalFunction(Symbol registered_function_name,
+                                            const std::vector<Symbol>& dependency_names)
+{
+  return m_object_manager.Traced("CallGlobalFunction", registered_function_name, [&]() {
+    std::shared_lock<std::shared_mutex> lock{m_object_manager.m_mutex};
+    auto registered_function = m_object_manager.FindGlobalFunction(registered_function_name);
+    if (registered_function == nullptr)
+    {
+      return ErrorCode::kGlobalFunctionNotFound;
+    }
+    lock.unlock();
+    return registered_function->call_scoped(registered_function->function, *this,
+                                            dependency_names);
+  });
+}
+
+std::size_t InstanceScope::GetInstanceCount() const noexcept
+{
+  return m_instances.size();
+}
+
+bool InstanceScope::IsLocalSymbol(Symbol symbol)
+{
+  return symbol != kInvalidSymbol && (static_cast<std::uint32_t>(symbol) & kLocalSymbolFlag) != 0;
+}
+
+Symbol InstanceScope::FindSymbol(std::string_view name) const
+{
+  auto symbol = m_local_symbols.Find(name);
+  if (symbol != kInvalidSymbol)
+  {
+    return static_cast<Symbol>(kLocalSymbolFlag | static_cast<std::uint32_t>(symbol));
+  }
+  return m_object_manager.m_symbols.Find(name);
+}
+
+void InstanceScope::FindSymbols(const std::vector<std::string>& names,
+                                std::pmr::vector<Symbol>& symbols) const
+{
+  symbols.reserve(names.size());
+  for (const auto& name : names)
+  {
+    symbols.push_back(FindSymbol(name));
+  }
+}
+
+Symbol InstanceScope::ToScopeSymbol(Symbol symbol) const
+{
+  // A name can be interned in the ObjectManager after the scope interned it
+  if (m_local_symbols.Size() == 0 || IsLocalSymbol(symbol))
+  {
+    return symbol;
+  }
+  auto local_symbol = m_local_symbols.Find(m_object_manager.m_symbols.Name(symbol));
+  if (local_symbol == kInvalidSymbol)
+  {
+    return symbol;
+  }
+  return static_cast<Symbol>(kLocalSymbolFlag | static_cast<std::uint32_t>(local_symbol));
+}
+
+Symbol InstanceScope::ToManagerSymbol(Symbol symbol) const
+{
+  if (!IsLocalSymbol(symbol))
+  {
+    return symbol;
+  }
+  auto local_symbol = static_cast<Symbol>(static_cast<std::uint32_t>(symbol) & ~kLocalSymbolFlag);
+  return m_object_manager.m_symbols.Find(m_local_symbols.Name(local_symbol));
 }
 
 ObjectManager& GlobalObjectManager() noexcept
 {
   static ObjectManager global_object_manager{};
+  static const bool trace_from_environment = [&]() {
+    if (const char* filename = std::getenv(kTraceFileVariable))
+    {
+      EnableTrace(global_object_manager, filename);
+      return true;
+    }
+    return false;
+  }();
+  (void)trace_from_environment;
   return global_object_manager;
 }
 
+TraceRecorder& TraceGlobalObjectManager(const std::string& filename)
+{
+  return EnableTrace(GlobalObjectManager(), filename);
+}
+
 }  // namespace di
 
 }  // namespace sup
+
+namespace
+{
+sup::di::TraceRecorder& EnableTrace(sup::di::ObjectManager& object_manager,
+                                    const std::string& filename)
+{
+  // Constructed after the global ObjectManager, so it is destroyed before it. The exit handler is
+  // registered after both, so it runs while they are still alive.
+  static sup::di::TraceRecorder recorder{};
+  static std::string trace_filename{};
+  static std::mutex mutex{};
+  static const bool registered = std::atexit([]() {
+    std::lock_guard<std::mutex> lock{mutex};
+    sup::di::GlobalObjectManager().SetTraceRecorder(nullptr);
+    std::ofstream trace_file{trace_filename};
+    recorder.WriteChromeTrace(trace_file);
+  }) == 0;
+  (void)registered;
+  std::lock_guard<std::mutex> lock{mutex};
+  trace_filename = filename;
+  object_manager.SetTraceRecorder(&recorder);
+  return recorder;
+}
+}  // unnamed namespace
@@ -28,16 +28,33 @@
 #include <sup/di/injection_type_traits.h>
 #include <sup/di/ownership_traits.h>
 #include <sup/di/service_store.h>
+#include <sup/di/symbol_table.h>
+#include <sup/di/trace_recorder.h>
 
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 namespace sup
 {
 namespace di
 {
+class ObjectManager;
+class PreparedCall;
+
 namespace internal
 {
 /**
@@ -60,21 +77,304 @@ using InstanceFactoryFunction = std::unique_ptr<ServiceType, Deleter>(*)(Deps...
  */
 template <typename... Deps>
 using GlobalFunction = bool(*)(Deps...);
+
+/**
+ * @brief Lock type to hold on the ObjectManager's mutex while injecting the given dependencies:
+ * exclusive when ownership of one of them is transferred and shared otherwise.
+ */
+template <typename... Deps>
+using DependencyLock = typename std::conditional<AnyTransferOwnership<Deps...>::value,
+                                                 std::unique_lock<std::shared_mutex>,
+                                                 std::shared_lock<std::shared_mutex>>::type;
+
+/**
+ * @brief Collect the injected dependencies in a tuple, so the function that requires them can be
+ * invoked after the lock on the store was released.
+ */
+template <typename... Deps>
+std::tuple<InjectionType<Deps>...> MakeInjectionTuple(InjectionType<Deps>... dependencies)
+{
+  return std::tuple<InjectionType<Deps>...>{
+    std::forward<InjectionType<Deps>>(dependencies)...};
+}
+
+/**
+ * @brief Static flags that indicate for each dependency type if its ownership is transferred.
+ *
+ * @note The first element is a dummy to support empty dependency lists.
+ */
+template <typename... Deps>
+struct DependencyOwnership
+{
+  static constexpr bool value[] = { false, TransferOwnership<Deps>::value... };
+};
+
+/**
+ * @brief Allocate a new unique index for a typed instance key.
+ */
+std::size_t NextTypedKeyIndex();
+
+/**
+ * @brief Unique index of the typed instance key that combines a storage type and a tag type. The
+ * index is allocated on first use and selects the cache slot of that key in every ObjectManager.
+ */
+template <typename Service, typename Tag>
+std::size_t TypedKeyIndex()
+{
+  static const std::size_t index = NextTypedKeyIndex();
+  return index;
+}
+
+/**
+ * @brief Cached instance container for a typed instance key, valid as long as the service store
+ * has the same generation.
+ */
+struct TypedKeySlot
+{
+  AbstractInstanceContainer* container = nullptr;
+  std::size_t generation = 0;
+};
+
+/**
+ * @brief Non-owning view of a list of symbols, so dependency lists in any contiguous container
+ * can be passed to the type erased functions of the ObjectManager without copying.
+ */
+class SymbolList
+{
+public:
+  SymbolList(const Symbol* data, std::size_t size) : m_data{data}, m_size{size} {}
+
+  // Implicit conversion from std::vector<Symbol> and std::pmr::vector<Symbol>
+  template <typename Container>
+  SymbolList(const Container& symbols) : SymbolList(symbols.data(), symbols.size()) {}
+
+  std::size_t size() const { return m_size; }
+  const Symbol& operator[](std::size_t index) const { return m_data[index]; }
+  const Symbol* begin() const { return m_data; }
+  const Symbol* end() const { return m_data + m_size; }
+
+private:
+  const Symbol* m_data;
+  std::size_t m_size;
+};
+
+/**
+ * @brief Type erased pointer to a registered factory or global function. Only the trampolines that
+ * were generated for its signature cast it back to its original type.
+ */
+using ErasedFunction = void (*)();
+
+/**
+ * @brief Trampolines that resolve the dependencies of a registered factory or global function once
+ * and invoke it afterwards with those resolved dependencies.
+ *
+ * @details The resolve function returns the index of the first dependency that could not be
+ * resolved, or the number of dependencies on success. The invoke function calls the registered
+ * function with the prepared call and resolves its dependencies again when needed. Both take the
+ * ObjectManager that resolves the dependencies, which can be a child of the one where the function
+ * was registered.
+ */
+struct PreparedInvoker
+{
+  std::size_t n_dependencies = 0;
+  ErasedFunction function = nullptr;
+  std::size_t (*resolve)(ObjectManager&, SymbolList, ResolvedDependencies&) = nullptr;
+  ErrorCode (*invoke)(ErasedFunction, ObjectManager&, PreparedCall&) = nullptr;
+};
 }  // namespace internal
 
+class InstanceScope;
+
+/**
+ * @brief Opaque handle to a factory or global function call whose registry entry and dependencies
+ * were resolved in advance by an ObjectManager.
+ *
+ * @details A default constructed handle is invalid. Valid handles are obtained from
+ * ObjectManager::PrepareCreateInstance or ObjectManager::PrepareGlobalFunction and can only be
+ * invoked by the same ObjectManager.
+ */
+class PreparedCall
+{
+public:
+  PreparedCall();
+  ~PreparedCall();
+
+  PreparedCall(const PreparedCall& other);
+  PreparedCall(PreparedCall&& other);
+  PreparedCall& operator=(const PreparedCall& other);
+  PreparedCall& operator=(PreparedCall&& other);
+
+private:
+  friend class ObjectManager;
+  const ObjectManager* m_object_manager;
+  const internal::PreparedInvoker* m_invoker;
+  Symbol m_instance_name;
+  std::vector<Symbol> m_dependency_names;
+  internal::ResolvedDependencies m_dependencies;
+  std::size_t m_generation;
+};
+
+/**
+ * @brief Record for the creation of a single instance by ObjectManager::CreateInstances.
+ *
+ * @note The dependency names are a non-owning view: the symbols they refer to need to stay alive
+ * until the batch was executed.
+ */
+struct CreateInstanceRequest
+{
+  Symbol registered_typename;
+  Symbol instance_name;
+  internal::SymbolList dependency_names;
+};
+
 /**
  * @brief Class that manages string-based instantiation of objects and calling of global functions.
+ *
+ * @details All names are interned in a symbol table and instances and registered functions are
+ * stored by symbol. Clients that perform many calls with the same names, e.g. the composer, can
+ * intern the names once and use the overloads that take symbols, which avoid all string hashing
+ * and comparisons. Names are never removed from the symbol table, so each distinct instance name
+ * grows it for the lifetime of the ObjectManager.
+ *
+ * All public methods can be called concurrently. Lookups that do not transfer ownership
+ * share a reader lock, while registration, storing created instances and transfer of ownership
+ * take an exclusive lock. Factory and global functions are always called without holding any
+ * lock, so they can use the ObjectManager themselves.
+ *
+ * Registered factory functions support three instance lifetimes:
+ *   singleton: CreateInstance creates a single instance that is stored under a given name;
+ *   transient: CreateTransient returns a fresh instance to the caller on each call, without
+ *              storing it;
+ *   scoped: InstanceScope::CreateInstance stores the instance in a scope object, which releases
+ *           all its instances together.
+ *
+ * A child ObjectManager holds its own instances and registered functions, and falls back to its
+ * parent for everything it can not find itself. It shares the lock and the symbol table of its
+ * parent, so symbols are valid for the whole family.
+ *
+ * When a TraceRecorder is set, every CreateInstance, CreateTransient, CallGlobalFunction and
+ * ownership transferring GetInstance is recorded as a trace span. Calls made by factory or global
+ * functions on the same thread show up as nested spans.
+ *
+ * @note Pointers obtained from the ObjectManager stay valid after ownership of the instance was
+ * transferred to another object, as long as that object is alive.
  */
 class ObjectManager
 {
-  using RegisteredFactoryFunction =
-    std::function<ErrorCode(const std::string&, const std::vector<std::string>&)>;
-  using RegisteredGlobalFunction = std::function<ErrorCode(const std::vector<std::string>&)>;
+  // Registry entries are the type erased function and the trampolines that were generated for its
+  // signature, which receive it as their first argument. Registered functions are executed on
+  // behalf of the ObjectManager that is passed to them, which can be a child of the one where they
+  // were registered.
+  struct RegisteredFactoryFunction
+  {
+    internal::ErasedFunction function = nullptr;
+    ErrorCode (*create)(internal::ErasedFunction, ObjectManager&, Symbol,
+                        internal::SymbolList) = nullptr;
+    // Create an instance that is stored in the scope instead of the ObjectManager
+    ErrorCode (*create_scoped)(internal::ErasedFunction, InstanceScope&, Symbol,
+                               internal::SymbolList) = nullptr;
+    // Create an instance and move it into the std::unique_ptr pointed to by the last argument,
+    // whose type is instance_type. Dependencies are resolved through the scope when not null.
+    ErrorCode (*create_transient)(internal::ErasedFunction, ObjectManager&, InstanceScope*,
+                                  internal::SymbolList, void*) = nullptr;
+    const std::type_info* instance_type = nullptr;
+    // Pre-size the store for the given number of additional instances
+    void (*reserve)(ObjectManager&, std::size_t) = nullptr;
+    // Check if the ObjectManager itself holds an instance of the created type with the given name
+    bool (*contains)(ObjectManager&, Symbol) = nullptr;
+    internal::PreparedInvoker prepared = {};
+    const bool* transfer_ownership = nullptr;
+  };
+  struct RegisteredGlobalFunction
+  {
+    internal::ErasedFunction function = nullptr;
+    ErrorCode (*call)(internal::ErasedFunction, ObjectManager&, internal::SymbolList) = nullptr;
+    ErrorCode (*call_scoped)(internal::ErasedFunction, InstanceScope&,
+                             internal::SymbolList) = nullptr;
+    internal::PreparedInvoker prepared = {};
+  };
+  static_assert(std::is_trivially_copyable<RegisteredFactoryFunction>::value &&
+                  std::is_trivially_copyable<RegisteredGlobalFunction>::value,
+                "Registry entries only hold plain pointers");
+  // Trampolines for the registry entries of each factory and global function signature
+  template <typename ServiceType, typename Deleter, typename... Deps>
+  struct FactoryTrampolines;
+  template <typename... Deps>
+  struct GlobalFunctionTrampolines;
+  // Store interface that finds instances in an ObjectManager and then in its ancestors. The
+  // caller needs to hold a lock on m_mutex, which is shared by all of them.
+  class ChainedStore
+  {
+  public:
+    using KeyType = Symbol;
+    explicit ChainedStore(ObjectManager& object_manager) : m_object_manager{object_manager} {}
+    template <typename Service>
+    internal::AbstractInstanceContainer* FindInstanceContainer(Symbol instance_name);
+    template <typename Service>
+    void EraseInstance(Symbol instance_name);
+  private:
+    ObjectManager& m_object_manager;
+  };
+  // Store interface that finds instances in a scope and then in its ObjectManager. The caller
+  // needs to hold a lock on m_mutex.
+  class ScopedStore
+  {
+  public:
+    using KeyType = Symbol;
+    explicit ScopedStore(InstanceScope& scope) : m_scope{scope} {}
+    template <typename Service>
+    internal::AbstractInstanceContainer* FindInstanceContainer(Symbol instance_name);
+    template <typename Service>
+    void EraseInstance(Symbol instance_name);
+  private:
+    InstanceScope& m_scope;
+  };
+  struct DeferredInstance;
+  // Lock and symbol table that are only allocated by ObjectManagers without a parent: children use
+  // those of their root
+  struct RootState;
+  struct RootStateDeleter
+  {
+    std::pmr::memory_resource* resource = nullptr;
+    void operator()(RootState* root_state) const;
+  };
+  static std::unique_ptr<RootState, RootStateDeleter> CreateRootState(
+    std::pmr::memory_resource* resource);
 public:
   /**
    * @brief Constructor.
    */
   ObjectManager();
+
+  /**
+   * @brief Construct an ObjectManager that obtains all its bookkeeping memory from the given
+   * memory resource, e.g. a std::pmr::monotonic_buffer_resource that releases everything at once.
+   *
+   * @note The resource needs to outlive the ObjectManager. It is only used while holding an
+   * exclusive lock on the ObjectManager, so it does not need to be thread-safe when it is not
+   * shared.
+   */
+  explicit ObjectManager(std::pmr::memory_resource* resource);
+
+  /**
+   * @brief Construct a child ObjectManager that falls back to the given parent for all instances
+   * and registered functions it does not hold itself.
+   *
+   * @details Instances and functions that are registered or created in the child are only visible
+   * in the child (and its own children) and shadow those of the parent with the same name and
+   * type. Construction and destruction only involve the child's own instances, so a child is a
+   * cheap way to give a session a few private instances on top of a large shared graph.
+   *
+   * Taking ownership of an instance of the parent through the child removes it from the parent.
+   * Shadowing an instance of the parent invalidates the child's cached typed lookups and prepared
+   * calls, so they resolve to the child's instance afterwards.
+   *
+   * @note The parent needs to outlive the child. Since all ObjectManagers of a family share the
+   * lock and symbol table of the root, a child can be used concurrently with its parent and its
+   * siblings and does not allocate a lock or symbol table of its own.
+   */
+  ObjectManager(ObjectManager& parent, std::pmr::memory_resource* resource);
+
   ~ObjectManager();
 
   ObjectManager(const ObjectManager& other) = delete;
@@ -82,6 +382,43 @@ public:
   ObjectManager& operator=(const ObjectManager& other) = delete;
   ObjectManager& operator=(ObjectManager&& other) = delete;
 
+  /**
+   * @brief Return the symbol of the given name, interning it if needed.
+   *
+   * @details Known names are found under the shared lock: only new names take the exclusive lock.
+   *
+   * @note Symbols are only valid for the ObjectManager that returned them.
+   */
+  Symbol Intern(std::string_view name);
+
+  /**
+   * @brief Return the name of a symbol that was returned by Intern or an empty string view for
+   * unknown symbols. The returned view stays valid for the lifetime of the ObjectManager.
+   */
+  std::string_view GetSymbolName(Symbol symbol);
+
+  /**
+   * @brief Return the number of names in the symbol table, e.g. to monitor its growth.
+   */
+  std::size_t GetSymbolCount();
+
+  /**
+   * @brief Record trace spans of all calls in the given recorder, or stop recording when null.
+   *
+   * @note The recorder needs to outlive the ObjectManager or be reset before it is destroyed.
+   */
+  void SetTraceRecorder(TraceRecorder* recorder) noexcept;
+
+  /**
+   * @brief Return the current trace recorder or null when calls are not traced.
+   */
+  TraceRecorder* GetTraceRecorder() const noexcept;
+
+  /**
+   * @brief Return the parent of a child ObjectManager, or null.
+   */
+  ObjectManager* GetParent() const noexcept;
+
   /**
    * @brief Create an instance and store it under the given name.
    *
@@ -95,6 +432,117 @@ public:
                            const std::string& instance_name,
                            const std::vector<std::string>& dependency_names);
 
+  /**
+   * @brief Create an instance and store it under the given name, using interned names.
+   *
+   * @return ErrorCode representing success or a specific failure. An instance symbol that was not
+   * returned by Intern results in ErrorCode::kInvalidInstanceName.
+   */
+  ErrorCode CreateInstance(Symbol registered_typename, Symbol instance_name,
+                           const std::vector<Symbol>& dependency_names);
+
+  /**
+   * @brief Create a batch of instances, in order, using interned names.
+   *
+   * @details All requests are validated up front with a single registry pass, after which the
+   * store is pre-sized for all instances of the batch. A request can depend on instances created
+   * by earlier requests of the same batch. By default, a failing request does not stop the
+   * execution of the ones after it. When stop_on_failure is set, the batch behaves like the same
+   * sequence of CreateInstance calls that stops at the first failure: no request after the failing
+   * one is executed.
+   *
+   * @param requests Contiguous array of requests.
+   * @param n_requests Number of requests.
+   * @param results Output error codes, one for each executed request. When stop_on_failure is set,
+   * it ends with the error code of the failing request.
+   * @param stop_on_failure Do not execute the requests after the first failing one.
+   *
+   * @return ErrorCode::kSuccess when all instances were created, otherwise the error code of the
+   * first failing request. Requests that fail validation return the same error code as
+   * DeferCreateInstance would.
+   */
+  ErrorCode CreateInstances(const CreateInstanceRequest* requests, std::size_t n_requests,
+                            std::vector<ErrorCode>& results, bool stop_on_failure = false);
+
+  /**
+   * @brief Create a batch of instances, in order, using interned names.
+   */
+  ErrorCode CreateInstances(const std::vector<CreateInstanceRequest>& requests,
+                            std::vector<ErrorCode>& results, bool stop_on_failure = false);
+
+  /**
+   * @brief Pre-size the instance store for the given number of instance types and instances, so
+   * populating it does not rehash.
+   *
+   * @details The hint only applies to the next type_count instance types that are stored, so it
+   * does not inflate the maps of types that are first stored long after the reservation.
+   */
+  void Reserve(std::size_t type_count, std::size_t instance_count);
+
+  /**
+   * @brief Release the capacity of the instance store that is not needed for the current
+   * instances, e.g. after startup of a long-running process.
+   */
+  void ShrinkToFit();
+
+  /**
+   * @brief Record the creation of an instance, but only create it when it is first needed.
+   *
+   * @details The instance is created on the first GetInstance of its name or when it is first
+   * injected as a dependency, including through prepared calls. Its own dependencies are resolved
+   * at that time, so deferred instances can depend on other deferred instances. Instances that
+   * are never used are never created.
+   *
+   * To rule out cyclic creation, a deferred instance can only trigger the creation of instances
+   * that were deferred before it.
+   *
+   * @return ErrorCode::kFactoryFunctionNotFound or ErrorCode::kWrongNumberOfDependencies when the
+   * creation could never succeed, ErrorCode::kInvalidInstanceName when the instance name was
+   * already deferred or an instance of the same type was already stored under that name (as
+   * CreateInstance would return), and ErrorCode::kSuccess otherwise. Errors of the actual
+   * creation are reported as a missing instance by the call that needed it.
+   */
+  ErrorCode DeferCreateInstance(const std::string& registered_typename,
+                                const std::string& instance_name,
+                                const std::vector<std::string>& dependency_names);
+
+  /**
+   * @brief Record the creation of an instance, using interned names.
+   */
+  ErrorCode DeferCreateInstance(Symbol registered_typename, Symbol instance_name,
+                                const std::vector<Symbol>& dependency_names);
+
+  /**
+   * @brief Number of deferred instances that were not created yet.
+   */
+  std::size_t GetDeferredInstanceCount() const noexcept;
+
+  /**
+   * @brief Create a new instance that is owned by the caller instead of the ObjectManager.
+   *
+   * @details Each call invokes the factory function, so no instance name or store entry is
+   * involved. This is the cheapest way to create short-lived objects.
+   *
+   * @param registered_typename Name under which the factory function was registered.
+   * @param dependency_names List of instance names that need to be injected as dependencies.
+   * @param instance Output instance. Left untouched on failure.
+   *
+   * @return ErrorCode representing success or a specific failure. When the factory function
+   * creates a different type than the output instance, ErrorCode::kWrongInstanceType is returned.
+   */
+  template <typename ServiceType, typename Deleter>
+  ErrorCode CreateTransient(const std::string& registered_typename,
+                            const std::vector<std::string>& dependency_names,
+                            std::unique_ptr<ServiceType, Deleter>& instance);
+
+  /**
+   * @brief Create a new instance that is owned by the caller, using interned names.
+   */
+  template <typename ServiceType, typename Deleter>
+  ErrorCode CreateTransient(Symbol registered_typename,
+                            const std::vector<Symbol>& dependency_names,
+                            std::unique_ptr<ServiceType, Deleter>& instance);
+
   /**
    * @brief Call a global function on the named instances.
    *
@@ -106,6 +554,78 @@ public:
   ErrorCode CallGlobalFunction(const std::string& registered_function_name,
                                const std::vector<std::string>& dependency_names);
 
+  /**
+   * @brief Call a global function on the named instances, using interned names.
+   *
+   * @return ErrorCode representing success or a specific failure.
+   */
+  ErrorCode CallGlobalFunction(Symbol registered_function_name,
+                               const std::vector<Symbol>& dependency_names);
+
+  /**
+   * @brief Prepare the creation of an instance, so it can be invoked repeatedly without any
+   * lookup of the factory function or the dependencies.
+   *
+   * @param registered_typename Name under which the factory function was registered.
+   * @param instance_name Name under which to store the created instance.
+   * @param dependency_names List of instance names that need to be injected as dependencies.
+   * @param prepared_call Handle that is set on success and left untouched otherwise.
+   *
+   * @return ErrorCode representing success or a specific failure.
+   */
+  ErrorCode PrepareCreateInstance(const std::string& registered_typename,
+                                  const std::string& instance_name,
+                                  const std::vector<std::string>& dependency_names,
+                                  PreparedCall& prepared_call);
+
+  /**
+   * @brief Prepare the call of a global function, so it can be invoked repeatedly without any
+   * lookup of the function or the dependencies.
+   *
+   * @param registered_function_name Name under which the global function was registered.
+   * @param dependency_names List of instance names that need to be injected as dependencies.
+   * @param prepared_call Handle that is set on success and left untouched otherwise.
+   *
+   * @return ErrorCode representing success or a specific failure.
+   */
+  ErrorCode PrepareGlobalFunction(const std::string& registered_function_name,
+                                  const std::vector<std::string>& dependency_names,
+                                  PreparedCall& prepared_call);
+
+  /**
+   * @brief Invoke a prepared instance creation or global function call.
+   *
+   * @details The resolved dependencies are reused as long as no instance was removed from the
+   * ObjectManager (by transfer of ownership). Otherwise, the dependencies are resolved again and
+   * ErrorCode::kDependencyNotFound is returned if one of them is no longer available.
+   *
+   * @note Different handles can be invoked concurrently, but a single handle can not.
+   *
+   * @param prepared_call Handle obtained from this ObjectManager.
+   *
+   * @return ErrorCode representing success or a specific failure.
+   */
+  ErrorCode Invoke(PreparedCall& prepared_call);
+
+  /**
+   * @brief Retrieve for each dependency of a registered factory function if its ownership is
+   * transferred to the created instance.
+   *
+   * @param registered_typename Name under which the factory function was registered.
+   * @param transfer_ownership Output flags, one for each dependency. Left untouched on failure.
+   *
+   * @return ErrorCode representing success or a specific failure.
+   */
+  ErrorCode GetFactoryFunctionOwnership(const std::string& registered_typename,
+                                        std::vector<bool>& transfer_ownership);
+
+  /**
+   * @brief Retrieve the ownership flags of a factory function's dependencies, using an interned
+   * name.
+   */
+  ErrorCode GetFactoryFunctionOwnership(Symbol registered_typename,
+                                        std::vector<bool>& transfer_ownership);
+
   /**
    * @brief Retrieve instance of specific type and name from the underlying registry.
    *
@@ -119,7 +639,34 @@ public:
    *   std::unique_ptr<T>&& : for transferring ownership out of ObjectManager
    */
   template <typename T>
-  internal::InjectionType<T> GetInstance(const std::string& instance_name);
+  internal::InjectionType<T> GetInstance(std::string_view instance_name);
+
+  /**
+   * @brief Retrieve instance of specific type and interned name from the underlying registry.
+   */
+  template <typename T>
+  internal::InjectionType<T> GetInstance(Symbol instance_name);
+
+  /**
+   * @brief Retrieve instance of specific type by tag type instead of by name.
+   *
+   * @details A tag type is any type with a static member 'name' that is convertible to
+   * std::string_view, e.g.:
+   *
+   *   struct MainLogger { static constexpr const char* name = "MainLogger"; };
+   *
+   * The instance is registered under that name, so it is shared with the string based API and
+   * the composer. After the first lookup, the instance's container is cached in a slot whose index
+   * is fixed per tag and type, so later lookups do not involve any string handling.
+   *
+   * @return Depending on the required transfer of ownership, a pointer or a unique_ptr to the found
+   * instance.
+   *
+   * @throws std::runtime_error when no instance of the given type is registered under the tag's
+   * name.
+   */
+  template <typename T, typename Tag>
+  internal::InjectionType<T> GetInstance();
 
   /**
    * @brief Register a factory function that requires dependencies.
@@ -144,9 +691,21 @@ public:
   template <typename ServiceType>
   bool RegisterInstance(std::unique_ptr<ServiceType>&& instance, const std::string& instance_name);
 
+  /**
+   * @brief Register an instance of an object directly under the name of a tag type.
+   *
+   * @param instance rvalue to unique_ptr to an object.
+   * @return true on successful registration.
+   */
+  template <typename Tag, typename ServiceType>
+  bool RegisterInstance(std::unique_ptr<ServiceType>&& instance);
+
   /**
    * @brief Register an instance of an object directly.
    *
+   * @details The copy is owned by the ObjectManager, while its container is allocated from the
+   * ObjectManager's memory resource.
+   *
    * @param instance object lvalue.
    * @param instance_name Name under which the instance will be registered.
    * @return true on successful registration.
@@ -154,6 +713,14 @@ public:
   template <typename ServiceType>
   bool RegisterInstance(const ServiceType& instance, const std::string& instance_name);
 
+  /**
+   * @brief Register a copy of an object directly under an interned name.
+   *
+   * @return true on successful registration. Fails for symbols that were not returned by Intern.
+   */
+  template <typename ServiceType>
+  bool RegisterInstance(const ServiceType& instance, Symbol instance_name);
+
   /**
    * @brief Register a global function that requires dependencies.
    *
@@ -166,9 +733,195 @@ public:
                               internal::GlobalFunction<Deps...> global_function);
 
 private:
-  std::map<std::string, RegisteredFactoryFunction> m_factory_functions;
-  std::map<std::string, RegisteredGlobalFunction> m_global_functions;
-  internal::ServiceStore<std::string> m_service_store;
+  friend class InstanceScope;
+
+  // Type erased implementation of CreateTransient, for the given scope or none.
+  ErrorCode CreateTransient(InstanceScope* scope, const std::string& registered_typename,
+                            const std::vector<std::string>& dependency_names, void* instance,
+                            const std::type_info& instance_type);
+  ErrorCode CreateTransient(InstanceScope* scope, Symbol registered_typename,
+                            internal::SymbolList dependency_names, void* instance,
+                            const std::type_info& instance_type);
+
+  // All methods below require the caller to hold a (shared) lock on m_mutex.
+  const RegisteredFactoryFunction* FindFactoryFunction(Symbol registered_typename) const;
+  const RegisteredGlobalFunction* FindGlobalFunction(Symbol registered_function_name) const;
+  std::size_t GetGeneration() const;
+  template <typename T>
+  internal::InjectionType<T> GetChainedInstance(Symbol instance_name);
+  ErrorCode Prepare(const internal::PreparedInvoker& invoker, Symbol instance_name,
+                    internal::SymbolList dependency_names, PreparedCall& prepared_call);
+  void FindSymbols(const std::vector<std::string>& names, std::pmr::vector<Symbol>& symbols) const;
+  ErrorCode ResolvePreparedCall(PreparedCall& prepared_call);
+  ErrorCode RefreshPreparedCall(PreparedCall& prepared_call);
+  internal::AbstractInstanceContainer* FindTypedKeySlot(std::size_t index) const;
+  Symbol FindSymbol(std::string_view name) const { return m_symbols.Find(name); }
+  Symbol FindSymbol(Symbol symbol) const { return symbol; }
+
+  // Methods for deferred instances, which require the caller to not hold a lock.
+  bool HasDeferredInstances() const noexcept;
+  bool CreateDeferredInstance(Symbol instance_name);
+  bool CreateDeferredInstances(internal::SymbolList instance_names);
+  template <typename Service, typename Name>
+  void CreateIfDeferred(const Name& instance_name);
+  template <typename... Deps, typename Store>
+  auto TryInvokeWithDependencies(Store&& store, internal::SymbolList dependency_names);
+
+  // Return the result of the function, called inside a trace span when tracing is enabled. The
+  // span's name is only built when tracing, so the untraced path costs a single branch. Names of
+  // symbols are looked up, so the caller can not hold a lock on m_mutex.
+  template <typename Name, typename Function>
+  decltype(auto) Traced(const char* call, const Name& name, Function&& function);
+  std::string TraceSpanName(const char* call, std::string_view name);
+  std::string TraceSpanName(const char* call, Symbol name);
+
+  template <typename ServiceType, typename Deleter>
+  ErrorCode StoreCreatedInstance(std::unique_ptr<ServiceType, Deleter>&& instance,
+                                 Symbol instance_name);
+
+  // Store an instance in this ObjectManager, which requires the caller to hold an exclusive lock
+  // on m_mutex. When it shadows an instance of an ancestor, the generation is changed, since
+  // typed key slots and prepared calls may refer to the shadowed instance.
+  template <typename ServiceType>
+  bool StoreOwnInstance(std::unique_ptr<ServiceType>&& instance, Symbol instance_name);
+
+  ObjectManager* m_parent;
+  std::unique_ptr<RootState, RootStateDeleter> m_root_state;
+  std::shared_mutex& m_mutex;
+  SymbolTable& m_symbols;
+  std::pmr::unordered_map<Symbol, RegisteredFactoryFunction> m_factory_functions;
+  std::pmr::unordered_map<Symbol, RegisteredGlobalFunction> m_global_functions;
+  internal::ServiceStore<Symbol, internal::FlatTypeMap, internal::HashedInstanceMap>
+    m_service_store;
+  std::pmr::vector<internal::TypedKeySlot> m_typed_key_slots;
+  std::atomic<TraceRecorder*> m_trace_recorder;
+  std::pmr::unordered_map<Symbol, std::shared_ptr<DeferredInstance>> m_deferred_instances;
+  // Number of deferred instances, so lookups only need to check them when there are any
+  std::atomic<std::size_t> m_deferred_count;
+};
+
+/**
+ * @brief Scope that owns instances created through it and releases them all together, in reverse
+ * order of creation, when it is destroyed.
+ *
+ * @details Instances are kept in a flat list whose memory comes from an arena owned by the scope,
+ * so creating and releasing a handful of short-lived instances, e.g. per request, does not touch
+ * the maps of the ObjectManager. Dependencies are first looked up in the scope and then in the
+ * ObjectManager, so scoped instances can depend on each other and on instances of the
+ * ObjectManager, but not the other way around.
+ *
+ * Names of scoped instances that are unknown to the ObjectManager are interned in a symbol table
+ * of the scope, so per-request names do not grow the symbol table of the ObjectManager.
+ *
+ * @note A scope is meant to be used by a single thread at a time, while the ObjectManager can be
+ * used concurrently by other threads and scopes. The ObjectManager needs to outlive the scope.
+ */
+class InstanceScope
+{
+public:
+  explicit InstanceScope(ObjectManager& object_manager);
+  ~InstanceScope();
+
+  InstanceScope(const InstanceScope& other) = delete;
+  InstanceScope(InstanceScope&& other) = delete;
+  InstanceScope& operator=(const InstanceScope& other) = delete;
+  InstanceScope& operator=(InstanceScope&& other) = delete;
+
+  /**
+   * @brief Create an instance that is owned by this scope.
+   *
+   * @return ErrorCode representing success or a specific failure. Creating an instance of the same
+   * type and name twice in a scope results in ErrorCode::kInvalidInstanceName.
+   */
+  ErrorCode CreateInstance(const std::string& registered_typename,
+                           const std::string& instance_name,
+                           const std::vector<std::string>& dependency_names);
+
+  /**
+   * @brief Create an instance that is owned by this scope, using interned names.
+   */
+  ErrorCode CreateInstance(Symbol registered_typename, Symbol instance_name,
+                           const std::vector<Symbol>& dependency_names);
+
+  /**
+   * @brief Create a new instance that is owned by the caller, with dependencies from this scope
+   * and the ObjectManager.
+   */
+  template <typename ServiceType, typename Deleter>
+  ErrorCode CreateTransient(const std::string& registered_typename,
+                            const std::vector<std::string>& dependency_names,
+                            std::unique_ptr<ServiceType, Deleter>& instance);
+
+  /**
+   * @brief Call a global function with dependencies from this scope and the ObjectManager.
+   */
+  ErrorCode CallGlobalFunction(const std::string& registered_function_name,
+                               const std::vector<std::string>& dependency_names);
+
+  /**
+   * @brief Call a global function with dependencies from this scope and the ObjectManager, using
+   * interned names.
+   */
+  ErrorCode CallGlobalFunction(Symbol registered_function_name,
+                               const std::vector<Symbol>& dependency_names);
+
+  /**
+   * @brief Retrieve an instance from this scope or, if not found, from the ObjectManager.
+   *
+   * @throws std::runtime_error when no instance of the given type and name was found.
+   */
+  template <typename T>
+  internal::InjectionType<T> GetInstance(std::string_view instance_name);
+
+  /**
+   * @brief Retrieve an instance from this scope or the ObjectManager, using an interned name.
+   */
+  template <typename T>
+  internal::InjectionType<T> GetInstance(Symbol instance_name);
+
+  /**
+   * @brief Number of instances owned by this scope.
+   */
+  std::size_t GetInstanceCount() const noexcept;
+
+private:
+  friend class ObjectManager;
+  struct ScopedInstance
+  {
+    Symbol name;
+    std::type_index type;
+    internal::InstanceContainerPtr container;
+  };
+  // Symbols of the scope's own symbol table have this bit set. The ObjectManager's symbols never
+  // have it, since its table would need to hold billions of names.
+  static constexpr std::uint32_t kLocalSymbolFlag = 0x80000000u;
+  static bool IsLocalSymbol(Symbol symbol);
+
+  // Store interface used for injecting dependencies: the scope's instances shadow those of the
+  // ObjectManager. These methods, and the symbol translations below, require the caller to hold
+  // a (shared) lock on the ObjectManager.
+  template <typename Service>
+  internal::AbstractInstanceContainer* FindInstanceContainer(Symbol instance_name);
+  template <typename Service>
+  void EraseInstance(Symbol instance_name);
+  // Symbol of a name in the scope or, if the scope does not know it, in the ObjectManager
+  Symbol FindSymbol(std::string_view name) const;
+  void FindSymbols(const std::vector<std::string>& names, std::pmr::vector<Symbol>& symbols) const;
+  // Translate a symbol to the one of the same name in the scope or in the ObjectManager
+  Symbol ToScopeSymbol(Symbol symbol) const;
+  Symbol ToManagerSymbol(Symbol symbol) const;
+
+  // Find a scoped instance by a symbol that was translated with ToScopeSymbol
+  template <typename Service>
+  std::size_t FindScopedInstance(Symbol instance_name) const;
+  template <typename ServiceType, typename Deleter>
+  ErrorCode StoreInstance(std::unique_ptr<ServiceType, Deleter>&& instance, Symbol instance_name);
+
+  ObjectManager& m_object_manager;
+  std::byte m_buffer[512];
+  std::pmr::monotonic_buffer_resource m_arena;
+  SymbolTable m_local_symbols;
+  std::pmr::vector<ScopedInstance> m_instances;
 };
 
 /**
@@ -188,46 +941,239 @@ ForwardingInstanceFactoryFunction(internal::ForwardingArgType<Deps>... dependenc
  */
 ObjectManager& GlobalObjectManager() noexcept;
 
+/**
+ * @brief Trace all calls of the global ObjectManager and write them as a Chrome trace-event JSON
+ * file at process exit.
+ *
+ * @details The same is done when the environment variable SUP_DI_TRACE_FILE is set to a filename
+ * before the global ObjectManager is first used. Calling this function again only changes the
+ * filename.
+ *
+ * @return Recorder of the global ObjectManager, which can also be written on demand.
+ */
+TraceRecorder& TraceGlobalObjectManager(const std::string& filename);
+
+template <typename T>
+internal::InjectionType<T> ObjectManager::GetInstance(std::string_view instance_name)
+{
+  auto get_instance = [&]() -> internal::InjectionType<T> {
+    CreateIfDeferred<internal::StorageType<T>>(instance_name);
+    internal::DependencyLock<T> lock{m_mutex};
+    return GetChainedInstance<T>(m_symbols.Find(instance_name));
+  };
+  if constexpr (internal::TransferOwnership<T>::value)
+  {
+    return Traced("TakeOwnership", instance_name, get_instance);
+  }
+  else
+  {
+    return get_instance();
+  }
+}
+
 template <typename T>
-internal::InjectionType<T> ObjectManager::GetInstance(const std::string& instance_name)
+internal::InjectionType<T> ObjectManager::GetInstance(Symbol instance_name)
 {
-  return m_service_store.GetInstance<T>(instance_name);
+  auto get_instance = [&]() -> internal::InjectionType<T> {
+    CreateIfDeferred<internal::StorageType<T>>(instance_name);
+    internal::DependencyLock<T> lock{m_mutex};
+    return GetChainedInstance<T>(instance_name);
+  };
+  if constexpr (internal::TransferOwnership<T>::value)
+  {
+    return Traced("TakeOwnership", instance_name, get_instance);
+  }
+  else
+  {
+    return get_instance();
+  }
 }
 
+template <typename T, typename Tag>
+internal::InjectionType<T> ObjectManager::GetInstance()
+{
+  if constexpr (internal::TransferOwnership<T>::value)
+  {
+    // The instance is removed, so there is nothing to cache
+    return GetInstance<T>(Tag::name);
+  }
+  else
+  {
+    using Service = internal::StorageType<T>;
+    const auto index = internal::TypedKeyIndex<Service, Tag>();
+    {
+      std::shared_lock<std::shared_mutex> lock{m_mutex};
+      if (auto container = FindTypedKeySlot(index))
+      {
+        return internal::ValuePointerToInjectionType<T>::Forward(
+          internal::GetValuePointer<T>(*container));
+      }
+    }
+    CreateIfDeferred<Service>(std::string_view{Tag::name});
+    std::unique_lock<std::shared_mutex> lock{m_mutex};
+    auto container =
+      ChainedStore{*this}.FindInstanceContainer<Service>(m_symbols.Find(Tag::name));
+    if (container == nullptr)
+    {
+      throw std::runtime_error("ObjectManager::GetInstance: no instance registered for tag [" +
+                               std::string{Tag::name} + "]");
+    }
+    if (index >= m_typed_key_slots.size())
+    {
+      m_typed_key_slots.resize(index + 1);
+    }
+    m_typed_key_slots[index] = internal::TypedKeySlot{container, GetGeneration()};
+    return internal::ValuePointerToInjectionType<T>::Forward(
+      internal::GetValuePointer<T>(*container));
+  }
+}
+
+template <typename ServiceType, typename Deleter, typename... Deps>
+struct ObjectManager::FactoryTrampolines
+{
+  using Function = internal::InstanceFactoryFunction<ServiceType, Deleter, Deps...>;
+
+  static ErrorCode Create(internal::ErasedFunction function, ObjectManager& target,
+                          Symbol instance_name, internal::SymbolList dependency_names)
+  {
+    ChainedStore store{target};
+    auto result = target.TryInvokeWithDependencies<Deps...>(store, dependency_names);
+    if (!result.IsSuccess())
+    {
+      return result.GetErrorCode();
+    }
+    // Factory functions that throw std::runtime_error are reported as a missing dependency
+    try
+    {
+      return target.StoreCreatedInstance(
+        std::apply(reinterpret_cast<Function>(function), std::move(result.GetValue())),
+        instance_name);
+    }
+    catch(const std::runtime_error&)
+    {
+      return ErrorCode::kDependencyNotFound;
+    }
+  }
+
+  static ErrorCode CreateScoped(internal::ErasedFunction function, InstanceScope& scope,
+                                Symbol instance_name, internal::SymbolList dependency_names)
+  {
+    ScopedStore store{scope};
+    auto result =
+      scope.m_object_manager.TryInvokeWithDependencies<Deps...>(store, dependency_names);
+    if (!result.IsSuccess())
+    {
+      return result.GetErrorCode();
+    }
+    try
+    {
+      return scope.StoreInstance(
+        std::apply(reinterpret_cast<Function>(function), std::move(result.GetValue())),
+        instance_name);
+    }
+    catch(const std::runtime_error&)
+    {
+      return ErrorCode::kDependencyNotFound;
+    }
+  }
+
+  static ErrorCode CreateTransient(internal::ErasedFunction function, ObjectManager& target,
+                                   InstanceScope* scope, internal::SymbolList dependency_names,
+                                   void* instance)
+  {
+    ChainedStore store{target};
+    auto result = scope == nullptr
+                    ? target.TryInvokeWithDependencies<Deps...>(store, dependency_names)
+                    : target.TryInvokeWithDependencies<Deps...>(ScopedStore{*scope},
+                                                                dependency_names);
+    if (!result.IsSuccess())
+    {
+      return result.GetErrorCode();
+    }
+    try
+    {
+      *static_cast<std::unique_ptr<ServiceType, Deleter>*>(instance) =
+        std::apply(reinterpret_cast<Function>(function), std::move(result.GetValue()));
+    }
+    catch(const std::runtime_error&)
+    {
+      return ErrorCode::kDependencyNotFound;
+    }
+    return ErrorCode::kSuccess;
+  }
+
+  static void Reserve(ObjectManager& target, std::size_t count)
+  {
+    target.m_service_store.ReserveInstances<ServiceType>(count);
+  }
+
+  static bool Contains(ObjectManager& target, Symbol instance_name)
+  {
+    return target.m_service_store.FindInstanceContainer<ServiceType>(instance_name) != nullptr;
+  }
+
+  static std::size_t Resolve(ObjectManager& target, internal::SymbolList dependency_names,
+                             internal::ResolvedDependencies& dependencies)
+  {
+    ChainedStore store{target};
+    return internal::ResolveStoreArgs<Deps...>(store, dependency_names, dependencies);
+  }
+
+  static ErrorCode Invoke(internal::ErasedFunction function, ObjectManager& target,
+                          PreparedCall& prepared_call)
+  {
+    internal::DependencyLock<Deps...> dependency_lock{target.m_mutex};
+    auto status = target.RefreshPreparedCall(prepared_call);
+    if (status != ErrorCode::kSuccess)
+    {
+      return status;
+    }
+    ChainedStore store{target};
+    auto dependencies = internal::InvokeWithResolvedArgs<Deps...>(
+      internal::MakeInjectionTuple<Deps...>, store, prepared_call.m_dependency_names,
+      prepared_call.m_dependencies);
+    dependency_lock.unlock();
+    try
+    {
+      return target.StoreCreatedInstance(
+        std::apply(reinterpret_cast<Function>(function), std::move(dependencies)),
+        prepared_call.m_instance_name);
+    }
+    catch(const std::runtime_error&)
+    {
+      return ErrorCode::kDependencyNotFound;
+    }
+  }
+};
+
 template <typename ServiceType, typename Deleter, typename... Deps>
 bool ObjectManager::RegisterFactoryFunction(
   const std::string& registered_typename,
   internal::InstanceFactoryFunction<ServiceType, Deleter, Deps...> factory_function)
 {
   static_assert(internal::AreLegalDependencyTypes<Deps...>::value, "Using illegal dependency type");
-  if (m_factory_functions.find(registered_typename) != m_factory_functions.end())
+  using Trampolines = FactoryTrampolines<ServiceType, Deleter, Deps...>;
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  auto symbol = m_symbols.Intern(registered_typename);
+  if (m_factory_functions.find(symbol) != m_factory_functions.end())
   {
     throw std::runtime_error("ObjectManager::RegisterFactoryFunction: typename already registered");
   }
-  m_factory_functions[registered_typename] =
-    [this, factory_function](const std::string& instance_name, const std::vector<std::string>& dependency_names)
-    {
-      if (dependency_names.size() != sizeof...(Deps))
-      {
-        return ErrorCode::kWrongNumberOfDependencies;
-      }
-      bool register_success;
-      try
-      {
-        register_success = m_service_store.StoreInstance(
-          internal::InvokeWithStoreArgs<Deps...>(factory_function, m_service_store, dependency_names),
-          instance_name);
-      }
-      catch(const std::runtime_error&)
-      {
-        return ErrorCode::kDependencyNotFound;
-      }
-      if (!register_success)
-      {
-        return ErrorCode::kInvalidInstanceName;
-      }
-      return ErrorCode::kSuccess;
-    };
+  auto& registered_function = m_factory_functions.emplace(
+    std::piecewise_construct, std::forward_as_tuple(symbol),
+    std::forward_as_tuple()).first->second;
+  registered_function.function = reinterpret_cast<internal::ErasedFunction>(factory_function);
+  registered_function.create = &Trampolines::Create;
+  registered_function.create_scoped = &Trampolines::CreateScoped;
+  registered_function.create_transient = &Trampolines::CreateTransient;
+  registered_function.instance_type = &typeid(std::unique_ptr<ServiceType, Deleter>);
+  registered_function.reserve = &Trampolines::Reserve;
+  registered_function.contains = &Trampolines::Contains;
+  registered_function.transfer_ownership = internal::DependencyOwnership<Deps...>::value + 1;
+  registered_function.prepared.n_dependencies = sizeof...(Deps);
+  registered_function.prepared.function = registered_function.function;
+  registered_function.prepared.resolve = &Trampolines::Resolve;
+  registered_function.prepared.invoke = &Trampolines::Invoke;
   return true;
 }
 
@@ -235,52 +1181,397 @@ template <typename ServiceType>
 bool ObjectManager::RegisterInstance(
   std::unique_ptr<ServiceType>&& instance, const std::string& instance_name)
 {
-  return m_service_store.StoreInstance(std::move(instance), instance_name);
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  return StoreOwnInstance(std::move(instance), m_symbols.Intern(instance_name));
+}
+
+template <typename Tag, typename ServiceType>
+bool ObjectManager::RegisterInstance(std::unique_ptr<ServiceType>&& instance)
+{
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  return StoreOwnInstance(std::move(instance), m_symbols.Intern(Tag::name));
 }
 
 template <typename ServiceType>
 bool ObjectManager::RegisterInstance(const ServiceType& instance, const std::string& instance_name)
 {
-  std::unique_ptr<ServiceType> new_instance{new ServiceType{instance}};
-  return RegisterInstance(std::move(new_instance), instance_name);
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  return StoreOwnInstance(std::make_unique<ServiceType>(instance), m_symbols.Intern(instance_name));
+}
+
+template <typename ServiceType>
+bool ObjectManager::RegisterInstance(const ServiceType& instance, Symbol instance_name)
+{
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  return m_symbols.Contains(instance_name) &&
+         StoreOwnInstance(std::make_unique<ServiceType>(instance), instance_name);
+}
+
+template <typename ServiceType, typename Deleter>
+ErrorCode ObjectManager::StoreCreatedInstance(std::unique_ptr<ServiceType, Deleter>&& instance,
+                                              Symbol instance_name)
+{
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  if (!m_symbols.Contains(instance_name) ||
+      !StoreOwnInstance<ServiceType>(std::move(instance), instance_name))
+  {
+    return ErrorCode::kInvalidInstanceName;
+  }
+  return ErrorCode::kSuccess;
+}
+
+template <typename ServiceType>
+bool ObjectManager::StoreOwnInstance(std::unique_ptr<ServiceType>&& instance,
+                                     Symbol instance_name)
+{
+  const bool shadowing =
+    m_parent != nullptr &&
+    ChainedStore{*m_parent}.FindInstanceContainer<ServiceType>(instance_name) != nullptr;
+  if (!m_service_store.StoreInstance(std::move(instance), instance_name))
+  {
+    return false;
+  }
+  if (shadowing)
+  {
+    m_service_store.Invalidate();
+  }
+  return true;
 }
 
+template <typename... Deps>
+struct ObjectManager::GlobalFunctionTrampolines
+{
+  using Function = internal::GlobalFunction<Deps...>;
+
+  // Global functions that throw std::runtime_error are reported as a missing dependency
+  template <typename Dependencies>
+  static ErrorCode CallFunction(internal::ErasedFunction function, Dependencies&& dependencies)
+  {
+    bool call_success;
+    try
+    {
+      call_success = std::apply(reinterpret_cast<Function>(function),
+                                std::forward<Dependencies>(dependencies));
+    }
+    catch(const std::runtime_error&)
+    {
+      return ErrorCode::kDependencyNotFound;
+    }
+    if (!call_success)
+    {
+      return ErrorCode::kGlobalFunctionFailed;
+    }
+    return ErrorCode::kSuccess;
+  }
+
+  template <typename Store>
+  static ErrorCode CallWithStore(internal::ErasedFunction function, ObjectManager& target,
+                                 Store& store, internal::SymbolList dependency_names)
+  {
+    auto result = target.TryInvokeWithDependencies<Deps...>(store, dependency_names);
+    if (!result.IsSuccess())
+    {
+      return result.GetErrorCode();
+    }
+    return CallFunction(function, std::move(result.GetValue()));
+  }
+
+  static ErrorCode Call(internal::ErasedFunction function, ObjectManager& target,
+                        internal::SymbolList dependency_names)
+  {
+    ChainedStore store{target};
+    return CallWithStore(function, target, store, dependency_names);
+  }
+
+  static ErrorCode CallScoped(internal::ErasedFunction function, InstanceScope& scope,
+                              internal::SymbolList dependency_names)
+  {
+    ScopedStore store{scope};
+    return CallWithStore(function, scope.m_object_manager, store, dependency_names);
+  }
+
+  static std::size_t Resolve(ObjectManager& target, internal::SymbolList dependency_names,
+                             internal::ResolvedDependencies& dependencies)
+  {
+    ChainedStore store{target};
+    return internal::ResolveStoreArgs<Deps...>(store, dependency_names, dependencies);
+  }
+
+  static ErrorCode Invoke(internal::ErasedFunction function, ObjectManager& target,
+                          PreparedCall& prepared_call)
+  {
+    internal::DependencyLock<Deps...> dependency_lock{target.m_mutex};
+    auto status = target.RefreshPreparedCall(prepared_call);
+    if (status != ErrorCode::kSuccess)
+    {
+      return status;
+    }
+    ChainedStore store{target};
+    auto dependencies = internal::InvokeWithResolvedArgs<Deps...>(
+      internal::MakeInjectionTuple<Deps...>, store, prepared_call.m_dependency_names,
+      prepared_call.m_dependencies);
+    dependency_lock.unlock();
+    return CallFunction(function, std::move(dependencies));
+  }
+};
+
 template <typename... Deps>
 bool ObjectManager::RegisterGlobalFunction(const std::string& registered_function_name,
                                            internal::GlobalFunction<Deps...> global_function)
 {
   static_assert(internal::AreLegalDependencyTypes<Deps...>::value, "Using illegal dependency type");
-  if (m_global_functions.find(registered_function_name) != m_global_functions.end())
+  using Trampolines = GlobalFunctionTrampolines<Deps...>;
+  std::unique_lock<std::shared_mutex> lock{m_mutex};
+  auto symbol = m_symbols.Intern(registered_function_name);
+  if (m_global_functions.find(symbol) != m_global_functions.end())
   {
     throw std::runtime_error(
       "ObjectManager::RegisterGlobalFunction: function name already registered");
   }
-  m_global_functions[registered_function_name] =
-    [this, global_function](const std::vector<std::string>& dependency_names)
-    {
-      if (dependency_names.size() != sizeof...(Deps))
-      {
-        return ErrorCode::kWrongNumberOfDependencies;
-      }
-      bool call_success;
-      try
-      {
-        call_success =
-          internal::InvokeWithStoreArgs<Deps...>(global_function, m_service_store, dependency_names);
-      }
-      catch(const std::runtime_error&)
-      {
-        return ErrorCode::kDependencyNotFound;
-      }
-      if (!call_success)
-      {
-        return ErrorCode::kGlobalFunctionFailed;
-      }
-      return ErrorCode::kSuccess;
-    };
+  auto& registered_function = m_global_functions.emplace(
+    std::piecewise_construct, std::forward_as_tuple(symbol),
+    std::forward_as_tuple()).first->second;
+  registered_function.function = reinterpret_cast<internal::ErasedFunction>(global_function);
+  registered_function.call = &Trampolines::Call;
+  registered_function.call_scoped = &Trampolines::CallScoped;
+  registered_function.prepared.n_dependencies = sizeof...(Deps);
+  registered_function.prepared.function = registered_function.function;
+  registered_function.prepared.resolve = &Trampolines::Resolve;
+  registered_function.prepared.invoke = &Trampolines::Invoke;
   return true;
 }
 
+template <typename Service, typename Name>
+void ObjectManager::CreateIfDeferred(const Name& instance_name)
+{
+  if (!HasDeferredInstances())
+  {
+    return;
+  }
+  Symbol symbol = kInvalidSymbol;
+  {
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    symbol = FindSymbol(instance_name);
+    if (ChainedStore{*this}.FindInstanceContainer<Service>(symbol) != nullptr)
+    {
+      return;
+    }
+  }
+  CreateDeferredInstance(symbol);
+}
+
+template <typename... Deps, typename Store>
+auto ObjectManager::TryInvokeWithDependencies(Store&& store, internal::SymbolList dependency_names)
+{
+  while (true)
+  {
+    internal::DependencyLock<Deps...> dependency_lock{m_mutex};
+    auto result = internal::TryInvokeWithStoreArgs<Deps...>(internal::MakeInjectionTuple<Deps...>,
+                                                            store, dependency_names);
+    dependency_lock.unlock();
+    // Each successful creation removes a deferred instance, so this loop terminates
+    if (result.GetErrorCode() != ErrorCode::kDependencyNotFound ||
+        !CreateDeferredInstance(dependency_names[result.GetDependencyIndex()]))
+    {
+      return result;
+    }
+  }
+}
+
+template <typename ServiceType, typename Deleter>
+ErrorCode ObjectManager::CreateTransient(const std::string& registered_typename,
+                                         const std::vector<std::string>& dependency_names,
+                                         std::unique_ptr<ServiceType, Deleter>& instance)
+{
+  return CreateTransient(nullptr, registered_typename, dependency_names, &instance,
+                         typeid(std::unique_ptr<ServiceType, Deleter>));
+}
+
+template <typename ServiceType, typename Deleter>
+ErrorCode ObjectManager::CreateTransient(Symbol registered_typename,
+                                         const std::vector<Symbol>& dependency_names,
+                                         std::unique_ptr<ServiceType, Deleter>& instance)
+{
+  return CreateTransient(nullptr, registered_typename, dependency_names, &instance,
+                         typeid(std::unique_ptr<ServiceType, Deleter>));
+}
+
+template <typename ServiceType, typename Deleter>
+ErrorCode InstanceScope::CreateTransient(const std::string& registered_typename,
+                                         const std::vector<std::string>& dependency_names,
+                                         std::unique_ptr<ServiceType, Deleter>& instance)
+{
+  return m_object_manager.CreateTransient(this, registered_typename, dependency_names, &instance,
+                                          typeid(std::unique_ptr<ServiceType, Deleter>));
+}
+
+template <typename T>
+internal::InjectionType<T> InstanceScope::GetInstance(std::string_view instance_name)
+{
+  Symbol symbol = kInvalidSymbol;
+  {
+    std::shared_lock<std::shared_mutex> lock{m_object_manager.m_mutex};
+    symbol = FindSymbol(instance_name);
+  }
+  return GetInstance<T>(symbol);
+}
+
+template <typename T>
+internal::InjectionType<T> InstanceScope::GetInstance(Symbol instance_name)
+{
+  auto scope_symbol = instance_name;
+  auto manager_symbol = instance_name;
+  if (m_local_symbols.Size() != 0)
+  {
+    std::shared_lock<std::shared_mutex> lock{m_object_manager.m_mutex};
+    scope_symbol = ToScopeSymbol(instance_name);
+    manager_symbol = ToManagerSymbol(instance_name);
+  }
+  auto index = FindScopedInstance<internal::StorageType<T>>(scope_symbol);
+  if (index == m_instances.size())
+  {
+    return m_object_manager.GetInstance<T>(manager_symbol);
+  }
+  internal::InjectionType<T> instance = internal::ValuePointerToInjectionType<T>::Forward(
+    internal::GetValuePointer<T>(*m_instances[index].container));
+  if (internal::TransferOwnership<T>::value)
+  {
+    m_instances.erase(m_instances.begin() + index);
+  }
+  return instance;
+}
+
+template <typename Service>
+internal::AbstractInstanceContainer* InstanceScope::FindInstanceContainer(Symbol instance_name)
+{
+  auto index = FindScopedInstance<Service>(ToScopeSymbol(instance_name));
+  if (index == m_instances.size())
+  {
+    return ObjectManager::ChainedStore{m_object_manager}.FindInstanceContainer<Service>(
+      ToManagerSymbol(instance_name));
+  }
+  return m_instances[index].container.get();
+}
+
+template <typename Service>
+void InstanceScope::EraseInstance(Symbol instance_name)
+{
+  auto index = FindScopedInstance<Service>(ToScopeSymbol(instance_name));
+  if (index == m_instances.size())
+  {
+    ObjectManager::ChainedStore{m_object_manager}.EraseInstance<Service>(
+      ToManagerSymbol(instance_name));
+    return;
+  }
+  m_instances.erase(m_instances.begin() + index);
+}
+
+template <typename Service>
+std::size_t InstanceScope::FindScopedInstance(Symbol instance_name) const
+{
+  // Scopes hold few instances, so a linear search beats hashing
+  for (std::size_t index = 0; index < m_instances.size(); ++index)
+  {
+    const auto& scoped_instance = m_instances[index];
+    if (scoped_instance.name == instance_name && scoped_instance.type == typeid(Service))
+    {
+      return index;
+    }
+  }
+  return m_instances.size();
+}
+
+template <typename ServiceType, typename Deleter>
+ErrorCode InstanceScope::StoreInstance(std::unique_ptr<ServiceType, Deleter>&& instance,
+                                       Symbol instance_name)
+{
+  using Container = internal::InstanceContainer<ServiceType, std::default_delete<ServiceType>>;
+  if (instance_name == kInvalidSymbol ||
+      FindScopedInstance<ServiceType>(instance_name) != m_instances.size())
+  {
+    return ErrorCode::kInvalidInstanceName;
+  }
+  auto container = internal::AllocateInstanceContainer<Container>(
+    &m_arena, std::unique_ptr<ServiceType>(std::move(instance)));
+  m_instances.push_back(ScopedInstance{instance_name, typeid(ServiceType), std::move(container)});
+  return ErrorCode::kSuccess;
+}
+
+template <typename T>
+internal::InjectionType<T> ObjectManager::GetChainedInstance(Symbol instance_name)
+{
+  if (m_parent == nullptr)
+  {
+    return m_service_store.GetInstance<T>(instance_name);
+  }
+  ChainedStore store{*this};
+  auto container = store.FindInstanceContainer<internal::StorageType<T>>(instance_name);
+  if (container == nullptr)
+  {
+    throw std::runtime_error("ObjectManager::GetInstance: trying to access unknown instance [" +
+                             std::string{m_symbols.Name(instance_name)} + "]");
+  }
+  return internal::GetResolvedInstance<0, T>(store, internal::SymbolList{&instance_name, 1},
+                                             &container);
+}
+
+template <typename Service>
+internal::AbstractInstanceContainer*
+ObjectManager::ChainedStore::FindInstanceContainer(Symbol instance_name)
+{
+  for (auto object_manager = &m_object_manager; object_manager != nullptr;
+       object_manager = object_manager->m_parent)
+  {
+    auto container =
+      object_manager->m_service_store.template FindInstanceContainer<Service>(instance_name);
+    if (container != nullptr)
+    {
+      return container;
+    }
+  }
+  return nullptr;
+}
+
+template <typename Service>
+void ObjectManager::ChainedStore::EraseInstance(Symbol instance_name)
+{
+  for (auto object_manager = &m_object_manager; object_manager != nullptr;
+       object_manager = object_manager->m_parent)
+  {
+    auto& service_store = object_manager->m_service_store;
+    if (service_store.template FindInstanceContainer<Service>(instance_name) != nullptr)
+    {
+      service_store.template EraseInstance<Service>(instance_name);
+      return;
+    }
+  }
+}
+
+template <typename Service>
+internal::AbstractInstanceContainer*
+ObjectManager::ScopedStore::FindInstanceContainer(Symbol instance_name)
+{
+  return m_scope.FindInstanceContainer<Service>(instance_name);
+}
+
+template <typename Service>
+void ObjectManager::ScopedStore::EraseInstance(Symbol instance_name)
+{
+  m_scope.EraseInstance<Service>(instance_name);
+}
+
+template <typename Name, typename Function>
+decltype(auto) ObjectManager::Traced(const char* call, const Name& name, Function&& function)
+{
+  auto recorder = m_trace_recorder.load(std::memory_order_acquire);
+  if (recorder == nullptr)
+  {
+    return function();
+  }
+  TraceSpan span{recorder, TraceSpanName(call, name), "ObjectManager"};
+  return function();
+}
+
 }  // namespace di
 
 }  // namespace sup
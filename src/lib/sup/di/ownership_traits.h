@@ -50,6 +50,14 @@ template <typename T>
 struct TransferOwnership<std::unique_ptr<T>&&> : public IsLegalDependencyType<std::unique_ptr<T>&&>
 {};
 
+/**
+ * @brief Type trait that indicates if injecting the given list of dependency types requires
+ * transfer of ownership for at least one of them.
+ */
+template <typename... Deps>
+struct AnyTransferOwnership : public std::disjunction<TransferOwnership<Deps>...>
+{};
+
 }  // namespace internal
 
 }  // namespace di
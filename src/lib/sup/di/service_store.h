@@ -23,15 +23,24 @@
 #ifndef SUP_DI_SERVICE_STORE_H_
 #define SUP_DI_SERVICE_STORE_H_
 
+#include <sup/di/flat_type_map.h>
+#include <sup/di/hashed_instance_map.h>
 #include <sup/di/index_sequence.h>
 #include <sup/di/injection_type_traits.h>
 #include <sup/di/instance_container.h>
+#include <sup/di/template_utils.h>
+#include <sup/di/invoke_result.h>
 #include <sup/di/ownership_traits.h>
 #include <sup/di/type_map.h>
 #include <sup/di/type_list.h>
 
+#include <array>
 #include <map>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -43,87 +52,388 @@ namespace internal
 {
 /**
  * @brief InstanceMap maps objects of type Key to AbstractInstanceContainer objects.
+ *
+ * @note The transparent comparator allows lookup with any type that is comparable to Key.
  */
 template <typename Key>
-using InstanceMap = std::map<Key, std::unique_ptr<internal::AbstractInstanceContainer>>;
+using InstanceMap = std::pmr::map<Key, InstanceContainerPtr, std::less<>>;
+
+/**
+ * @brief Type trait to detect maps that can be pre-sized with a reserve method.
+ */
+template <typename Map, typename = void>
+struct HasReserve : std::false_type
+{};
+
+template <typename Map>
+struct HasReserve<Map, VoidT<decltype(std::declval<Map&>().reserve(std::size_t{}))>>
+  : std::true_type
+{};
+
+/**
+ * @brief Type trait to detect maps that can release unused capacity with a shrink_to_fit method.
+ */
+template <typename Map, typename = void>
+struct HasShrinkToFit : std::false_type
+{};
+
+template <typename Map>
+struct HasShrinkToFit<Map, VoidT<decltype(std::declval<Map&>().shrink_to_fit())>>
+  : std::true_type
+{};
+
+/**
+ * @brief Pre-size a map for the given number of entries if it supports this.
+ */
+template <typename Map>
+void ReserveMap(Map& map, std::size_t count)
+{
+  if constexpr (HasReserve<Map>::value)
+  {
+    map.reserve(count);
+  }
+  else
+  {
+    (void)map;
+    (void)count;
+  }
+}
+
+/**
+ * @brief Release the unused capacity of a map if it supports this.
+ */
+template <typename Map>
+void ShrinkMap(Map& map)
+{
+  if constexpr (HasShrinkToFit<Map>::value)
+  {
+    map.shrink_to_fit();
+  }
+  else
+  {
+    (void)map;
+  }
+}
 
 /**
  * @brief ServiceStore is a templated storage map to store and retrieve instances of any type.
  *
+ * @details The TypeMapT template parameter selects the map that is used to find the instances of
+ * a given type: TypeMap (ordered map on std::type_index) or FlatTypeMap (open-addressing hash
+ * table). The InstanceMapT template parameter selects the map that is used to find an instance by
+ * key: InstanceMap (ordered map) or HashedInstanceMap (open-addressing hash table).
+ *
  * @note The class uses type erasure to store the instances as AbstractInstanceContainer objects.
+ * The containers are allocated from a pool owned by the store, which reuses the memory of removed
+ * instances. The instances themselves are always separate heap objects, so pointers to them stay
+ * valid after their ownership was transferred out of the store.
  */
-template <typename Key>
+template <typename Key, template <typename> class TypeMapT = TypeMap,
+          template <typename> class InstanceMapT = InstanceMap>
 class ServiceStore
 {
 public:
-  ServiceStore() : m_typed_instance_map{} {}
+  using KeyType = Key;
+
+  ServiceStore() : ServiceStore(std::pmr::get_default_resource()) {}
+
+  /**
+   * @brief Construct a store that obtains all its memory from the given memory resource.
+   *
+   * @details The resource is used directly for the maps and their keys. Instance containers are
+   * allocated from a pool that uses the resource as its upstream.
+   */
+  explicit ServiceStore(std::pmr::memory_resource* resource)
+    : m_resource{resource}
+    , m_container_pool{resource}
+    , m_typed_instance_map{resource}
+    , m_generation{0}
+    , m_instances_per_type{0}
+    , m_reserved_type_count{0}
+  {}
   ~ServiceStore() = default;
 
+  ServiceStore(const ServiceStore& other) = delete;
+  ServiceStore& operator=(const ServiceStore& other) = delete;
+
   /**
    * @brief Get an object with the correct type and key to inject it in a function or method that
    * has a parameter of Dep.
    *
+   * @param key Key of the instance. Any type that the instance map can compare to Key can be used,
+   * e.g. std::string_view or const char* for std::string keys.
+   *
    * @return An instance of the correct type for injection.
    */
-  template <typename Dep>
-  InjectionType<Dep> GetInstance(const Key& key);
+  template <typename Dep, typename LookupKey>
+  InjectionType<Dep> GetInstance(const LookupKey& key);
 
   /**
    * @brief Store an object with the provided type under the given key.
    *
+   * @param key Key of the instance. Any type from which the instance map can construct a Key can be
+   * used.
+   *
+   * @return True on success. False implies there was already an instance of the given type and key.
+   */
+  template <typename Service, typename StoreKey>
+  bool StoreInstance(std::unique_ptr<Service> instance, const StoreKey& key);
+
+  /**
+   * @brief Store a copy of the provided value under the given key.
+   *
+   * @details The copy is a separate heap object, since its ownership can be transferred later.
+   *
    * @return True on success. False implies there was already an instance of the given type and key.
    */
+  template <typename Service, typename StoreKey>
+  bool StoreValue(const Service& value, const StoreKey& key);
+
+  /**
+   * @brief Pre-size the store for the given number of instance types and instances in total.
+   *
+   * @details The instances are assumed to be spread evenly over the types: the instance maps of
+   * the next type_count types that are stored afterwards are pre-sized for their share. The hint
+   * only applies to this reservation: types stored after those are not pre-sized, and a later call
+   * replaces the hint. Maps that can not be pre-sized (TypeMap and InstanceMap) ignore the hints.
+   */
+  void Reserve(std::size_t type_count, std::size_t instance_count);
+
+  /**
+   * @brief Release the capacity of the maps that is not needed for the current instances and
+   * discard the hints passed to Reserve.
+   *
+   * @note The pool of instance containers keeps the memory of removed instances for reuse.
+   */
+  void ShrinkToFit();
+
+  /**
+   * @brief Prepare the store for the given number of additional instances of the provided type.
+   *
+   * @details Only instance maps that support it (HashedInstanceMap) are pre-sized; for other maps
+   * this only creates the map for the type.
+   */
   template <typename Service>
-  bool StoreInstance(std::unique_ptr<Service> instance, const Key& key);
+  void ReserveInstances(std::size_t count);
+
+  /**
+   * @brief Find the container of the instance with the provided storage type and key.
+   *
+   * @return Pointer to the container or nullptr if there is no such instance.
+   *
+   * @note The returned pointer remains valid until an instance is removed from the store, which
+   * can be detected by a change of the store's generation.
+   */
+  template <typename Service, typename LookupKey>
+  AbstractInstanceContainer* FindInstanceContainer(const LookupKey& key);
+
+  /**
+   * @brief Remove the instance with the provided storage type and key, if present.
+   */
+  template <typename Service, typename LookupKey>
+  void EraseInstance(const LookupKey& key);
+
+  /**
+   * @brief Get the generation of the store. The generation changes each time an instance is
+   * removed from the store or Invalidate is called.
+   */
+  std::size_t GetGeneration() const { return m_generation; }
+
+  /**
+   * @brief Change the generation of the store, so lookups that were cached by the caller are
+   * performed again.
+   */
+  void Invalidate() { ++m_generation; }
 private:
-  TypeMap<InstanceMap<Key>> m_typed_instance_map;
+  std::pmr::memory_resource* m_resource;
+  // The pool must outlive the instance maps, since it provides the memory of the containers
+  std::pmr::unsynchronized_pool_resource m_container_pool;
+  TypeMapT<InstanceMapT<Key>> m_typed_instance_map;
+  std::size_t m_generation;
+  // Capacity for the instance maps of new types and the number of new types it still applies to,
+  // as hinted by Reserve
+  std::size_t m_instances_per_type;
+  std::size_t m_reserved_type_count;
 
   /**
    * @brief Helper method for StoreInstance.
    */
   template <typename Service>
-  InstanceMap<Key>& GetInstanceMap();
+  InstanceMapT<Key>& GetInstanceMap();
+
+  /**
+   * @brief Construct an instance container in the container pool.
+   */
+  template <typename Container, typename Arg>
+  InstanceContainerPtr MakeContainer(Arg&& arg);
 };
 
-template <std::size_t I, typename... Deps, typename Key>
+/**
+ * @brief Helper function template to retrieve a typed value pointer from an instance container
+ * and release its ownership when required.
+ */
+template <typename Dep>
+StorageType<Dep>* GetValuePointer(AbstractInstanceContainer& container)
+{
+  return static_cast<StorageType<Dep>*>(GetInstancePointer(container, TransferOwnership<Dep>{}));
+}
+
+/**
+ * @brief Container pointers for the dependencies of a function, as resolved by ResolveStoreArgs.
+ */
+using ResolvedDependencies = std::vector<AbstractInstanceContainer*>;
+
+template <typename... Deps, typename Store, typename KeyList, std::size_t... I>
+std::size_t ResolveStoreArgsImpl(Store& store, const KeyList& key_list,
+                                 AbstractInstanceContainer** containers,
+                                 IndexSequence<I...> index_sequence)
+{
+  (void)index_sequence; // suppress compiler warnings when index sequence is empty and thus not used
+  const bool transfer[] = { false, TransferOwnership<Deps>::value... };
+  AbstractInstanceContainer* const resolved[] = {
+    nullptr, store.template FindInstanceContainer<StorageType<Deps>>(key_list[I])... };
+  for (std::size_t i = 0; i < sizeof...(Deps); ++i)
+  {
+    containers[i] = resolved[i + 1];
+    if (containers[i] == nullptr)
+    {
+      return i;
+    }
+    // An instance whose ownership is transferred can not be injected a second time
+    for (std::size_t j = 0; j < i; ++j)
+    {
+      if (containers[j] == containers[i] && (transfer[i + 1] || transfer[j + 1]))
+      {
+        return i;
+      }
+    }
+  }
+  return sizeof...(Deps);
+}
+
+/**
+ * @brief Resolve the instance containers for the dependencies of a function without injecting
+ * them.
+ *
+ * @param key_list Keys of the dependencies: any container with size() and operator[], e.g. a
+ * std::vector of keys.
+ *
+ * @return Index of the first dependency that could not be resolved or sizeof...(Deps) on success.
+ */
+template <typename... Deps, typename Store,
+          typename KeyList = std::vector<typename Store::KeyType>>
+std::size_t ResolveStoreArgs(Store& store, const KeyList& key_list,
+                             ResolvedDependencies& containers)
+{
+  containers.resize(sizeof...(Deps));
+  return ResolveStoreArgsImpl<Deps...>(store, key_list, containers.data(),
+                                       MakeIndexSequence<sizeof...(Deps)>{});
+}
+
+template <std::size_t I, typename... Deps, typename Store, typename KeyList>
 InjectionType<NthType<TypeList<Deps...>, I>>
-GetServiceStoreInstance(ServiceStore<Key>& store, const std::vector<Key>& key_list)
+GetResolvedInstance(Store& store, const KeyList& key_list,
+                    AbstractInstanceContainer* const* containers)
 {
-  return store.template GetInstance<NthType<TypeList<Deps...>, I>>(key_list[I]);
+  using Dep = NthType<TypeList<Deps...>, I>;
+  InjectionType<Dep> instance =
+    ValuePointerToInjectionType<Dep>::Forward(GetValuePointer<Dep>(*containers[I]));
+  if (TransferOwnership<Dep>::value)
+  {
+    store.template EraseInstance<StorageType<Dep>>(key_list[I]);
+  }
+  return instance;
 }
 
-template <typename... Deps, typename F, typename Key, std::size_t... I>
-auto InvokeWithStoreArgsImpl(F&& f, ServiceStore<Key>& store, const std::vector<Key>& key_list,
-                             IndexSequence<I...> index_sequence)
+template <typename... Deps, typename F, typename Store, typename KeyList, std::size_t... I>
+auto InvokeWithResolvedArgsImpl(F&& f, Store& store,
+                                const KeyList& key_list,
+                                AbstractInstanceContainer* const* containers,
+                                IndexSequence<I...> index_sequence)
   -> decltype(f(std::declval<InjectionType<Deps>>()...))
 {
   (void)index_sequence; // suppress compiler warnings when index sequence is empty and thus not used
-  return f(GetServiceStoreInstance<I, Deps...>(store, key_list)...);
+  (void)containers;     // idem
+  return f(GetResolvedInstance<I, Deps...>(store, key_list, containers)...);
 }
 
-template <typename... Deps, typename F, typename Key>
-auto InvokeWithStoreArgs(F&& f, ServiceStore<Key>& store, const std::vector<Key>& key_list)
+/**
+ * @brief Invoke a function with dependencies that were resolved before by ResolveStoreArgs.
+ *
+ * @details No lookups are performed, except for removing instances whose ownership was
+ * transferred.
+ *
+ * @note The caller is responsible for checking that the store's generation did not change since
+ * the dependencies were resolved.
+ */
+template <typename... Deps, typename F, typename Store,
+          typename KeyList = std::vector<typename Store::KeyType>>
+auto InvokeWithResolvedArgs(F&& f, Store& store,
+                            const KeyList& key_list,
+                            const ResolvedDependencies& containers)
   -> decltype(f(std::declval<InjectionType<Deps>>()...))
 {
-  return InvokeWithStoreArgsImpl<Deps...>(std::forward<F>(f), store, key_list,
-                                          MakeIndexSequence<sizeof...(Deps)>{});
+  return InvokeWithResolvedArgsImpl<Deps...>(std::forward<F>(f), store, key_list,
+                                             containers.data(),
+                                             MakeIndexSequence<sizeof...(Deps)>{});
 }
 
 /**
- * @brief Helper function template to retrieve a typed value pointer from an instance container
- * and release its ownership when required.
+ * @brief Invoke a function with dependencies retrieved from the store, without throwing
+ * exceptions when dependencies are missing.
+ *
+ * @details All dependencies are resolved before any of them is injected, so a failure leaves the
+ * store untouched.
+ *
+ * @return The function's return value or the error code and index of the offending dependency.
  */
-template <typename Dep>
-StorageType<Dep>* GetValuePointer(AbstractInstanceContainer& container)
+template <typename... Deps, typename F, typename Store,
+          typename KeyList = std::vector<typename Store::KeyType>>
+auto TryInvokeWithStoreArgs(F&& f, Store& store,
+                            const KeyList& key_list)
+  -> InvokeResult<decltype(f(std::declval<InjectionType<Deps>>()...))>
 {
-  return static_cast<StorageType<Dep>*>(GetInstancePointer(container, TransferOwnership<Dep>{}));
+  using ResultType = InvokeResult<decltype(f(std::declval<InjectionType<Deps>>()...))>;
+  if (key_list.size() != sizeof...(Deps))
+  {
+    return ResultType{ErrorCode::kWrongNumberOfDependencies, key_list.size()};
+  }
+  std::array<AbstractInstanceContainer*, sizeof...(Deps)> containers{};
+  auto index = ResolveStoreArgsImpl<Deps...>(store, key_list, containers.data(),
+                                             MakeIndexSequence<sizeof...(Deps)>{});
+  if (index != sizeof...(Deps))
+  {
+    return ResultType{ErrorCode::kDependencyNotFound, index};
+  }
+  return ResultType{InvokeWithResolvedArgsImpl<Deps...>(std::forward<F>(f), store, key_list,
+                                                        containers.data(),
+                                                        MakeIndexSequence<sizeof...(Deps)>{})};
+}
+
+/**
+ * @brief Invoke a function with dependencies retrieved from the store.
+ *
+ * @throws std::runtime_error when a dependency could not be found.
+ */
+template <typename... Deps, typename F, typename Store,
+          typename KeyList = std::vector<typename Store::KeyType>>
+auto InvokeWithStoreArgs(F&& f, Store& store, const KeyList& key_list)
+  -> decltype(f(std::declval<InjectionType<Deps>>()...))
+{
+  auto result = TryInvokeWithStoreArgs<Deps...>(std::forward<F>(f), store, key_list);
+  if (!result.IsSuccess())
+  {
+    throw std::runtime_error("InvokeWithStoreArgs: could not inject dependency with index " +
+                             std::to_string(result.GetDependencyIndex()));
+  }
+  return std::move(result.GetValue());
 }
 
 /**
  * @brief Class that retrieves an instance from an instance map by key and removes it in its
  * destructor if ownership was released.
  */
-template <typename Key, typename Dep>
+template <typename Map, typename Dep>
 class DependencyRetriever
 {
 public:
@@ -132,7 +442,8 @@ public:
    *
    * @throws std::runtime_error when the provided key could not be found in the map.
    */
-  DependencyRetriever(InstanceMap<Key>& instance_map, const Key& key);
+  template <typename LookupKey>
+  DependencyRetriever(Map& instance_map, const LookupKey& key);
 
   /**
    * @brief Destroy the DependencyRetriever object and erase the iterator from the map if ownership
@@ -152,14 +463,15 @@ public:
    */
   InjectionType<Dep> Get();
 private:
-  using iterator = typename InstanceMap<Key>::iterator;
-  InstanceMap<Key>& m_instance_map;
+  using iterator = typename Map::iterator;
+  Map& m_instance_map;
   iterator m_it;
   bool m_retrieved;
 };
 
-template <typename Key, typename Dep>
-DependencyRetriever<Key, Dep>::DependencyRetriever(InstanceMap<Key>& instance_map, const Key& key)
+template <typename Map, typename Dep>
+template <typename LookupKey>
+DependencyRetriever<Map, Dep>::DependencyRetriever(Map& instance_map, const LookupKey& key)
   : m_instance_map{instance_map}
   , m_it{m_instance_map.find(key)}
   , m_retrieved{false}
@@ -170,8 +482,8 @@ DependencyRetriever<Key, Dep>::DependencyRetriever(InstanceMap<Key>& instance_ma
   }
 }
 
-template <typename Key, typename Dep>
-DependencyRetriever<Key, Dep>::~DependencyRetriever()
+template <typename Map, typename Dep>
+DependencyRetriever<Map, Dep>::~DependencyRetriever()
 {
   if (TransferOwnership<Dep>::value && m_retrieved)
   {
@@ -179,8 +491,8 @@ DependencyRetriever<Key, Dep>::~DependencyRetriever()
   }
 }
 
-template <typename Key, typename Dep>
-InjectionType<Dep> DependencyRetriever<Key, Dep>::Get()
+template <typename Map, typename Dep>
+InjectionType<Dep> DependencyRetriever<Map, Dep>::Get()
 {
   if (m_retrieved)
   {
@@ -190,45 +502,147 @@ InjectionType<Dep> DependencyRetriever<Key, Dep>::Get()
   return ValuePointerToInjectionType<Dep>::Forward(GetValuePointer<Dep>(*m_it->second));
 }
 
-template <typename Key>
-template <typename Dep>
-InjectionType<Dep> ServiceStore<Key>::GetInstance(const Key& key)
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+template <typename Dep, typename LookupKey>
+InjectionType<Dep> ServiceStore<Key, TypeMapT, InstanceMapT>::GetInstance(const LookupKey& key)
 {
   auto map_it = m_typed_instance_map.template find<StorageType<Dep>>();
   if (map_it == m_typed_instance_map.end())
   {
     throw std::runtime_error("ServiceStore::GetInstance: accessing unknown service type");
   }
-  DependencyRetriever<Key, Dep> dependency_retriever(map_it->second, key);
+  DependencyRetriever<InstanceMapT<Key>, Dep> dependency_retriever(map_it->second, key);
+  if (TransferOwnership<Dep>::value)
+  {
+    ++m_generation;
+  }
   return dependency_retriever.Get();
 }
 
-template <typename Key>
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+template <typename Service, typename StoreKey>
+bool ServiceStore<Key, TypeMapT, InstanceMapT>::StoreInstance(std::unique_ptr<Service> instance,
+                                                              const StoreKey& key)
+{
+  using Container = InstanceContainer<Service, std::default_delete<Service>>;
+  auto& instance_map = GetInstanceMap<Service>();
+  return instance_map.emplace(key, MakeContainer<Container>(std::move(instance))).second;
+}
+
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+template <typename Service, typename StoreKey>
+bool ServiceStore<Key, TypeMapT, InstanceMapT>::StoreValue(const Service& value,
+                                                           const StoreKey& key)
+{
+  return StoreInstance(std::make_unique<Service>(value), key);
+}
+
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
 template <typename Service>
-bool ServiceStore<Key>::StoreInstance(std::unique_ptr<Service> instance, const Key& key)
+void ServiceStore<Key, TypeMapT, InstanceMapT>::ReserveInstances(std::size_t count)
 {
- auto& instance_map = GetInstanceMap<Service>();
- if (instance_map.find(key) != instance_map.end())
- {
-  return false;
- }
- instance_map[key] = WrapIntoContainer(std::move(instance));
- return true;
+  auto& instance_map = GetInstanceMap<Service>();
+  ReserveMap(instance_map, instance_map.size() + count);
 }
 
-template <typename Key>
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+void ServiceStore<Key, TypeMapT, InstanceMapT>::Reserve(std::size_t type_count,
+                                                        std::size_t instance_count)
+{
+  ReserveMap(m_typed_instance_map, type_count);
+  m_instances_per_type =
+    type_count == 0 ? instance_count : (instance_count + type_count - 1) / type_count;
+  m_reserved_type_count = type_count == 0 ? 1 : type_count;
+}
+
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+void ServiceStore<Key, TypeMapT, InstanceMapT>::ShrinkToFit()
+{
+  ShrinkMap(m_typed_instance_map);
+  for (auto& typed_instance_map : m_typed_instance_map)
+  {
+    ShrinkMap(typed_instance_map.second);
+  }
+  m_instances_per_type = 0;
+  m_reserved_type_count = 0;
+}
+
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+template <typename Service, typename LookupKey>
+AbstractInstanceContainer*
+ServiceStore<Key, TypeMapT, InstanceMapT>::FindInstanceContainer(const LookupKey& key)
+{
+  auto map_it = m_typed_instance_map.template find<Service>();
+  if (map_it == m_typed_instance_map.end())
+  {
+    return nullptr;
+  }
+  auto& instance_map = map_it->second;
+  auto it = instance_map.find(key);
+  if (it == instance_map.end())
+  {
+    return nullptr;
+  }
+  return it->second.get();
+}
+
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+template <typename Service, typename LookupKey>
+void ServiceStore<Key, TypeMapT, InstanceMapT>::EraseInstance(const LookupKey& key)
+{
+  auto map_it = m_typed_instance_map.template find<Service>();
+  if (map_it == m_typed_instance_map.end())
+  {
+    return;
+  }
+  auto& instance_map = map_it->second;
+  auto it = instance_map.find(key);
+  if (it == instance_map.end())
+  {
+    return;
+  }
+  instance_map.erase(it);
+  ++m_generation;
+}
+
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
 template <typename Service>
-InstanceMap<Key>& ServiceStore<Key>::GetInstanceMap()
+InstanceMapT<Key>& ServiceStore<Key, TypeMapT, InstanceMapT>::GetInstanceMap()
 {
   auto it = m_typed_instance_map.template find<Service>();
   if (it == m_typed_instance_map.end())
   {
-    m_typed_instance_map.template put<Service>(InstanceMap<Key>{});
+    m_typed_instance_map.template put<Service>(InstanceMapT<Key>(m_resource));
     it = m_typed_instance_map.template find<Service>();
+    if (m_reserved_type_count > 0)
+    {
+      ReserveMap(it->second, m_instances_per_type);
+      if (--m_reserved_type_count == 0)
+      {
+        m_instances_per_type = 0;
+      }
+    }
   }
   return it->second;
 }
 
+template <typename Key, template <typename> class TypeMapT,
+          template <typename> class InstanceMapT>
+template <typename Container, typename Arg>
+InstanceContainerPtr ServiceStore<Key, TypeMapT, InstanceMapT>::MakeContainer(Arg&& arg)
+{
+  return AllocateInstanceContainer<Container>(&m_container_pool, std::forward<Arg>(arg));
+}
+
 }  // namespace internal
 
 }  // namespace di
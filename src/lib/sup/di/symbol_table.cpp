@@ -0,0 +1,137 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "symbol_table.h"
+
+#include <cstring>
+#include <functional>
+
+namespace
+{
+const std::size_t kInitialSlotCount = 16;
+}  // unnamed namespace
+
+namespace sup
+{
+namespace di
+{
+SymbolTable::SymbolTable()
+  : SymbolTable(std::pmr::get_default_resource())
+{}
+
+SymbolTable::SymbolTable(std::pmr::memory_resource* resource)
+  : m_arena{resource}
+  , m_names{resource}
+  , m_slots{resource}
+{}
+
+SymbolTable::~SymbolTable() = default;
+
+Symbol SymbolTable::Intern(std::string_view name)
+{
+  if (m_slots.empty())
+  {
+    Rehash(kInitialSlotCount);
+  }
+  const auto hash = std::hash<std::string_view>{}(name);
+  auto pos = FindSlot(name, hash);
+  if (m_slots[pos].symbol != kInvalidSymbol)
+  {
+    return m_slots[pos].symbol;
+  }
+  if (2 * (m_names.size() + 1) > m_slots.size())
+  {
+    Rehash(2 * m_slots.size());
+    pos = FindSlot(name, hash);
+  }
+  auto data = static_cast<char*>(m_arena.allocate(name.size() + 1, 1));
+  std::memcpy(data, name.data(), name.size());
+  data[name.size()] = '\0';
+  auto symbol = static_cast<Symbol>(m_names.size());
+  m_names.emplace_back(data, name.size());
+  m_slots[pos] = Slot{hash, symbol};
+  return symbol;
+}
+
+Symbol SymbolTable::Find(std::string_view name) const
+{
+  if (m_slots.empty())
+  {
+    return kInvalidSymbol;
+  }
+  return m_slots[FindSlot(name, std::hash<std::string_view>{}(name))].symbol;
+}
+
+bool SymbolTable::Contains(Symbol symbol) const
+{
+  return static_cast<std::size_t>(symbol) < m_names.size();
+}
+
+std::string_view SymbolTable::Name(Symbol symbol) const
+{
+  return Contains(symbol) ? m_names[static_cast<std::size_t>(symbol)] : std::string_view{};
+}
+
+std::size_t SymbolTable::Size() const
+{
+  return m_names.size();
+}
+
+std::size_t SymbolTable::FindSlot(std::string_view name, std::size_t hash) const
+{
+  const auto mask = m_slots.size() - 1;
+  auto pos = hash & mask;
+  while (m_slots[pos].symbol != kInvalidSymbol)
+  {
+    const auto& slot = m_slots[pos];
+    if (slot.hash == hash && m_names[static_cast<std::size_t>(slot.symbol)] == name)
+    {
+      break;
+    }
+    pos = (pos + 1) & mask;
+  }
+  return pos;
+}
+
+void SymbolTable::Rehash(std::size_t slot_count)
+{
+  std::pmr::vector<Slot> old_slots(slot_count, m_slots.get_allocator());
+  std::swap(m_slots, old_slots);
+  const auto mask = m_slots.size() - 1;
+  for (const auto& slot : old_slots)
+  {
+    if (slot.symbol == kInvalidSymbol)
+    {
+      continue;
+    }
+    auto pos = slot.hash & mask;
+    while (m_slots[pos].symbol != kInvalidSymbol)
+    {
+      pos = (pos + 1) & mask;
+    }
+    m_slots[pos] = slot;
+  }
+}
+
+}  // namespace di
+
+}  // namespace sup
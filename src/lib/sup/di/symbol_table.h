@@ -0,0 +1,116 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_SYMBOL_TABLE_H_
+#define SUP_DI_SYMBOL_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+/**
+ * @brief Compact identifier of an interned name.
+ *
+ * @details Symbols are dense indices into the SymbolTable that created them, so they can be
+ * hashed and compared as integers.
+ */
+enum class Symbol : std::uint32_t {};
+
+/**
+ * @brief Symbol that is never returned by SymbolTable::Intern and denotes an unknown name.
+ */
+constexpr Symbol kInvalidSymbol = static_cast<Symbol>(UINT32_MAX);
+
+/**
+ * @brief Table that interns names, i.e. maps each distinct name to a unique Symbol.
+ *
+ * @details Names are never removed, so symbols and the string views returned by Name stay valid
+ * for the lifetime of the table. The characters of all names are packed in an arena and indexed by
+ * an open-addressing hash table, so interning a name does not require a separate allocation. All
+ * memory is obtained from the memory resource that is passed at construction, and only once the
+ * first name is interned.
+ *
+ * @note The class is not thread-safe: calls to Intern need to be serialized with all other calls.
+ */
+class SymbolTable
+{
+public:
+  SymbolTable();
+  explicit SymbolTable(std::pmr::memory_resource* resource);
+  ~SymbolTable();
+
+  SymbolTable(const SymbolTable& other) = delete;
+  SymbolTable& operator=(const SymbolTable& other) = delete;
+
+  /**
+   * @brief Return the symbol of the given name, adding it to the table if needed.
+   */
+  Symbol Intern(std::string_view name);
+
+  /**
+   * @brief Return the symbol of the given name or kInvalidSymbol if it was not interned.
+   */
+  Symbol Find(std::string_view name) const;
+
+  /**
+   * @brief Check if the given symbol was returned by this table.
+   */
+  bool Contains(Symbol symbol) const;
+
+  /**
+   * @brief Return the name of the given symbol or an empty string view for unknown symbols.
+   */
+  std::string_view Name(Symbol symbol) const;
+
+  /**
+   * @brief Return the number of interned names.
+   */
+  std::size_t Size() const;
+
+private:
+  struct Slot
+  {
+    std::size_t hash = 0;
+    Symbol symbol = kInvalidSymbol;
+  };
+
+  // Return the position of the slot that holds the name or of the empty slot where it belongs
+  std::size_t FindSlot(std::string_view name, std::size_t hash) const;
+  void Rehash(std::size_t slot_count);
+
+  std::pmr::monotonic_buffer_resource m_arena;
+  std::pmr::vector<std::string_view> m_names;
+  std::pmr::vector<Slot> m_slots;
+};
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_SYMBOL_TABLE_H_
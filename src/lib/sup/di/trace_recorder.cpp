@@ -0,0 +1,261 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "trace_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <iomanip>
+#include <map>
+
+#include <unistd.h>
+
+namespace
+{
+struct CategoryTotals
+{
+  std::size_t count = 0;
+  std::uint64_t duration_ns = 0;
+  std::uint64_t cpu_ns = 0;
+  std::size_t allocations = 0;
+};
+
+void WriteJsonString(std::ostream& os, const std::string& str);
+
+double Milliseconds(std::uint64_t ns)
+{
+  return static_cast<double>(ns) / 1e6;
+}
+
+double Microseconds(std::uint64_t ns)
+{
+  return static_cast<double>(ns) / 1e3;
+}
+}  // unnamed namespace
+
+namespace sup
+{
+namespace di
+{
+
+TraceRecorder::TraceRecorder(AllocationCounter allocation_counter)
+  : m_allocation_counter{allocation_counter}
+  , m_origin{std::chrono::steady_clock::now()}
+  , m_mutex{}
+  , m_events{}
+{}
+
+TraceRecorder::~TraceRecorder() = default;
+
+void TraceRecorder::Record(TraceEvent event)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_events.push_back(std::move(event));
+}
+
+std::vector<TraceEvent> TraceRecorder::GetEvents() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_events;
+}
+
+void TraceRecorder::WriteReport(std::ostream& os, std::size_t max_events) const
+{
+  auto events = GetEvents();
+  std::map<std::string, CategoryTotals> totals;
+  for (const auto& event : events)
+  {
+    auto& category_totals = totals[event.category];
+    ++category_totals.count;
+    category_totals.duration_ns += event.duration_ns;
+    category_totals.cpu_ns += event.cpu_ns;
+    category_totals.allocations += event.allocations;
+  }
+  os << std::fixed << std::setprecision(3);
+  os << "Totals per category:" << std::endl;
+  os << std::setw(16) << "category" << std::setw(10) << "count" << std::setw(14) << "wall [ms]"
+     << std::setw(14) << "cpu [ms]" << std::setw(14) << "allocations" << std::endl;
+  for (const auto& [category, category_totals] : totals)
+  {
+    os << std::setw(16) << category << std::setw(10) << category_totals.count
+       << std::setw(14) << Milliseconds(category_totals.duration_ns)
+       << std::setw(14) << Milliseconds(category_totals.cpu_ns)
+       << std::setw(14) << category_totals.allocations << std::endl;
+  }
+  auto n_slowest = std::min(max_events, events.size());
+  std::partial_sort(events.begin(), events.begin() + n_slowest, events.end(),
+                    [](const TraceEvent& lhs, const TraceEvent& rhs)
+                    { return lhs.duration_ns > rhs.duration_ns; });
+  os << "Slowest events:" << std::endl;
+  os << std::setw(14) << "wall [ms]" << std::setw(14) << "cpu [ms]" << std::setw(14)
+     << "allocations" << "  category: name" << std::endl;
+  for (std::size_t idx = 0; idx < n_slowest; ++idx)
+  {
+    const auto& event = events[idx];
+    os << std::setw(14) << Milliseconds(event.duration_ns) << std::setw(14)
+       << Milliseconds(event.cpu_ns) << std::setw(14) << event.allocations << "  "
+       << event.category << ": " << event.name;
+    for (const auto& [key, value] : event.args)
+    {
+      os << " " << key << "=[" << value << "]";
+    }
+    os << std::endl;
+  }
+}
+
+void TraceRecorder::WriteChromeTrace(std::ostream& os) const
+{
+  auto events = GetEvents();
+  const auto pid = static_cast<long>(getpid());
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (std::size_t idx = 0; idx < events.size(); ++idx)
+  {
+    const auto& event = events[idx];
+    os << (idx == 0 ? "\n" : ",\n") << "{\"name\":";
+    WriteJsonString(os, event.name);
+    os << ",\"cat\":";
+    WriteJsonString(os, event.category);
+    os << ",\"ph\":\"X\",\"ts\":" << Microseconds(event.start_ns)
+       << ",\"dur\":" << Microseconds(event.duration_ns) << ",\"pid\":" << pid
+       << ",\"tid\":" << event.thread_id << ",\"args\":{\"cpu_ms\":"
+       << Milliseconds(event.cpu_ns) << ",\"allocations\":" << event.allocations;
+    for (const auto& [key, value] : event.args)
+    {
+      os << ",";
+      WriteJsonString(os, key);
+      os << ":";
+      WriteJsonString(os, value);
+    }
+    os << "}}";
+  }
+  os << "\n]}\n";
+}
+
+std::uint64_t TraceRecorder::WallTime() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - m_origin).count();
+}
+
+std::size_t TraceRecorder::AllocationCount() const
+{
+  return m_allocation_counter != nullptr ? m_allocation_counter() : 0;
+}
+
+TraceSpan::TraceSpan(TraceRecorder* recorder, std::string name, std::string category)
+  : m_recorder{recorder}
+  , m_event{}
+  , m_cpu_start{0}
+  , m_allocations_start{0}
+{
+  if (m_recorder == nullptr)
+  {
+    return;
+  }
+  m_event.name = std::move(name);
+  m_event.category = std::move(category);
+  m_event.thread_id = TraceThreadId();
+  m_allocations_start = m_recorder->AllocationCount();
+  m_cpu_start = ThreadCpuTime();
+  m_event.start_ns = m_recorder->WallTime();
+}
+
+TraceSpan::~TraceSpan()
+{
+  if (m_recorder == nullptr)
+  {
+    return;
+  }
+  m_event.duration_ns = m_recorder->WallTime() - m_event.start_ns;
+  m_event.cpu_ns = ThreadCpuTime() - m_cpu_start;
+  m_event.allocations = m_recorder->AllocationCount() - m_allocations_start;
+  m_recorder->Record(std::move(m_event));
+}
+
+void TraceSpan::AddArgument(std::string key, std::string value)
+{
+  if (m_recorder != nullptr)
+  {
+    m_event.args.emplace_back(std::move(key), std::move(value));
+  }
+}
+
+std::uint64_t ThreadCpuTime()
+{
+  timespec time{};
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+  {
+    return 0;
+  }
+  return static_cast<std::uint64_t>(time.tv_sec) * 1000000000u +
+         static_cast<std::uint64_t>(time.tv_nsec);
+}
+
+std::uint64_t TraceThreadId()
+{
+  static std::atomic<std::uint64_t> next_id{1};
+  thread_local const std::uint64_t id = next_id++;
+  return id;
+}
+
+}  // namespace di
+
+}  // namespace sup
+
+namespace
+{
+void WriteJsonString(std::ostream& os, const std::string& str)
+{
+  os << '"';
+  for (char c : str)
+  {
+    switch (c)
+    {
+    case '"':
+      os << "\\\"";
+      break;
+    case '\\':
+      os << "\\\\";
+      break;
+    case '\n':
+      os << "\\n";
+      break;
+    case '\t':
+      os << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+           << static_cast<int>(c) << std::dec << std::setfill(' ');
+      }
+      else
+      {
+        os << c;
+      }
+    }
+  }
+  os << '"';
+}
+}  // unnamed namespace
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_DI_TRACE_RECORDER_H_
+#define SUP_DI_TRACE_RECORDER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sup
+{
+namespace di
+{
+/**
+ * @brief Timed span of execution, as recorded by a TraceRecorder.
+ */
+struct TraceEvent
+{
+  std::string name = {};
+  std::string category = {};
+  std::vector<std::pair<std::string, std::string>> args = {};
+  // Wall clock start time, relative to the creation of the recorder
+  std::uint64_t start_ns = 0;
+  std::uint64_t duration_ns = 0;
+  // CPU time of the thread that executed the span
+  std::uint64_t cpu_ns = 0;
+  // Number of allocations during the span, or zero if the recorder has no allocation counter
+  std::size_t allocations = 0;
+  std::uint64_t thread_id = 0;
+};
+
+/**
+ * @brief Thread-safe collector of trace events that can write them as a human readable report or
+ * as a Chrome trace-event JSON file, which can be opened in chrome://tracing or Perfetto.
+ */
+class TraceRecorder
+{
+public:
+  /**
+   * @brief Function that returns the total number of allocations so far. The library can not
+   * count allocations itself, since that requires replacing the global operator new in the
+   * executable.
+   */
+  using AllocationCounter = std::size_t (*)();
+
+  explicit TraceRecorder(AllocationCounter allocation_counter = nullptr);
+  ~TraceRecorder();
+
+  TraceRecorder(const TraceRecorder& other) = delete;
+  TraceRecorder& operator=(const TraceRecorder& other) = delete;
+
+  /**
+   * @brief Add a finished event.
+   */
+  void Record(TraceEvent event);
+
+  /**
+   * @brief Retrieve a copy of all events in the order they finished.
+   */
+  std::vector<TraceEvent> GetEvents() const;
+
+  /**
+   * @brief Write a report with the total time per category and the slowest events.
+   */
+  void WriteReport(std::ostream& os, std::size_t max_events = 20) const;
+
+  /**
+   * @brief Write all events in Chrome's trace-event JSON format.
+   */
+  void WriteChromeTrace(std::ostream& os) const;
+
+  /**
+   * @brief Wall clock time in nanoseconds since the creation of the recorder.
+   */
+  std::uint64_t WallTime() const;
+
+  /**
+   * @brief Total number of allocations according to the allocation counter, or zero.
+   */
+  std::size_t AllocationCount() const;
+
+private:
+  AllocationCounter m_allocation_counter;
+  std::chrono::steady_clock::time_point m_origin;
+  mutable std::mutex m_mutex;
+  std::vector<TraceEvent> m_events;
+};
+
+/**
+ * @brief Scoped span that records a TraceEvent covering its lifetime. It does nothing when
+ * constructed with a null recorder.
+ */
+class TraceSpan
+{
+public:
+  TraceSpan(TraceRecorder* recorder, std::string name, std::string category);
+  ~TraceSpan();
+
+  TraceSpan(const TraceSpan& other) = delete;
+  TraceSpan& operator=(const TraceSpan& other) = delete;
+
+  /**
+   * @brief Add an argument that is shown with the event.
+   */
+  void AddArgument(std::string key, std::string value);
+
+private:
+  TraceRecorder* m_recorder;
+  TraceEvent m_event;
+  std::uint64_t m_cpu_start;
+  std::size_t m_allocations_start;
+};
+
+/**
+ * @brief CPU time of the calling thread in nanoseconds.
+ */
+std::uint64_t ThreadCpuTime();
+
+/**
+ * @brief Small, process-unique identifier of the calling thread.
+ */
+std::uint64_t TraceThreadId();
+
+}  // namespace di
+
+}  // namespace sup
+
+#endif  // SUP_DI_TRACE_RECORDER_H_
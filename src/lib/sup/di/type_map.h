@@ -24,6 +24,7 @@
 #define SUP_DI_TYPE_MAP_H_
 
 #include <map>
+#include <memory_resource>
 #include <typeinfo>
 #include <typeindex>
 
@@ -36,16 +37,19 @@ namespace internal
 
 /**
  * @brief Class template for a map whose keys are types instead of values.
+ *
+ * @details All memory is obtained from the memory resource that is passed at construction.
  */
 template <typename Val>
 class TypeMap
 {
-  using Container = std::map<std::type_index, Val>;
+  using Container = std::pmr::map<std::type_index, Val>;
 public:
   using iterator = typename Container::iterator;
   using const_iterator = typename Container::const_iterator;
 
-  TypeMap() : container{} {}
+  TypeMap() : TypeMap(std::pmr::get_default_resource()) {}
+  explicit TypeMap(std::pmr::memory_resource* resource) : container(resource) {}
 
   iterator begin() { return container.begin(); }
   iterator end() { return container.end(); }
@@ -61,7 +65,13 @@ public:
   template <class Key>
   void put(Val &&value)
   {
-    container[TypeId<Key>()] = std::forward<Val>(value);
+    auto it = container.find(TypeId<Key>());
+    if (it != container.end())
+    {
+      it->second = std::forward<Val>(value);
+      return;
+    }
+    container.emplace(TypeId<Key>(), std::forward<Val>(value));
   }
 
   template <class Key>
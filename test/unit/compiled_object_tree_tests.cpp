@@ -0,0 +1,305 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "global_test_objects.h"
+#include "service_wrapper_config.h"
+#include "temporary_file.h"
+
+#include <sup/di-composer-core/compiled_object_tree.h>
+#include <sup/di-composer-core/exceptions.h>
+#include <sup/di/object_manager.h>
+
+#include <sup/xml/tree_data_parser.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace sup::di;
+
+const std::string COMPILED_XML_FILE_NAME = "test_compiled_object_tree.xml";
+const std::string COMPILED_IMAGE_FILE_NAME = "test_compiled_object_tree.img";
+
+const std::string COMPILED_TREE_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0"
+           name="Test configuration file for the SUP dependency injection framework"
+           xmlns:xs="http://www.w3.org/2001/XMLSchema-instance"
+           xs:schemaLocation="http://codac.iter.org/sup/di sup-di.xsd">
+    <StringInstance>
+        <InstanceName>compiled_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <IntegerInstance>
+        <InstanceName>compiled_int_name</InstanceName>
+        <Value>0x2a</Value>
+    </IntegerInstance>
+    <DoubleInstance>
+        <InstanceName>compiled_double_name</InstanceName>
+        <Value>3.14e6</Value>
+    </DoubleInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>compiled_wrapper_name</InstanceName>
+        <Dependency>compiled_str_name</Dependency>
+    </Instance>
+    <CallFunction>
+        <FunctionName>test_literals_positive</FunctionName>
+        <Dependency>compiled_str_name</Dependency>
+        <Dependency>compiled_int_name</Dependency>
+        <Dependency>compiled_double_name</Dependency>
+    </CallFunction>
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>compiled_str_name</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+const std::string COMPILED_LAZY_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <StringInstance>
+        <InstanceName>compiled_lazy_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>compiled_lazy_wrapper_name</InstanceName>
+        <Dependency>compiled_lazy_str_name</Dependency>
+    </Instance>
+</ObjectComposer>
+)RAW";
+
+const std::string COMPILED_FAILING_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <DoubleInstance>
+        <InstanceName>compiled_negative_double_name</InstanceName>
+        <Value>-1.0</Value>
+    </DoubleInstance>
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>compiled_negative_double_name</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+const std::string COMPILED_STOP_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <StringInstance>
+        <InstanceName>compiled_stop_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>compiled_stop_failing_name</InstanceName>
+        <Dependency>compiled_stop_missing_name</Dependency>
+    </Instance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>compiled_stop_later_name</InstanceName>
+        <Dependency>compiled_stop_str_name</Dependency>
+    </Instance>
+</ObjectComposer>
+)RAW";
+
+const std::string COMPILED_INVALID_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <IntegerInstance>
+        <InstanceName>compiled_invalid_int_name</InstanceName>
+        <Value>forty-two</Value>
+    </IntegerInstance>
+</ObjectComposer>
+)RAW";
+
+const std::string COMPILED_LIBRARY_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <LoadLibrary>)RAW" + service_wrapper_config::CMakeLibraryInstallDir() +
+R"RAW(/libservice-wrapper.so</LoadLibrary>
+    <LoadLibrary binding="lazy" nodelete="true">)RAW" +
+service_wrapper_config::CMakeLibraryInstallDir() + R"RAW(/libservice-wrapper.so</LoadLibrary>
+</ObjectComposer>
+)RAW";
+
+class CompiledObjectTreeTest : public ::testing::Test
+{
+protected:
+  CompiledObjectTreeTest();
+  virtual ~CompiledObjectTreeTest();
+
+  static std::string Compile(const std::string& representation);
+
+  // Copy of an image in memory with the alignment of a mapped file
+  static std::vector<std::uint64_t> AlignedCopy(const std::string& image);
+};
+
+TEST_F(CompiledObjectTreeTest, CompileAndExecute)
+{
+  auto image = Compile(COMPILED_TREE_XML);
+  compiled::ImageHeader header{};
+  ASSERT_GE(image.size(), sizeof(header));
+  std::memcpy(&header, image.data(), sizeof(header));
+  EXPECT_EQ(header.version, compiled::kFormatVersion);
+  EXPECT_EQ(header.n_records, 6);
+  EXPECT_EQ(header.n_dependencies, 5);
+
+  // Strings are stored once
+  EXPECT_EQ(header.n_strings, 8);
+
+  auto aligned_image = AlignedCopy(image);
+  EXPECT_NO_THROW(ExecuteCompiledObjectTree(aligned_image.data(), image.size()));
+  auto& global_object_manager = GlobalObjectManager();
+  EXPECT_EQ(global_object_manager.GetInstance<const std::string&>("compiled_str_name"), "Hello");
+  EXPECT_EQ(*global_object_manager.GetInstance<int*>("compiled_int_name"), 42);
+  EXPECT_EQ(*global_object_manager.GetInstance<double*>("compiled_double_name"), 3.14e6);
+  EXPECT_EQ(global_object_manager.GetInstance<test::Test_StringWrapper*>(
+              "compiled_wrapper_name")->GetString(), "Hello");
+
+  // Executing again fails, since the instances already exist
+  EXPECT_THROW(ExecuteCompiledObjectTree(aligned_image.data(), image.size()), RuntimeException);
+}
+
+TEST_F(CompiledObjectTreeTest, FromFile)
+{
+  test::TemporaryTestFile xml_file(COMPILED_XML_FILE_NAME, COMPILED_LAZY_XML);
+  test::TemporaryTestFile image_file(COMPILED_IMAGE_FILE_NAME, "");
+  EXPECT_NO_THROW(CompileObjectTreeFile(COMPILED_XML_FILE_NAME, COMPILED_IMAGE_FILE_NAME));
+  EXPECT_TRUE(IsCompiledObjectTreeFile(COMPILED_IMAGE_FILE_NAME));
+  EXPECT_FALSE(IsCompiledObjectTreeFile(COMPILED_XML_FILE_NAME));
+  EXPECT_FALSE(IsCompiledObjectTreeFile("non_existing_file.img"));
+
+  ComposerOptions options;
+  options.lazy_instances = true;
+  auto& global_object_manager = GlobalObjectManager();
+  auto deferred_count = global_object_manager.GetDeferredInstanceCount();
+  EXPECT_NO_THROW(ExecuteCompiledObjectTreeFromFile(COMPILED_IMAGE_FILE_NAME, options));
+  EXPECT_EQ(global_object_manager.GetDeferredInstanceCount(), deferred_count + 1);
+  EXPECT_EQ(global_object_manager.GetInstance<test::Test_StringWrapper*>(
+              "compiled_lazy_wrapper_name")->GetString(), "Hello");
+  EXPECT_EQ(global_object_manager.GetDeferredInstanceCount(), deferred_count);
+
+  EXPECT_THROW(ExecuteCompiledObjectTreeFromFile("non_existing_file.img"), ParseException);
+  EXPECT_THROW(ExecuteCompiledObjectTreeFromFile(COMPILED_XML_FILE_NAME), ParseException);
+}
+
+TEST_F(CompiledObjectTreeTest, Failures)
+{
+  // Invalid trees are rejected when compiling
+  EXPECT_THROW(Compile(COMPILED_INVALID_XML), ParseException);
+
+  // Failing elements are reported when executing
+  auto image = Compile(COMPILED_FAILING_XML);
+  auto aligned_image = AlignedCopy(image);
+  EXPECT_THROW(ExecuteCompiledObjectTree(aligned_image.data(), image.size()), RuntimeException);
+
+  // Instances after a failing one are not created
+  image = Compile(COMPILED_STOP_XML);
+  aligned_image = AlignedCopy(image);
+  EXPECT_THROW(ExecuteCompiledObjectTree(aligned_image.data(), image.size()), RuntimeException);
+  EXPECT_THROW(GlobalObjectManager().GetInstance<test::Test_StringWrapper*>(
+                 "compiled_stop_later_name"), std::runtime_error);
+}
+
+TEST_F(CompiledObjectTreeTest, LibraryLoadOptions)
+{
+  const auto image = Compile(COMPILED_LIBRARY_XML);
+  auto aligned_image = AlignedCopy(image);
+  auto* bytes = reinterpret_cast<char*>(aligned_image.data());
+  compiled::ImageHeader header{};
+  std::memcpy(&header, bytes, sizeof(header));
+  ASSERT_EQ(header.n_records, 2);
+  std::vector<compiled::ElementRecord> records(header.n_records);
+  auto records_offset = sizeof(header) + header.n_strings * sizeof(compiled::StringEntry);
+  std::memcpy(records.data(), bytes + records_offset, records.size() * sizeof(records[0]));
+  EXPECT_EQ(records[0].kind, compiled::ElementKind::kLoadLibrary);
+  EXPECT_EQ(records[0].value, 0);
+  EXPECT_EQ(records[1].kind, compiled::ElementKind::kLoadLibrary);
+  EXPECT_EQ(records[1].value, compiled::kLazyBinding | compiled::kNoDelete);
+  EXPECT_NO_THROW(ExecuteCompiledObjectTree(bytes, image.size()));
+
+  // Unknown flags
+  records[1].value |= compiled::kLibraryLoadFlags + 1;
+  std::memcpy(bytes + records_offset, records.data(), records.size() * sizeof(records[0]));
+  EXPECT_THROW(ExecuteCompiledObjectTree(bytes, image.size()), ParseException);
+}
+
+TEST_F(CompiledObjectTreeTest, MalformedImages)
+{
+  const auto image = Compile(COMPILED_TREE_XML);
+  auto aligned_image = AlignedCopy(image);
+  auto* bytes = reinterpret_cast<char*>(aligned_image.data());
+
+  // Truncated
+  EXPECT_THROW(ExecuteCompiledObjectTree(bytes, image.size() - 1), ParseException);
+  EXPECT_THROW(ExecuteCompiledObjectTree(bytes, 4), ParseException);
+
+  // Bad magic
+  bytes[0] = 'X';
+  EXPECT_THROW(ExecuteCompiledObjectTree(bytes, image.size()), ParseException);
+  bytes[0] = image[0];
+
+  // Unsupported version
+  compiled::ImageHeader header{};
+  std::memcpy(&header, bytes, sizeof(header));
+  ++header.version;
+  std::memcpy(bytes, &header, sizeof(header));
+  EXPECT_THROW(ExecuteCompiledObjectTree(bytes, image.size()), ParseException);
+  --header.version;
+  std::memcpy(bytes, &header, sizeof(header));
+
+  // String index out of bounds in the first record
+  compiled::ElementRecord record{};
+  auto record_offset = sizeof(header) + header.n_strings * sizeof(compiled::StringEntry);
+  std::memcpy(&record, bytes + record_offset, sizeof(record));
+  record.name = header.n_strings;
+  std::memcpy(bytes + record_offset, &record, sizeof(record));
+  EXPECT_THROW(ExecuteCompiledObjectTree(bytes, image.size()), ParseException);
+
+  // Misaligned
+  std::vector<std::uint64_t> buffer(aligned_image.size() + 1);
+  auto* misaligned = reinterpret_cast<char*>(buffer.data()) + 1;
+  std::memcpy(misaligned, image.data(), image.size());
+  EXPECT_THROW(ExecuteCompiledObjectTree(misaligned, image.size()), ParseException);
+}
+
+CompiledObjectTreeTest::CompiledObjectTreeTest() = default;
+
+CompiledObjectTreeTest::~CompiledObjectTreeTest() = default;
+
+std::string CompiledObjectTreeTest::Compile(const std::string& representation)
+{
+  auto composer_tree = sup::xml::TreeDataFromString(representation);
+  return CompileObjectTree(*composer_tree);
+}
+
+std::vector<std::uint64_t> CompiledObjectTreeTest::AlignedCopy(const std::string& image)
+{
+  std::vector<std::uint64_t> result((image.size() + sizeof(std::uint64_t) - 1) /
+                                    sizeof(std::uint64_t));
+  std::memcpy(result.data(), image.data(), image.size());
+  return result;
+}
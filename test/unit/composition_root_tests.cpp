@@ -27,10 +27,18 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
 using namespace sup::di;
 
 const std::string TEST_FILE_NAME = "test_composition_root.xml";
 
+const std::string TEST_CACHE_DIRECTORY = "test_composition_root_cache";
+
 const std::string COMPOSITION_ROOT_XML =
 R"RAW(<?xml version="1.0" encoding="UTF-8"?>
 <ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0"
@@ -119,11 +127,103 @@ R"RAW(<?xml version="1.0" encoding="UTF-8"?>
 </ObjectComposer>
 )RAW";
 
+const std::string COMPOSITION_CONCURRENT_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0"
+           name="Test configuration file for the SUP dependency injection framework"
+           xmlns:xs="http://www.w3.org/2001/XMLSchema-instance"
+           xs:schemaLocation="http://codac.iter.org/sup/di sup-di.xsd">
+    <StringInstance>
+        <InstanceName>concurrent_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <IntegerInstance>
+        <InstanceName>concurrent_int_name</InstanceName>
+        <Value>42</Value>
+    </IntegerInstance>
+    <DoubleInstance>
+        <InstanceName>concurrent_double_name</InstanceName>
+        <Value>3.14e6</Value>
+    </DoubleInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>concurrent_wrapper_name</InstanceName>
+        <Dependency>concurrent_str_name</Dependency>
+    </Instance>
+    <CallFunction>
+        <FunctionName>test_literals_positive</FunctionName>
+        <Dependency>concurrent_str_name</Dependency>
+        <Dependency>concurrent_int_name</Dependency>
+        <Dependency>concurrent_double_name</Dependency>
+    </CallFunction>
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>concurrent_str_name</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+// Only uses the globally registered instance, so it can be executed repeatedly
+const std::string COMPOSITION_CACHED_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0"
+           name="Test configuration file for the SUP dependency injection framework"
+           xmlns:xs="http://www.w3.org/2001/XMLSchema-instance"
+           xs:schemaLocation="http://codac.iter.org/sup/di sup-di.xsd">
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>test_string</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+const std::string COMPOSITION_CACHED_INVALID_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <CallFunction>
+        <Dependency>test_string</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+// Uses its own names, so it does not depend on the order of the tests
+const std::string COMPOSITION_CONCURRENT_FAIL_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0"
+           name="Test configuration file for the SUP dependency injection framework"
+           xmlns:xs="http://www.w3.org/2001/XMLSchema-instance"
+           xs:schemaLocation="http://codac.iter.org/sup/di sup-di.xsd">
+    <StringInstance>
+        <InstanceName>concurrent_fail_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <IntegerInstance>
+        <InstanceName>concurrent_fail_int_name</InstanceName>
+        <Value>42</Value>
+    </IntegerInstance>
+    <DoubleInstance>
+        <InstanceName>concurrent_fail_double_name</InstanceName>
+        <Value>-3.14e6</Value>
+    </DoubleInstance>
+    <CallFunction>
+        <FunctionName>test_literals_positive</FunctionName>
+        <Dependency>concurrent_fail_str_name</Dependency>
+        <Dependency>concurrent_fail_int_name</Dependency>
+        <Dependency>concurrent_fail_double_name</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
 class CompositionRootTest : public ::testing::Test
 {
 protected:
   CompositionRootTest();
   virtual ~CompositionRootTest();
+
+  void TearDown() override;
+
+  static std::string ReadFile(const std::filesystem::path& path);
+  static std::vector<std::filesystem::path> CacheFiles();
 };
 
 TEST_F(CompositionRootTest, FromString)
@@ -144,6 +244,91 @@ TEST_F(CompositionRootTest, Literals)
                sup::di::RuntimeException);
 }
 
+TEST_F(CompositionRootTest, ConcurrentExecution)
+{
+  ComposerOptions options;
+  options.n_threads = 4;
+  EXPECT_NO_THROW(ExecuteObjectTreeFromString(COMPOSITION_CONCURRENT_XML, options));
+  EXPECT_THROW(ExecuteObjectTreeFromString(COMPOSITION_CONCURRENT_FAIL_XML, options),
+               sup::di::RuntimeException);
+}
+
+TEST_F(CompositionRootTest, CachedFile)
+{
+  ComposerOptions options;
+  options.cache_directory = TEST_CACHE_DIRECTORY;
+  {
+    // Miss: the file is parsed and its image is stored
+    test::TemporaryTestFile file(TEST_FILE_NAME, COMPOSITION_CACHED_XML);
+    EXPECT_NO_THROW(ExecuteObjectTreeFromFile(TEST_FILE_NAME, options));
+    auto cache_files = CacheFiles();
+    ASSERT_EQ(cache_files.size(), 1);
+    auto cache_content = ReadFile(cache_files[0]);
+
+    // Hit: the stored image is executed and not written again, which would update its time
+    const auto old_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    std::filesystem::last_write_time(cache_files[0], old_time);
+    EXPECT_NO_THROW(ExecuteObjectTreeFromFile(TEST_FILE_NAME, options));
+    EXPECT_EQ(CacheFiles(), cache_files);
+    EXPECT_EQ(std::filesystem::last_write_time(cache_files[0]), old_time);
+
+    // Invalid image: falls back to parsing and replaces the image
+    {
+      std::ofstream cache_file{cache_files[0], std::ios::binary | std::ios::trunc};
+      cache_file << "SUPDIIMG corrupted";
+    }
+    EXPECT_NO_THROW(ExecuteObjectTreeFromFile(TEST_FILE_NAME, options));
+    EXPECT_EQ(CacheFiles(), cache_files);
+    EXPECT_EQ(ReadFile(cache_files[0]), cache_content);
+
+    // Valid image stored with other content, e.g. after a hash collision: falls back to parsing
+    // and replaces the image
+    {
+      auto other_content = cache_content;
+      other_content.back() = ' ';
+      std::ofstream cache_file{cache_files[0], std::ios::binary | std::ios::trunc};
+      cache_file << other_content;
+    }
+    std::filesystem::last_write_time(cache_files[0], old_time);
+    EXPECT_NO_THROW(ExecuteObjectTreeFromFile(TEST_FILE_NAME, options));
+    EXPECT_NE(std::filesystem::last_write_time(cache_files[0]), old_time);
+    EXPECT_EQ(ReadFile(cache_files[0]), cache_content);
+  }
+  {
+    // Other content is stored separately, invalid content is not stored
+    test::TemporaryTestFile file(TEST_FILE_NAME, COMPOSITION_CACHED_INVALID_XML);
+    EXPECT_ANY_THROW(ExecuteObjectTreeFromFile(TEST_FILE_NAME, options));
+    EXPECT_EQ(CacheFiles().size(), 1);
+  }
+  {
+    test::TemporaryTestFile file(TEST_FILE_NAME, COMPOSITION_CACHED_XML + "<!-- Changed -->\n");
+    EXPECT_NO_THROW(ExecuteObjectTreeFromFile(TEST_FILE_NAME, options));
+    EXPECT_EQ(CacheFiles().size(), 2);
+  }
+  EXPECT_ANY_THROW(ExecuteObjectTreeFromFile("non_existing_file.xml", options));
+}
+
 CompositionRootTest::CompositionRootTest() = default;
 
 CompositionRootTest::~CompositionRootTest() = default;
+
+void CompositionRootTest::TearDown()
+{
+  std::filesystem::remove_all(TEST_CACHE_DIRECTORY);
+}
+
+std::string CompositionRootTest::ReadFile(const std::filesystem::path& path)
+{
+  std::ifstream file{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+std::vector<std::filesystem::path> CompositionRootTest::CacheFiles()
+{
+  std::vector<std::filesystem::path> result;
+  for (const auto& entry : std::filesystem::directory_iterator{TEST_CACHE_DIRECTORY})
+  {
+    result.push_back(entry.path());
+  }
+  return result;
+}
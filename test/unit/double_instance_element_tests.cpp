@@ -54,7 +54,7 @@ TEST_F(DoubleInstanceElementTest, Construction)
 {
   EXPECT_NO_THROW(DoubleInstanceElement inst_elem{m_double_instance_tree});
   auto constr_it = ElementConstructorMap().find(constants::DOUBLE_INSTANCE_TAG);
-  EXPECT_NO_THROW(constr_it->second(m_double_instance_tree));
+  EXPECT_NO_THROW(constr_it->second(m_double_instance_tree, ComposerOptions{}));
 }
 
 TEST_F(DoubleInstanceElementTest, Validation)
@@ -0,0 +1,178 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/di-composer-core/element_scheduler.h>
+#include <sup/di-composer-core/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace sup::di;
+
+class ElementSchedulerTest : public ::testing::Test
+{
+protected:
+  ElementSchedulerTest();
+  virtual ~ElementSchedulerTest();
+
+  std::size_t AddElement(const ElementAccess& access, bool fail = false);
+  std::size_t ExecutionPosition(std::size_t element_idx) const;
+
+  std::vector<std::unique_ptr<IComposerElement>> m_elements;
+  std::vector<std::size_t> m_execution_order;
+  std::mutex m_mutex;
+};
+
+namespace
+{
+class TestElement : public IComposerElement
+{
+public:
+  TestElement(std::size_t idx, const ElementAccess& access, bool fail,
+              std::vector<std::size_t>& execution_order, std::mutex& mtx)
+    : m_idx{idx}
+    , m_access{access}
+    , m_fail{fail}
+    , m_execution_order{execution_order}
+    , m_mutex{mtx}
+  {}
+  ~TestElement() = default;
+
+  void Execute() override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (m_fail)
+    {
+      throw RuntimeException("TestElement::Execute(): failure of element " +
+                             std::to_string(m_idx));
+    }
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_execution_order.push_back(m_idx);
+  }
+
+  ElementAccess GetAccess() const override
+  {
+    return m_access;
+  }
+
+private:
+  std::size_t m_idx;
+  ElementAccess m_access;
+  bool m_fail;
+  std::vector<std::size_t>& m_execution_order;
+  std::mutex& m_mutex;
+};
+
+std::vector<Symbol> Symbols(const std::vector<std::string>& names)
+{
+  static SymbolTable symbol_table;
+  std::vector<Symbol> result;
+  for (const auto& name : names)
+  {
+    result.push_back(symbol_table.Intern(name));
+  }
+  return result;
+}
+
+ElementAccess Access(const std::vector<std::string>& reads, const std::vector<std::string>& writes)
+{
+  return ElementAccess{false, Symbols(reads), Symbols(writes)};
+}
+}  // unnamed namespace
+
+TEST_F(ElementSchedulerTest, BuildElementGraph)
+{
+  // a and b are created independently; c reads both; d takes ownership of a, so it has to wait
+  // for all readers of a; e reads a again after it was taken
+  std::vector<ElementAccess> accesses{
+    Access({}, {"a"}), Access({}, {"b"}), Access({"a", "b"}, {"c"}), Access({}, {"d", "a"}),
+    Access({"a"}, {"e"}) };
+  auto graph = BuildElementGraph(accesses);
+  ASSERT_EQ(graph.size(), 5);
+  EXPECT_TRUE(graph[0].empty());
+  EXPECT_TRUE(graph[1].empty());
+  EXPECT_EQ(graph[2], std::vector<std::size_t>({0, 1}));
+  EXPECT_EQ(graph[3], std::vector<std::size_t>({0, 2}));
+  EXPECT_EQ(graph[4], std::vector<std::size_t>({3}));
+
+  // Multiple readers do not depend on each other
+  graph = BuildElementGraph({ Access({"x"}, {"y"}), Access({"x"}, {"z"}), Access({}, {"x"}) });
+  EXPECT_TRUE(graph[0].empty());
+  EXPECT_TRUE(graph[1].empty());
+  EXPECT_EQ(graph[2], std::vector<std::size_t>({0, 1}));
+}
+
+TEST_F(ElementSchedulerTest, Execution)
+{
+  auto a = AddElement(Access({}, {"a"}));
+  auto b = AddElement(Access({}, {"b"}));
+  auto c = AddElement(Access({"a", "b"}, {"c"}));
+  auto barrier = AddElement(ElementAccess{});
+  auto d = AddElement(Access({}, {"d", "a"}));
+  auto e = AddElement(Access({}, {"e"}));
+  EXPECT_NO_THROW(ExecuteElementsConcurrently(m_elements, 4));
+  ASSERT_EQ(m_execution_order.size(), m_elements.size());
+  EXPECT_LT(ExecutionPosition(a), ExecutionPosition(c));
+  EXPECT_LT(ExecutionPosition(b), ExecutionPosition(c));
+  EXPECT_LT(ExecutionPosition(c), ExecutionPosition(barrier));
+  EXPECT_LT(ExecutionPosition(barrier), ExecutionPosition(d));
+  EXPECT_LT(ExecutionPosition(barrier), ExecutionPosition(e));
+}
+
+TEST_F(ElementSchedulerTest, Failure)
+{
+  AddElement(Access({}, {"a"}));
+  AddElement(Access({}, {"b"}), true);
+  auto c = AddElement(Access({"b"}, {"c"}));
+  AddElement(ElementAccess{});
+  EXPECT_THROW(ExecuteElementsConcurrently(m_elements, 4), RuntimeException);
+  // Dependent elements and elements after the barrier were not executed
+  EXPECT_EQ(m_execution_order.size(), 1);
+  EXPECT_NE(m_execution_order.front(), c);
+}
+
+ElementSchedulerTest::ElementSchedulerTest()
+  : m_elements{}
+  , m_execution_order{}
+  , m_mutex{}
+{}
+
+ElementSchedulerTest::~ElementSchedulerTest() = default;
+
+std::size_t ElementSchedulerTest::AddElement(const ElementAccess& access, bool fail)
+{
+  auto idx = m_elements.size();
+  m_elements.push_back(
+    std::make_unique<TestElement>(idx, access, fail, m_execution_order, m_mutex));
+  return idx;
+}
+
+std::size_t ElementSchedulerTest::ExecutionPosition(std::size_t element_idx) const
+{
+  auto it = std::find(m_execution_order.begin(), m_execution_order.end(), element_idx);
+  return it - m_execution_order.begin();
+}
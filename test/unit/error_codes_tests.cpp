@@ -45,6 +45,8 @@ TEST_F(ErrorCodesTest, StringNotEmpty)
   EXPECT_FALSE(ErrorString(ErrorCode::kWrongNumberOfDependencies).empty());
   EXPECT_FALSE(ErrorString(ErrorCode::kInvalidInstanceName).empty());
   EXPECT_FALSE(ErrorString(ErrorCode::kGlobalFunctionFailed).empty());
+  EXPECT_FALSE(ErrorString(ErrorCode::kInvalidPreparedCall).empty());
+  EXPECT_FALSE(ErrorString(ErrorCode::kWrongInstanceType).empty());
   EXPECT_FALSE(ErrorString(static_cast<ErrorCode>(2000)).empty());
 }
 
@@ -58,6 +60,8 @@ TEST_F(ErrorCodesTest, StringsDifferent)
   EXPECT_TRUE(error_strings.insert(ErrorString(ErrorCode::kWrongNumberOfDependencies)).second);
   EXPECT_TRUE(error_strings.insert(ErrorString(ErrorCode::kInvalidInstanceName)).second);
   EXPECT_TRUE(error_strings.insert(ErrorString(ErrorCode::kGlobalFunctionFailed)).second);
+  EXPECT_TRUE(error_strings.insert(ErrorString(ErrorCode::kInvalidPreparedCall)).second);
+  EXPECT_TRUE(error_strings.insert(ErrorString(ErrorCode::kWrongInstanceType)).second);
   EXPECT_TRUE(error_strings.insert(ErrorString(static_cast<ErrorCode>(2000))).second);
   EXPECT_FALSE(error_strings.insert(ErrorString(static_cast<ErrorCode>(2001))).second);
 }
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "sup/di/flat_type_map.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace sup::di::internal;
+
+class FlatTypeMapTest : public ::testing::Test
+{
+protected:
+  FlatTypeMapTest();
+  virtual ~FlatTypeMapTest();
+
+  FlatTypeMap<std::string> type_map;
+};
+
+template <int N>
+struct IndexedType
+{};
+
+template <int... N>
+void PutIndexedTypes(FlatTypeMap<int>& type_map)
+{
+  int dummy[] = { (type_map.put<IndexedType<N>>(int{N}), 0)... };
+  (void)dummy;
+}
+
+template <int... N>
+bool FindIndexedTypes(const FlatTypeMap<int>& type_map)
+{
+  bool results[] = { (type_map.find<IndexedType<N>>() != type_map.end() &&
+                      type_map.find<IndexedType<N>>()->second == N)... };
+  for (auto result : results)
+  {
+    if (!result)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST_F(FlatTypeMapTest, TypeId)
+{
+  auto int_id = type_map.TypeId<int>();
+  auto string_id = type_map.TypeId<std::string>();
+  EXPECT_EQ(int_id, type_map.TypeId<int>());
+  EXPECT_EQ(string_id, type_map.TypeId<std::string>());
+  EXPECT_EQ(type_map.TypeHash<int>(), type_map.TypeHash<int>());
+  EXPECT_EQ(type_map.find<int>(), type_map.end());
+  type_map.put<int>("integer");
+  type_map.put<std::string>("string");
+  EXPECT_EQ(int_id, type_map.TypeId<int>());
+  EXPECT_EQ(string_id, type_map.TypeId<std::string>());
+  auto it = type_map.find<int>();
+  EXPECT_NE(it, type_map.end());
+  EXPECT_EQ(it->second, "integer");
+  it = type_map.find<std::string>();
+  EXPECT_NE(it, type_map.end());
+  EXPECT_EQ(it->second, "string");
+  EXPECT_EQ(type_map.find<double>(), type_map.end());
+}
+
+TEST_F(FlatTypeMapTest, Overwrite)
+{
+  type_map.put<int>("integer");
+  type_map.put<int>("other");
+  auto it = type_map.find<int>();
+  ASSERT_NE(it, type_map.end());
+  EXPECT_EQ(it->second, "other");
+  EXPECT_EQ(std::distance(type_map.begin(), type_map.end()), 1);
+}
+
+TEST_F(FlatTypeMapTest, Growth)
+{
+  // Insert more types than the initial table size and check that references remain valid
+  FlatTypeMap<int> int_type_map;
+  int_type_map.put<IndexedType<0>>(0);
+  auto& first_value = int_type_map.find<IndexedType<0>>()->second;
+  PutIndexedTypes<1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20>(
+    int_type_map);
+  EXPECT_EQ(std::distance(int_type_map.begin(), int_type_map.end()), 21);
+  EXPECT_TRUE((FindIndexedTypes<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+                                19, 20>(int_type_map)));
+  EXPECT_EQ(&first_value, &int_type_map.find<IndexedType<0>>()->second);
+  EXPECT_EQ(int_type_map.find<IndexedType<21>>(), int_type_map.end());
+}
+
+TEST_F(FlatTypeMapTest, ReserveAndShrink)
+{
+  FlatTypeMap<int> int_type_map;
+  int_type_map.reserve(32);
+  int_type_map.put<IndexedType<0>>(0);
+  auto& first_value = int_type_map.find<IndexedType<0>>()->second;
+  PutIndexedTypes<1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20>(
+    int_type_map);
+  EXPECT_TRUE((FindIndexedTypes<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+                                19, 20>(int_type_map)));
+
+  // Shrinking keeps all types and does not move the values
+  int_type_map.shrink_to_fit();
+  EXPECT_EQ(std::distance(int_type_map.begin(), int_type_map.end()), 21);
+  EXPECT_TRUE((FindIndexedTypes<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+                                19, 20>(int_type_map)));
+  EXPECT_EQ(&first_value, &int_type_map.find<IndexedType<0>>()->second);
+  EXPECT_EQ(int_type_map.find<IndexedType<21>>(), int_type_map.end());
+}
+
+FlatTypeMapTest::FlatTypeMapTest() = default;
+
+FlatTypeMapTest::~FlatTypeMapTest() = default;
@@ -51,7 +51,7 @@ TEST_F(FunctionElementTest, Construction)
 {
   EXPECT_NO_THROW(FunctionElement func_elem{m_function_tree});
   auto constr_it = ElementConstructorMap().find(constants::CALL_FUNCTION_TAG);
-  EXPECT_NO_THROW(constr_it->second(m_function_tree));
+  EXPECT_NO_THROW(constr_it->second(m_function_tree, ComposerOptions{}));
 }
 
 TEST_F(FunctionElementTest, Validation)
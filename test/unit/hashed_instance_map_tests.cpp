@@ -0,0 +1,162 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/di/hashed_instance_map.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace sup::di::internal;
+
+class HashedInstanceMapTest : public ::testing::Test
+{
+protected:
+  HashedInstanceMapTest();
+  virtual ~HashedInstanceMapTest();
+
+  HashedInstanceMap<std::string> instance_map;
+};
+
+InstanceContainerPtr IntContainer(int value)
+{
+  return WrapIntoContainer(std::make_unique<int>(value));
+}
+
+int ContainedInt(const HashedInstanceMap<std::string>::iterator& it)
+{
+  return *static_cast<int*>(it->second->Get());
+}
+
+TEST_F(HashedInstanceMapTest, InsertFind)
+{
+  EXPECT_EQ(instance_map.find("one"), instance_map.end());
+  EXPECT_TRUE(instance_map.emplace("one", IntContainer(1)).second);
+  EXPECT_TRUE(instance_map.emplace("two", IntContainer(2)).second);
+  EXPECT_FALSE(instance_map.emplace("one", IntContainer(3)).second);
+  EXPECT_EQ(instance_map.size(), 2);
+
+  // Lookup with different key types
+  std::string key = "one";
+  auto it = instance_map.find(key);
+  ASSERT_NE(it, instance_map.end());
+  EXPECT_EQ(ContainedInt(it), 1);
+  it = instance_map.find(std::string_view{"two"});
+  ASSERT_NE(it, instance_map.end());
+  EXPECT_EQ(ContainedInt(it), 2);
+  const char* c_key = "one";
+  it = instance_map.find(c_key);
+  ASSERT_NE(it, instance_map.end());
+  EXPECT_EQ(ContainedInt(it), 1);
+  EXPECT_EQ(instance_map.find("three"), instance_map.end());
+}
+
+TEST_F(HashedInstanceMapTest, EraseAndGrow)
+{
+  const int n_instances = 1000;
+  for (int i = 0; i < n_instances; ++i)
+  {
+    EXPECT_TRUE(instance_map.emplace(std::to_string(i), IntContainer(i)).second);
+  }
+  EXPECT_EQ(instance_map.size(), n_instances);
+
+  // Erase all even instances
+  for (int i = 0; i < n_instances; i += 2)
+  {
+    auto it = instance_map.find(std::to_string(i));
+    ASSERT_NE(it, instance_map.end());
+    instance_map.erase(it);
+  }
+  EXPECT_EQ(instance_map.size(), n_instances / 2);
+  for (int i = 0; i < n_instances; ++i)
+  {
+    auto it = instance_map.find(std::to_string(i));
+    if (i % 2 == 0)
+    {
+      EXPECT_EQ(it, instance_map.end());
+    }
+    else
+    {
+      ASSERT_NE(it, instance_map.end());
+      EXPECT_EQ(ContainedInt(it), i);
+    }
+  }
+
+  // Erased keys can be inserted again
+  EXPECT_TRUE(instance_map.emplace("0", IntContainer(-1)).second);
+  auto it = instance_map.find("0");
+  ASSERT_NE(it, instance_map.end());
+  EXPECT_EQ(ContainedInt(it), -1);
+}
+
+TEST_F(HashedInstanceMapTest, Reserve)
+{
+  const int n_instances = 100;
+  EXPECT_TRUE(instance_map.emplace("0", IntContainer(0)).second);
+  instance_map.reserve(n_instances);
+  auto first = instance_map.find("0");
+  ASSERT_NE(first, instance_map.end());
+
+  // Entries are not moved while the reserved capacity suffices
+  for (int i = 1; i < n_instances; ++i)
+  {
+    EXPECT_TRUE(instance_map.emplace(std::to_string(i), IntContainer(i)).second);
+  }
+  EXPECT_EQ(instance_map.find("0"), first);
+  for (int i = 0; i < n_instances; ++i)
+  {
+    auto it = instance_map.find(std::to_string(i));
+    ASSERT_NE(it, instance_map.end());
+    EXPECT_EQ(ContainedInt(it), i);
+  }
+
+  // Reserving less than the current size has no effect
+  instance_map.reserve(1);
+  EXPECT_EQ(instance_map.size(), n_instances);
+  EXPECT_EQ(instance_map.find("0"), first);
+
+  // Shrinking keeps all entries
+  for (int i = 0; i < n_instances; i += 2)
+  {
+    instance_map.erase(instance_map.find(std::to_string(i)));
+  }
+  instance_map.shrink_to_fit();
+  EXPECT_EQ(instance_map.size(), n_instances / 2);
+  for (int i = 0; i < n_instances; ++i)
+  {
+    auto it = instance_map.find(std::to_string(i));
+    if (i % 2 == 0)
+    {
+      EXPECT_EQ(it, instance_map.end());
+    }
+    else
+    {
+      ASSERT_NE(it, instance_map.end());
+      EXPECT_EQ(ContainedInt(it), i);
+    }
+  }
+  EXPECT_TRUE(instance_map.emplace("0", IntContainer(0)).second);
+}
+
+HashedInstanceMapTest::HashedInstanceMapTest() = default;
+
+HashedInstanceMapTest::~HashedInstanceMapTest() = default;
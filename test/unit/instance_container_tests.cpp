@@ -24,6 +24,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
 using namespace sup::di;
 
 class InstanceContainerTest : public ::testing::Test
@@ -33,6 +37,29 @@ protected:
   virtual ~InstanceContainerTest();
 };
 
+// Memory resource that keeps track of the number of bytes that were not deallocated
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  std::size_t outstanding = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+  {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
 TEST_F(InstanceContainerTest, WrapIntoContainer)
 {
   auto up_int = std::make_unique<int>(42);
@@ -43,6 +70,22 @@ TEST_F(InstanceContainerTest, WrapIntoContainer)
   EXPECT_EQ(container->Get(), nullptr);
 }
 
+TEST_F(InstanceContainerTest, InstanceContainerDeleter)
+{
+  using Container = internal::InstanceContainer<std::string, std::default_delete<std::string>>;
+  CountingResource resource;
+  {
+    // Containers allocated from a memory resource return their memory to it
+    auto container = internal::AllocateInstanceContainer<Container>(
+      &resource, std::make_unique<std::string>("allocated"));
+    EXPECT_EQ(*static_cast<std::string*>(container->Get()), "allocated");
+    EXPECT_EQ(resource.outstanding, sizeof(Container));
+  }
+  EXPECT_EQ(resource.outstanding, 0);
+  internal::InstanceContainerPtr container = internal::WrapIntoContainer(std::make_unique<int>(3));
+  EXPECT_EQ(*static_cast<int*>(container->Get()), 3);
+}
+
 InstanceContainerTest::InstanceContainerTest() {}
 
 InstanceContainerTest::~InstanceContainerTest() = default;
@@ -22,6 +22,7 @@
 
 #include "global_test_objects.h"
 
+#include <sup/di-composer-core/composer_options.h>
 #include <sup/di-composer-core/constants.h>
 #include <sup/di-composer-core/element_constructor_map.h>
 #include <sup/di-composer-core/exceptions.h>
@@ -47,13 +48,15 @@ protected:
   sup::xml::TreeData m_instance_tree;
 };
 
-sup::xml::TreeData CreateInstanceTree(const std::string& str_dep_name);
+sup::xml::TreeData CreateInstanceTree(
+  const std::string& str_dep_name,
+  const std::string& instance_name = STRING_WRAPPER_INSTANCE_NAME);
 
 TEST_F(InstanceElementTest, Construction)
 {
   EXPECT_NO_THROW(InstanceElement inst_elem{m_instance_tree});
   auto constr_it = ElementConstructorMap().find(constants::CREATE_INSTANCE_TAG);
-  EXPECT_NO_THROW(constr_it->second(m_instance_tree));
+  EXPECT_NO_THROW(constr_it->second(m_instance_tree, ComposerOptions{}));
 }
 
 TEST_F(InstanceElementTest, Validation)
@@ -97,17 +100,53 @@ TEST_F(InstanceElementTest, Execution)
   EXPECT_THROW(inst_elem_fail.Execute(), RuntimeException);
 }
 
+TEST_F(InstanceElementTest, LazyExecution)
+{
+  ComposerOptions options;
+  options.lazy_instances = true;
+  const std::string lazy_instance_name = "Test_LazyWrapperInstance";
+  auto& object_manager = GlobalObjectManager();
+  auto n_deferred = object_manager.GetDeferredInstanceCount();
+  InstanceElement inst_elem{CreateInstanceTree(test::Test_String_Name, lazy_instance_name),
+                            options};
+  EXPECT_NO_THROW(inst_elem.Execute());
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), n_deferred + 1);
+  auto wrapper = object_manager.GetInstance<test::Test_StringWrapper*>(lazy_instance_name);
+  ASSERT_NE(wrapper, nullptr);
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), n_deferred);
+
+  // Missing dependencies are only detected on first use
+  const std::string failing_instance_name = "Test_LazyFailingInstance";
+  InstanceElement inst_elem_fail{CreateInstanceTree("this_name_does_not_exist",
+                                                    failing_instance_name), options};
+  EXPECT_NO_THROW(inst_elem_fail.Execute());
+  EXPECT_THROW(object_manager.GetInstance<test::Test_StringWrapper*>(failing_instance_name),
+               std::runtime_error);
+
+  // Unknown types are detected when deferring
+  sup::xml::TreeData unknown_type_tree{constants::CREATE_INSTANCE_TAG};
+  sup::xml::TreeData name_tree{constants::INSTANCE_NAME_TAG};
+  name_tree.SetContent("Test_LazyUnknownType");
+  unknown_type_tree.AddChild(name_tree);
+  sup::xml::TreeData type_tree{constants::TYPE_NAME_TAG};
+  type_tree.SetContent("this_type_does_not_exist");
+  unknown_type_tree.AddChild(type_tree);
+  InstanceElement inst_elem_unknown{unknown_type_tree, options};
+  EXPECT_THROW(inst_elem_unknown.Execute(), RuntimeException);
+}
+
 InstanceElementTest::InstanceElementTest()
   : m_instance_tree{CreateInstanceTree(test::Test_String_Name)}
 {}
 
 InstanceElementTest::~InstanceElementTest() = default;
 
-sup::xml::TreeData CreateInstanceTree(const std::string& str_dep_name)
+sup::xml::TreeData CreateInstanceTree(const std::string& str_dep_name,
+                                      const std::string& instance_name)
 {
   sup::xml::TreeData instance_tree{constants::CREATE_INSTANCE_TAG};
   sup::xml::TreeData name_tree{constants::INSTANCE_NAME_TAG};
-  name_tree.SetContent(STRING_WRAPPER_INSTANCE_NAME);
+  name_tree.SetContent(instance_name);
   instance_tree.AddChild(name_tree);
   sup::xml::TreeData type_tree{constants::TYPE_NAME_TAG};
   type_tree.SetContent(test::Test_StringWrapper_Name);
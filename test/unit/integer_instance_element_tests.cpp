@@ -54,7 +54,7 @@ TEST_F(IntegerInstanceElementTest, Construction)
 {
   EXPECT_NO_THROW(IntegerInstanceElement inst_elem{m_integer_instance_tree});
   auto constr_it = ElementConstructorMap().find(constants::INTEGER_INSTANCE_TAG);
-  EXPECT_NO_THROW(constr_it->second(m_integer_instance_tree));
+  EXPECT_NO_THROW(constr_it->second(m_integer_instance_tree, ComposerOptions{}));
 }
 
 TEST_F(IntegerInstanceElementTest, Validation)
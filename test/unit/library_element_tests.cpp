@@ -29,6 +29,7 @@
 #include <sup/di-composer-core/exceptions.h>
 #include <sup/di-composer-core/library_element.h>
 
+#include <sup/di/di_utils.h>
 #include <sup/di/object_manager.h>
 
 #include <sup/xml/exceptions.h>
@@ -36,6 +37,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace sup::di;
 
 class LibraryElementTest : public ::testing::Test
@@ -55,7 +58,7 @@ TEST_F(LibraryElementTest, Construction)
 {
   EXPECT_NO_THROW(LibraryElement library_elem{m_library_tree});
   auto constr_it = ElementConstructorMap().find(constants::LOAD_LIBRARY_TAG);
-  EXPECT_NO_THROW(constr_it->second(m_library_tree));
+  EXPECT_NO_THROW(constr_it->second(m_library_tree, ComposerOptions{}));
 }
 
 TEST_F(LibraryElementTest, Validation)
@@ -76,6 +79,65 @@ TEST_F(LibraryElementTest, Validation)
     library_tree.AddChild(name_tree);
     EXPECT_THROW(ValidateLibraryTree(library_tree), sup::xml::ValidationException);
   }
+  {
+    sup::xml::TreeData library_tree{constants::LOAD_LIBRARY_TAG};
+    library_tree.SetContent("does_not_matter.so");
+    library_tree.AddAttribute(constants::BINDING_ATTRIBUTE, constants::BINDING_LAZY);
+    library_tree.AddAttribute(constants::SCOPE_ATTRIBUTE, constants::SCOPE_GLOBAL);
+    library_tree.AddAttribute(constants::NODELETE_ATTRIBUTE, constants::TRUE_VALUE);
+    EXPECT_NO_THROW(ValidateLibraryTree(library_tree));
+  }
+  {
+    sup::xml::TreeData library_tree{constants::LOAD_LIBRARY_TAG};
+    library_tree.SetContent("does_not_matter.so");
+    library_tree.AddAttribute(constants::BINDING_ATTRIBUTE, "eventually");
+    EXPECT_THROW(ValidateLibraryTree(library_tree), sup::xml::ValidationException);
+  }
+}
+
+TEST_F(LibraryElementTest, LoadOptions)
+{
+  auto default_options = GetLibraryLoadOptions(m_library_tree);
+  EXPECT_FALSE(default_options.lazy_binding);
+  EXPECT_FALSE(default_options.global_symbols);
+  EXPECT_FALSE(default_options.no_delete);
+
+  auto library_tree = CreateLibraryTree(GetWrapperLibraryName());
+  library_tree.AddAttribute(constants::BINDING_ATTRIBUTE, constants::BINDING_LAZY);
+  library_tree.AddAttribute(constants::SCOPE_ATTRIBUTE, constants::SCOPE_LOCAL);
+  library_tree.AddAttribute(constants::NODELETE_ATTRIBUTE, constants::TRUE_VALUE);
+  auto options = GetLibraryLoadOptions(library_tree);
+  EXPECT_TRUE(options.lazy_binding);
+  EXPECT_FALSE(options.global_symbols);
+  EXPECT_TRUE(options.no_delete);
+
+  LibraryElement library_elem{library_tree};
+  EXPECT_NO_THROW(library_elem.Execute());
+}
+
+TEST_F(LibraryElementTest, LibraryRegistry)
+{
+  auto library_name = GetWrapperLibraryName();
+  EXPECT_EQ(utils::LoadLibrary(library_name), ErrorCode::kSuccess);
+  auto handle = utils::GetLibraryHandle(library_name);
+  ASSERT_NE(handle, nullptr);
+  auto loaded_libraries = utils::GetLoadedLibraries();
+  EXPECT_NE(std::find(loaded_libraries.begin(), loaded_libraries.end(), library_name),
+            loaded_libraries.end());
+
+  // Loading again, with or without promotion, keeps the handle
+  utils::LibraryLoadOptions options;
+  options.lazy_binding = true;
+  EXPECT_EQ(utils::LoadLibrary(library_name, options), ErrorCode::kSuccess);
+  options.global_symbols = true;
+  options.no_delete = true;
+  EXPECT_EQ(utils::LoadLibrary(library_name, options), ErrorCode::kSuccess);
+  EXPECT_EQ(utils::GetLibraryHandle(library_name), handle);
+  EXPECT_EQ(utils::GetLoadedLibraries().size(), loaded_libraries.size());
+
+  // Failed loads are not registered
+  EXPECT_EQ(utils::LoadLibrary("this_name_does_not_exist"), ErrorCode::kLibraryNotLoaded);
+  EXPECT_EQ(utils::GetLibraryHandle("this_name_does_not_exist"), nullptr);
 }
 
 TEST_F(LibraryElementTest, Execution)
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "service_wrapper_config.h"
+#include "temporary_file.h"
+
+#include <sup/di-composer-core/library_prefetcher.h>
+
+#include <sup/di/di_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+
+using namespace sup::di;
+
+const std::string PREFETCH_FILE_NAME = "test_library_prefetcher.so";
+
+class LibraryPrefetcherTest : public ::testing::Test
+{
+protected:
+  LibraryPrefetcherTest();
+  virtual ~LibraryPrefetcherTest();
+
+  std::string m_library_dir;
+  std::string m_library_name;
+};
+
+TEST_F(LibraryPrefetcherTest, PrefetchLibrary)
+{
+  EXPECT_EQ(utils::PrefetchLibrary(m_library_dir + "/" + m_library_name), ErrorCode::kSuccess);
+  EXPECT_EQ(utils::PrefetchLibrary(m_library_dir + "/this_name_does_not_exist.so"),
+            ErrorCode::kLibraryNotLoaded);
+
+  // Names without a slash are only looked up in LD_LIBRARY_PATH
+  const char* previous_search_path = std::getenv("LD_LIBRARY_PATH");
+  std::string search_path = previous_search_path != nullptr ? previous_search_path : "";
+  ::setenv("LD_LIBRARY_PATH", "/this_directory_does_not_exist", 1);
+  EXPECT_EQ(utils::PrefetchLibrary(m_library_name), ErrorCode::kLibraryNotLoaded);
+  ::setenv("LD_LIBRARY_PATH", ("/this_directory_does_not_exist:" + m_library_dir).c_str(), 1);
+  EXPECT_EQ(utils::PrefetchLibrary(m_library_name), ErrorCode::kSuccess);
+  if (previous_search_path != nullptr)
+  {
+    ::setenv("LD_LIBRARY_PATH", search_path.c_str(), 1);
+  }
+  else
+  {
+    ::unsetenv("LD_LIBRARY_PATH");
+  }
+}
+
+TEST_F(LibraryPrefetcherTest, Prefetcher)
+{
+  // Any readable file can be prefetched
+  test::TemporaryTestFile file(PREFETCH_FILE_NAME, "Not a shared library");
+  const std::string prefetch_path = "./" + PREFETCH_FILE_NAME;
+  {
+    LibraryPrefetcher prefetcher{{}};
+    EXPECT_EQ(prefetcher.Wait(), 0);
+  }
+  {
+    // More libraries than threads, including ones that are not found
+    std::vector<std::string> library_names;
+    for (std::size_t idx = 0; idx < LibraryPrefetcher::kMaxThreads + 2; ++idx)
+    {
+      library_names.push_back(prefetch_path);
+      library_names.push_back("this_name_does_not_exist.so");
+    }
+    LibraryPrefetcher prefetcher{library_names};
+    EXPECT_EQ(prefetcher.Wait(), LibraryPrefetcher::kMaxThreads + 2);
+    EXPECT_EQ(prefetcher.Wait(), LibraryPrefetcher::kMaxThreads + 2);
+  }
+  {
+    // Libraries that were already loaded are skipped
+    auto library_path = m_library_dir + "/" + m_library_name;
+    ASSERT_EQ(utils::LoadLibrary(library_path), ErrorCode::kSuccess);
+    LibraryPrefetcher prefetcher{{ library_path, prefetch_path }};
+    EXPECT_EQ(prefetcher.Wait(), 1);
+  }
+  {
+    // Destruction without waiting
+    LibraryPrefetcher prefetcher{{ prefetch_path }};
+  }
+}
+
+LibraryPrefetcherTest::LibraryPrefetcherTest()
+  : m_library_dir{service_wrapper_config::CMakeLibraryInstallDir()}
+  , m_library_name{"libservice-wrapper.so"}
+{}
+
+LibraryPrefetcherTest::~LibraryPrefetcherTest() = default;
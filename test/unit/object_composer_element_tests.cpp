@@ -28,17 +28,41 @@
 #include <sup/di-composer-core/object_composer_element.h>
 
 #include <sup/di/object_manager.h>
+#include <sup/di/trace_recorder.h>
 
 #include <sup/xml/exceptions.h>
 #include <sup/xml/tree_data.h>
+#include <sup/xml/tree_data_parser.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace sup::di;
 
 const std::string STRING_INSTANCE_NAME = "Test_StringInstanceName";
 const std::string STRING_INSTANCE_VALUE = "Test_StringValue";
 
+const std::string STOP_ON_FAILURE_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <StringInstance>
+        <InstanceName>composer_stop_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>composer_stop_failing_name</InstanceName>
+        <Dependency>composer_stop_missing_name</Dependency>
+    </Instance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>composer_stop_later_name</InstanceName>
+        <Dependency>composer_stop_str_name</Dependency>
+    </Instance>
+</ObjectComposer>
+)RAW";
+
 class ObjectComposerElementTest : public ::testing::Test
 {
 protected:
@@ -48,7 +72,8 @@ protected:
   sup::xml::TreeData m_composer_tree;
 };
 
-sup::xml::TreeData CreateComposerTree(const std::string& str_dep_name);
+sup::xml::TreeData CreateComposerTree(const std::string& str_dep_name,
+                                      const std::string& str_instance_name = STRING_INSTANCE_NAME);
 
 TEST_F(ObjectComposerElementTest, Construction)
 {
@@ -79,6 +104,12 @@ TEST_F(ObjectComposerElementTest, Execution)
 
   ObjectComposerElement inst_elem_fail{CreateComposerTree("this_dependency_does_not_exist")};
   EXPECT_THROW(inst_elem_fail.Execute(), RuntimeException);
+
+  // Instances after a failing one are not created
+  ObjectComposerElement stop_elem{*sup::xml::TreeDataFromString(STOP_ON_FAILURE_XML)};
+  EXPECT_THROW(stop_elem.Execute(), RuntimeException);
+  EXPECT_THROW(GlobalObjectManager().GetInstance<test::Test_StringWrapper*>(
+                 "composer_stop_later_name"), std::runtime_error);
 }
 
 TEST_F(ObjectComposerElementTest, CreateComposerElement)
@@ -88,13 +119,45 @@ TEST_F(ObjectComposerElementTest, CreateComposerElement)
   EXPECT_THROW(CreateComposerElement(composer_tree), ParseException);
 }
 
+TEST_F(ObjectComposerElementTest, Instrumentation)
+{
+  const std::string instance_name = "Test_InstrumentedStringInstanceName";
+  TraceRecorder recorder;
+  ComposerOptions options;
+  options.trace_recorder = &recorder;
+  ObjectComposerElement composer_elem{CreateComposerTree(instance_name, instance_name), options};
+  EXPECT_NO_THROW(composer_elem.Execute());
+  auto events = recorder.GetEvents();
+#ifdef SUP_DI_INSTRUMENTATION
+  auto count_events = [&events](const std::string& category)
+  {
+    return std::count_if(events.begin(), events.end(),
+                         [&category](const TraceEvent& event)
+                         { return event.category == category; });
+  };
+  EXPECT_EQ(count_events("phase"), 3);
+  EXPECT_EQ(count_events("construct"), 2);
+  EXPECT_EQ(count_events("execute"), 2);
+  auto it = std::find_if(events.begin(), events.end(),
+                         [](const TraceEvent& event) { return event.category == "execute"; });
+  ASSERT_NE(it, events.end());
+  EXPECT_EQ(it->name, constants::STRING_INSTANCE_TAG + " " + instance_name);
+  // The overall execute phase finishes last
+  EXPECT_EQ(events.back().category, "phase");
+  EXPECT_EQ(events.back().name, "execute");
+#else
+  EXPECT_TRUE(events.empty());
+#endif
+}
+
 ObjectComposerElementTest::ObjectComposerElementTest()
   : m_composer_tree{CreateComposerTree(STRING_INSTANCE_NAME)}
 {}
 
 ObjectComposerElementTest::~ObjectComposerElementTest() = default;
 
-sup::xml::TreeData CreateComposerTree(const std::string& str_dep_name)
+sup::xml::TreeData CreateComposerTree(const std::string& str_dep_name,
+                                      const std::string& str_instance_name)
 {
   sup::xml::TreeData composer_tree{constants::OBJECT_COMPOSER_TAG};
   composer_tree.AddAttribute("someAttribute", "does_not_matter");
@@ -102,7 +165,7 @@ sup::xml::TreeData CreateComposerTree(const std::string& str_dep_name)
   // String instance
   sup::xml::TreeData string_instance_tree{constants::STRING_INSTANCE_TAG};
   sup::xml::TreeData str_name_tree{constants::INSTANCE_NAME_TAG};
-  str_name_tree.SetContent(STRING_INSTANCE_NAME);
+  str_name_tree.SetContent(str_instance_name);
   string_instance_tree.AddChild(str_name_tree);
   sup::xml::TreeData val_tree{constants::VALUE_TAG};
   val_tree.SetContent(STRING_INSTANCE_VALUE);
@@ -26,8 +26,13 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace sup::di;
 
@@ -51,6 +56,22 @@ const std::string DecoratorHelloTestName = "DecoratorHelloTest";
 const std::string OwnedPrinterTestName = "OwnedPrinterTest";
 const std::string AggregatorPrinterTestName = "AggregatorPrinterTest";
 
+struct HelloPrinterTag { static constexpr const char* name = "HelloPrinterTag"; };
+struct OwnerTag { static constexpr const char* name = "OwnerTag"; };
+struct UnknownTag { static constexpr const char* name = "UnknownTag"; };
+
+// Global function that creates an instance itself, for testing nested trace spans
+ObjectManager* nested_object_manager = nullptr;
+bool CreateHelloPrinterNested();
+
+// Factory function that counts its calls, for testing deferred instances
+std::atomic<int> counting_printer_creations{0};
+std::unique_ptr<IPrinter> CountingPrinterFactoryFunction();
+
+// Functions that throw, for testing the mapping of exceptions to error codes
+std::unique_ptr<IPrinter> ThrowingPrinterFactoryFunction();
+bool ThrowingGlobalFunction(IPrinter* printer);
+
 TEST_F(ObjectManagerTest, NoDependencies)
 {
   // Factory function registration
@@ -130,6 +151,15 @@ TEST_F(ObjectManagerTest, RegisterString)
   EXPECT_TRUE(object_manager.RegisterGlobalFunction(function_name, TestString));
   EXPECT_EQ(object_manager.CallGlobalFunction(function_name, {instance_name}),
     ErrorCode::kSuccess);
+
+  // Pointers to the copy stay valid after its ownership was transferred
+  std::unique_ptr<std::string> owned_str;
+  EXPECT_NO_THROW(owned_str =
+                    object_manager.GetInstance<std::unique_ptr<std::string>&&>(instance_name));
+  ASSERT_NE(owned_str, nullptr);
+  EXPECT_EQ(owned_str.get(), str_ref);
+  EXPECT_EQ(*str_ref, instance_value);
+  EXPECT_THROW(object_manager.GetInstance<const std::string*>(instance_name), std::runtime_error);
 }
 
 TEST_F(ObjectManagerTest, PassOwnership)
@@ -286,6 +316,744 @@ TEST_F(ObjectManagerTest, Exceptions)
   EXPECT_TRUE(object_manager.RegisterInstance(1, IntInstanceName));
   EXPECT_EQ(object_manager.CallGlobalFunction(HelloTestName, {IntInstanceName}),
     ErrorCode::kDependencyNotFound);
+
+  // Functions that throw std::runtime_error return an error code instead
+  const std::string throwing_name = "ThrowingPrinter";
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(throwing_name,
+                                                     ThrowingPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(throwing_name, ThrowingGlobalFunction));
+  EXPECT_EQ(object_manager.CreateInstance(throwing_name, PrinterAggregatorInstanceName, {}),
+    ErrorCode::kDependencyNotFound);
+  std::unique_ptr<IPrinter> transient;
+  EXPECT_EQ(object_manager.CreateTransient(throwing_name, {}, transient),
+    ErrorCode::kDependencyNotFound);
+  EXPECT_EQ(transient, nullptr);
+  EXPECT_EQ(object_manager.CallGlobalFunction(throwing_name, {HelloPrinterInstanceName}),
+    ErrorCode::kDependencyNotFound);
+  PreparedCall prepared_call;
+  ASSERT_EQ(object_manager.PrepareGlobalFunction(throwing_name, {HelloPrinterInstanceName},
+                                                 prepared_call),
+    ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(prepared_call), ErrorCode::kDependencyNotFound);
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(PrinterAggregatorInstanceName),
+               std::runtime_error);
+}
+
+TEST_F(ObjectManagerTest, PreparedCalls)
+{
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+        std::unique_ptr<IPrinter>&&>));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(HelloTestName, TestHelloPrinter));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(OwnedPrinterTestName, TestOwnedPrinter));
+
+  // Invalid handle
+  PreparedCall hello_test;
+  EXPECT_EQ(object_manager.Invoke(hello_test), ErrorCode::kInvalidPreparedCall);
+
+  // Preparation failures
+  EXPECT_EQ(object_manager.PrepareGlobalFunction(HelloTestName, {HelloPrinterInstanceName},
+                                                 hello_test),
+    ErrorCode::kDependencyNotFound);
+  EXPECT_EQ(object_manager.PrepareGlobalFunction(HelloTestName, {}, hello_test),
+    ErrorCode::kWrongNumberOfDependencies);
+  EXPECT_EQ(object_manager.PrepareGlobalFunction(DecoratorHelloTestName, {}, hello_test),
+    ErrorCode::kGlobalFunctionNotFound);
+  EXPECT_EQ(object_manager.PrepareCreateInstance(PrinterDecoratorName,
+                                                 PrinterDecoratorInstanceName, {}, hello_test),
+    ErrorCode::kFactoryFunctionNotFound);
+  EXPECT_EQ(object_manager.Invoke(hello_test), ErrorCode::kInvalidPreparedCall);
+
+  // Prepared instance creation can only succeed once for the same instance name
+  PreparedCall create_hello;
+  EXPECT_EQ(object_manager.PrepareCreateInstance(HelloPrinterName, HelloPrinterInstanceName, {},
+                                                 create_hello),
+    ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(create_hello), ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(create_hello), ErrorCode::kInvalidInstanceName);
+
+  // Prepared global function call can be invoked repeatedly
+  EXPECT_EQ(object_manager.PrepareGlobalFunction(HelloTestName, {HelloPrinterInstanceName},
+                                                 hello_test),
+    ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(hello_test), ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(hello_test), ErrorCode::kSuccess);
+
+  // Handles can only be invoked by the ObjectManager that prepared them
+  ObjectManager other_object_manager;
+  EXPECT_EQ(other_object_manager.Invoke(hello_test), ErrorCode::kInvalidPreparedCall);
+
+  // Transfer ownership of the hello printer: handles that use it fail afterwards
+  PreparedCall create_owner;
+  EXPECT_EQ(object_manager.PrepareCreateInstance(PrinterOwnerName, PrinterOwnerInstanceName,
+                                                 {HelloPrinterInstanceName}, create_owner),
+    ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(create_owner), ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(create_owner), ErrorCode::kDependencyNotFound);
+  EXPECT_EQ(object_manager.Invoke(hello_test), ErrorCode::kDependencyNotFound);
+
+  // Other handles are resolved again and remain usable
+  PreparedCall owned_test;
+  EXPECT_EQ(object_manager.PrepareGlobalFunction(OwnedPrinterTestName, {PrinterOwnerInstanceName},
+                                                 owned_test),
+    ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(owned_test), ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, PrinterDecoratorInstanceName, {}),
+    ErrorCode::kSuccess);
+  std::unique_ptr<IPrinter> released;
+  EXPECT_NO_THROW(released = object_manager.GetInstance<std::unique_ptr<IPrinter>&&>(
+    PrinterDecoratorInstanceName));
+  EXPECT_NE(released, nullptr);
+  EXPECT_EQ(object_manager.Invoke(owned_test), ErrorCode::kSuccess);
+}
+
+TEST_F(ObjectManagerTest, ConcurrentAccess)
+{
+  const std::size_t n_threads = 8;
+  const std::size_t n_iterations = 200;
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(HelloTestName, TestHelloPrinter));
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, HelloPrinterInstanceName, {}),
+    ErrorCode::kSuccess);
+
+  // Readers, writers and ownership transfers of distinct instances run in parallel
+  std::atomic<std::size_t> n_failures{0};
+  auto worker = [this, &n_failures, n_iterations](std::size_t thread_idx)
+  {
+    const std::string prefix = "thread_" + std::to_string(thread_idx) + "_";
+    if (thread_idx == 0)
+    {
+      EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+          PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+            std::unique_ptr<IPrinter>&&>));
+    }
+    PreparedCall hello_test;
+    if (object_manager.PrepareGlobalFunction(HelloTestName, {HelloPrinterInstanceName},
+                                             hello_test) != ErrorCode::kSuccess)
+    {
+      ++n_failures;
+    }
+    for (std::size_t i = 0; i < n_iterations; ++i)
+    {
+      const std::string hello_name = prefix + "hello_" + std::to_string(i);
+      const std::string owner_name = prefix + "owner_" + std::to_string(i);
+      const std::string int_name = prefix + "int_" + std::to_string(i);
+      if (object_manager.CreateInstance(HelloPrinterName, hello_name, {}) != ErrorCode::kSuccess
+          || object_manager.CallGlobalFunction(HelloTestName, {hello_name}) != ErrorCode::kSuccess
+          || object_manager.Invoke(hello_test) != ErrorCode::kSuccess
+          || !object_manager.RegisterInstance(static_cast<int>(i), int_name))
+      {
+        ++n_failures;
+      }
+      auto owner_status = object_manager.CreateInstance(PrinterOwnerName, owner_name, {hello_name});
+      if (owner_status == ErrorCode::kSuccess)
+      {
+        auto owner = object_manager.GetInstance<IPrinter*>(owner_name);
+        if (owner->Print() != OwnedPrinterPrefix + HelloWorld)
+        {
+          ++n_failures;
+        }
+      }
+      else if (owner_status != ErrorCode::kFactoryFunctionNotFound)
+      {
+        ++n_failures;
+      }
+      auto value = object_manager.GetInstance<std::unique_ptr<int>&&>(int_name);
+      if (!value || *value != static_cast<int>(i))
+      {
+        ++n_failures;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t thread_idx = 0; thread_idx < n_threads; ++thread_idx)
+  {
+    threads.emplace_back(worker, thread_idx);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(n_failures.load(), 0);
+
+  // All transferred instances were removed
+  for (std::size_t thread_idx = 0; thread_idx < n_threads; ++thread_idx)
+  {
+    const std::string prefix = "thread_" + std::to_string(thread_idx) + "_";
+    EXPECT_THROW(object_manager.GetInstance<int*>(prefix + "int_0"), std::runtime_error);
+  }
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>("thread_0_hello_0"), std::runtime_error);
+  EXPECT_NO_THROW(object_manager.GetInstance<IPrinter*>("thread_0_owner_0"));
+}
+
+TEST_F(ObjectManagerTest, MemoryResource)
+{
+  // Any use of the default memory resource throws std::bad_alloc
+  auto default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  {
+    std::pmr::monotonic_buffer_resource arena{default_resource};
+    ObjectManager arena_object_manager{&arena};
+    EXPECT_TRUE(arena_object_manager.RegisterFactoryFunction(
+        HelloPrinterName, HelloPrinterFactoryFunction));
+    EXPECT_TRUE(arena_object_manager.RegisterFactoryFunction(
+        PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+          std::unique_ptr<IPrinter>&&>));
+    EXPECT_TRUE(arena_object_manager.RegisterGlobalFunction(OwnedPrinterTestName,
+                                                            TestOwnedPrinter));
+    EXPECT_TRUE(arena_object_manager.RegisterInstance(std::string{"a long string literal value"},
+                                                      "a long instance name for a string"));
+    for (int i = 0; i < 100; ++i)
+    {
+      auto hello_name = "a long instance name for a hello printer " + std::to_string(i);
+      auto owner_name = "a long instance name for a printer owner " + std::to_string(i);
+      EXPECT_EQ(arena_object_manager.CreateInstance(HelloPrinterName, hello_name, {}),
+        ErrorCode::kSuccess);
+      EXPECT_EQ(arena_object_manager.CreateInstance(PrinterOwnerName, owner_name, {hello_name}),
+        ErrorCode::kSuccess);
+      EXPECT_EQ(arena_object_manager.CallGlobalFunction(OwnedPrinterTestName, {owner_name}),
+        ErrorCode::kSuccess);
+    }
+    EXPECT_EQ(*arena_object_manager.GetInstance<std::string*>("a long instance name for a string"),
+              "a long string literal value");
+  }
+  std::pmr::set_default_resource(default_resource);
+}
+
+TEST_F(ObjectManagerTest, TypedKeys)
+{
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+        std::unique_ptr<IPrinter>&&>));
+  EXPECT_TRUE(object_manager.RegisterInstance<HelloPrinterTag>(
+      std::unique_ptr<IPrinter>(new HelloPrinter{})));
+  EXPECT_FALSE(object_manager.RegisterInstance<HelloPrinterTag>(
+      std::unique_ptr<IPrinter>(new HelloPrinter{})));
+
+  // Repeated typed lookups hit the same instance, which is also reachable by name
+  IPrinter* print_service = object_manager.GetInstance<IPrinter*, HelloPrinterTag>();
+  ASSERT_NE(print_service, nullptr);
+  EXPECT_EQ(print_service->Print(), HelloWorld);
+  EXPECT_EQ((object_manager.GetInstance<IPrinter*, HelloPrinterTag>()), print_service);
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(HelloPrinterTag::name), print_service);
+  EXPECT_THROW((object_manager.GetInstance<IPrinter*, UnknownTag>()), std::runtime_error);
+  EXPECT_THROW((object_manager.GetInstance<std::string*, HelloPrinterTag>()), std::runtime_error);
+
+  // Transfer of ownership through the string based API invalidates the cached slot
+  EXPECT_EQ(object_manager.CreateInstance(PrinterOwnerName, OwnerTag::name,
+                                          {HelloPrinterTag::name}),
+    ErrorCode::kSuccess);
+  EXPECT_THROW((object_manager.GetInstance<IPrinter*, HelloPrinterTag>()), std::runtime_error);
+  EXPECT_EQ((object_manager.GetInstance<IPrinter*, OwnerTag>()->Print()),
+            OwnedPrinterPrefix + HelloWorld);
+
+  // Typed lookup with transfer of ownership
+  auto owner = object_manager.GetInstance<std::unique_ptr<IPrinter>, OwnerTag>();
+  ASSERT_NE(owner, nullptr);
+  EXPECT_THROW((object_manager.GetInstance<IPrinter*, OwnerTag>()), std::runtime_error);
+}
+
+TEST_F(ObjectManagerTest, Symbols)
+{
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+        std::unique_ptr<IPrinter>&&>));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(HelloTestName, TestHelloPrinter));
+
+  // Registration interned the names
+  auto hello_printer = object_manager.Intern(HelloPrinterName);
+  auto printer_owner = object_manager.Intern(PrinterOwnerName);
+  auto hello_test = object_manager.Intern(HelloTestName);
+  auto hello_instance = object_manager.Intern(HelloPrinterInstanceName);
+  auto owner_instance = object_manager.Intern(PrinterOwnerInstanceName);
+  EXPECT_EQ(object_manager.Intern(HelloPrinterName), hello_printer);
+  EXPECT_EQ(object_manager.GetSymbolName(hello_instance), HelloPrinterInstanceName);
+  EXPECT_TRUE(object_manager.GetSymbolName(kInvalidSymbol).empty());
+
+  // Mix symbol and string based access
+  EXPECT_EQ(object_manager.CreateInstance(hello_printer, hello_instance, {}), ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.CallGlobalFunction(HelloTestName, {HelloPrinterInstanceName}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.CallGlobalFunction(hello_test, {hello_instance}), ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(hello_instance),
+            object_manager.GetInstance<IPrinter*>(HelloPrinterInstanceName));
+  std::vector<bool> transfer_ownership;
+  EXPECT_EQ(object_manager.GetFactoryFunctionOwnership(printer_owner, transfer_ownership),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(transfer_ownership, std::vector<bool>({true}));
+
+  // Failures
+  EXPECT_EQ(object_manager.CreateInstance(hello_instance, owner_instance, {}),
+            ErrorCode::kFactoryFunctionNotFound);
+  EXPECT_EQ(object_manager.CreateInstance(hello_printer, kInvalidSymbol, {}),
+            ErrorCode::kInvalidInstanceName);
+  EXPECT_EQ(object_manager.CreateInstance(printer_owner, owner_instance, {kInvalidSymbol}),
+            ErrorCode::kDependencyNotFound);
+  EXPECT_EQ(object_manager.CallGlobalFunction(hello_printer, {hello_instance}),
+            ErrorCode::kGlobalFunctionNotFound);
+  EXPECT_FALSE(object_manager.RegisterInstance(42, kInvalidSymbol));
+  EXPECT_TRUE(object_manager.RegisterInstance(42, object_manager.Intern(IntInstanceName)));
+  EXPECT_EQ(*object_manager.GetInstance<int*>(IntInstanceName), 42);
+
+  // Transfer of ownership
+  EXPECT_EQ(object_manager.CreateInstance(printer_owner, owner_instance, {hello_instance}),
+            ErrorCode::kSuccess);
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(hello_instance), std::runtime_error);
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(owner_instance)->Print(),
+            OwnedPrinterPrefix + HelloWorld);
+}
+
+TEST_F(ObjectManagerTest, Trace)
+{
+  const std::string NestedCreateName = "NestedCreate";
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+        std::unique_ptr<IPrinter>&&>));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(NestedCreateName, CreateHelloPrinterNested));
+  nested_object_manager = &object_manager;
+
+  // Nothing is recorded without recorder
+  EXPECT_EQ(object_manager.GetTraceRecorder(), nullptr);
+  TraceRecorder recorder;
+  object_manager.SetTraceRecorder(&recorder);
+  EXPECT_EQ(object_manager.GetTraceRecorder(), &recorder);
+
+  EXPECT_EQ(object_manager.CallGlobalFunction(NestedCreateName, {}), ErrorCode::kSuccess);
+  auto owner_instance = object_manager.Intern(PrinterOwnerInstanceName);
+  EXPECT_EQ(object_manager.CreateInstance(object_manager.Intern(PrinterOwnerName), owner_instance,
+                                          {object_manager.Intern(HelloPrinterInstanceName)}),
+            ErrorCode::kSuccess);
+  EXPECT_NE(object_manager.GetInstance<std::unique_ptr<IPrinter>&&>(PrinterOwnerInstanceName),
+            nullptr);
+  // Pointer lookups are not traced
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(owner_instance), std::runtime_error);
+  object_manager.SetTraceRecorder(nullptr);
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kSuccess);
+  nested_object_manager = nullptr;
+
+  auto events = recorder.GetEvents();
+  ASSERT_EQ(events.size(), 4);
+  // Nested spans finish first and lie within their parent span
+  EXPECT_EQ(events[0].name, "CreateInstance " + HelloPrinterInstanceName);
+  EXPECT_EQ(events[1].name, "CallGlobalFunction " + NestedCreateName);
+  EXPECT_GE(events[0].start_ns, events[1].start_ns);
+  EXPECT_LE(events[0].start_ns + events[0].duration_ns,
+            events[1].start_ns + events[1].duration_ns);
+  // Ownership of injected dependencies is part of the CreateInstance span
+  EXPECT_EQ(events[2].name, "CreateInstance " + PrinterOwnerInstanceName);
+  EXPECT_EQ(events[3].name, "TakeOwnership " + PrinterOwnerInstanceName);
+  for (const auto& event : events)
+  {
+    EXPECT_EQ(event.category, "ObjectManager");
+  }
+}
+
+TEST_F(ObjectManagerTest, DeferredInstances)
+{
+  const std::string CountingPrinterName = "CountingPrinter";
+  const std::string UnusedInstanceName = "UnusedInstance";
+  counting_printer_creations = 0;
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      CountingPrinterName, CountingPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterDecoratorName, PrinterDecoratorFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+        std::unique_ptr<IPrinter>&&>));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(HelloTestName, TestHelloPrinter));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(DecoratorHelloTestName,
+                                                    TestDecoratedHelloPrinter));
+
+  // Failures that are detected when deferring
+  EXPECT_EQ(object_manager.DeferCreateInstance("UnknownType", HelloPrinterInstanceName, {}),
+            ErrorCode::kFactoryFunctionNotFound);
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, HelloPrinterInstanceName,
+                                               {IntInstanceName}),
+            ErrorCode::kWrongNumberOfDependencies);
+
+  // Deferred instances are only created when needed, including their deferred dependencies
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kInvalidInstanceName);
+  EXPECT_EQ(object_manager.DeferCreateInstance(PrinterDecoratorName, PrinterDecoratorInstanceName,
+                                               {HelloPrinterInstanceName}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, UnusedInstanceName, {}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), 3);
+  EXPECT_EQ(counting_printer_creations, 0);
+  EXPECT_EQ(object_manager.CallGlobalFunction(DecoratorHelloTestName,
+                                              {PrinterDecoratorInstanceName}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(counting_printer_creations, 1);
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), 1);
+  EXPECT_EQ(object_manager.CallGlobalFunction(HelloTestName, {HelloPrinterInstanceName}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(counting_printer_creations, 1);
+
+  // Names of instances that were already created are rejected up front
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kInvalidInstanceName);
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, PrinterDecoratorInstanceName,
+                                               {}),
+            ErrorCode::kInvalidInstanceName);
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), 1);
+
+  // Creation on first GetInstance, by name, symbol or tag
+  const std::string TaggedName = HelloPrinterTag::name;
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, TaggedName, {}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(UnusedInstanceName)->Print(), HelloWorld);
+  EXPECT_EQ((object_manager.GetInstance<IPrinter*, HelloPrinterTag>()->Print()), HelloWorld);
+  EXPECT_EQ(counting_printer_creations, 3);
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), 0);
+
+  // Prepared calls create their deferred dependencies
+  const std::string PreparedInstanceName = "PreparedInstance";
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, PreparedInstanceName, {}),
+            ErrorCode::kSuccess);
+  PreparedCall prepared_call;
+  EXPECT_EQ(object_manager.PrepareGlobalFunction(HelloTestName, {PreparedInstanceName},
+                                                 prepared_call),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.Invoke(prepared_call), ErrorCode::kSuccess);
+  EXPECT_EQ(counting_printer_creations, 4);
+
+  // A deferred instance can not trigger the creation of an instance that was deferred after it
+  EXPECT_EQ(object_manager.DeferCreateInstance(PrinterOwnerName, PrinterOwnerInstanceName,
+                                               {"LaterInstance"}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, "LaterInstance", {}),
+            ErrorCode::kSuccess);
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(PrinterOwnerInstanceName),
+               std::runtime_error);
+  EXPECT_EQ(object_manager.GetDeferredInstanceCount(), 1);
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>("LaterInstance")->Print(), HelloWorld);
+  EXPECT_EQ(counting_printer_creations, 5);
+
+  // Concurrent first use creates the instance once
+  const std::string SharedInstanceName = "SharedInstance";
+  EXPECT_EQ(object_manager.DeferCreateInstance(CountingPrinterName, SharedInstanceName, {}),
+            ErrorCode::kSuccess);
+  std::atomic<int> n_success{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([this, &n_success, &SharedInstanceName]() {
+      if (object_manager.CallGlobalFunction(HelloTestName, {SharedInstanceName}) ==
+          ErrorCode::kSuccess)
+      {
+        ++n_success;
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(n_success, 4);
+  EXPECT_EQ(counting_printer_creations, 6);
+}
+
+TEST_F(ObjectManagerTest, TransientInstances)
+{
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterDecoratorName, PrinterDecoratorFactoryFunction));
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kSuccess);
+
+  // Each call creates a new instance that is not stored
+  std::unique_ptr<IPrinter> printer_1;
+  std::unique_ptr<IPrinter> printer_2;
+  EXPECT_EQ(object_manager.CreateTransient(PrinterDecoratorName, {HelloPrinterInstanceName},
+                                           printer_1),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.CreateTransient(PrinterDecoratorName, {HelloPrinterInstanceName},
+                                           printer_2),
+            ErrorCode::kSuccess);
+  ASSERT_NE(printer_1, nullptr);
+  ASSERT_NE(printer_2, nullptr);
+  EXPECT_NE(printer_1, printer_2);
+  EXPECT_EQ(printer_1->Print(), DecoratedPrefix + HelloWorld);
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(PrinterDecoratorName), std::runtime_error);
+
+  // Interned names
+  auto decorator_symbol = object_manager.Intern(PrinterDecoratorName);
+  auto hello_symbol = object_manager.Intern(HelloPrinterInstanceName);
+  EXPECT_EQ(object_manager.CreateTransient(decorator_symbol, {hello_symbol}, printer_1),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(printer_1->Print(), DecoratedPrefix + HelloWorld);
+
+  // Failures leave the output untouched
+  std::unique_ptr<IPrinter> printer_3;
+  EXPECT_EQ(object_manager.CreateTransient("UnknownType", {}, printer_3),
+            ErrorCode::kFactoryFunctionNotFound);
+  EXPECT_EQ(object_manager.CreateTransient(PrinterDecoratorName, {"UnknownInstance"}, printer_3),
+            ErrorCode::kDependencyNotFound);
+  EXPECT_EQ(object_manager.CreateTransient(PrinterDecoratorName, {}, printer_3),
+            ErrorCode::kWrongNumberOfDependencies);
+  EXPECT_EQ(printer_3, nullptr);
+  std::unique_ptr<HelloPrinter> hello_printer;
+  EXPECT_EQ(object_manager.CreateTransient(HelloPrinterName, {}, hello_printer),
+            ErrorCode::kWrongInstanceType);
+  EXPECT_EQ(hello_printer, nullptr);
+}
+
+TEST_F(ObjectManagerTest, ScopedInstances)
+{
+  const std::string ScopedHelloInstanceName = "ScopedHelloInstance";
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterDecoratorName, PrinterDecoratorFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterOwnerName, ForwardingInstanceFactoryFunction<IPrinter, PrinterOwner,
+        std::unique_ptr<IPrinter>&&>));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(HelloTestName, TestHelloPrinter));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(DecoratorHelloTestName,
+                                                    TestDecoratedHelloPrinter));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(OwnedPrinterTestName, TestOwnedPrinter));
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kSuccess);
+  {
+    InstanceScope scope{object_manager};
+
+    // Scoped instances can depend on instances of the ObjectManager, but are not visible there
+    EXPECT_EQ(scope.CreateInstance(PrinterDecoratorName, PrinterDecoratorInstanceName,
+                                   {HelloPrinterInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(scope.CreateInstance(PrinterDecoratorName, PrinterDecoratorInstanceName,
+                                   {HelloPrinterInstanceName}),
+              ErrorCode::kInvalidInstanceName);
+    EXPECT_EQ(scope.CallGlobalFunction(DecoratorHelloTestName, {PrinterDecoratorInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(object_manager.CallGlobalFunction(DecoratorHelloTestName,
+                                                {PrinterDecoratorInstanceName}),
+              ErrorCode::kDependencyNotFound);
+    EXPECT_EQ(scope.GetInstance<IPrinter*>(HelloPrinterInstanceName)->Print(), HelloWorld);
+    EXPECT_EQ(scope.GetInstanceCount(), 1);
+
+    // Ownership transfer between scoped instances
+    EXPECT_EQ(scope.CreateInstance(HelloPrinterName, ScopedHelloInstanceName, {}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(scope.CreateInstance(PrinterOwnerName, PrinterOwnerInstanceName,
+                                   {ScopedHelloInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(scope.GetInstanceCount(), 2);
+    auto owner_symbol = object_manager.Intern(PrinterOwnerInstanceName);
+    EXPECT_EQ(scope.CallGlobalFunction(object_manager.Intern(OwnedPrinterTestName),
+                                       {owner_symbol}),
+              ErrorCode::kSuccess);
+
+    // Transient instances with scoped dependencies
+    std::unique_ptr<IPrinter> printer;
+    EXPECT_EQ(scope.CreateTransient(PrinterDecoratorName, {PrinterOwnerInstanceName}, printer),
+              ErrorCode::kSuccess);
+    ASSERT_NE(printer, nullptr);
+    EXPECT_EQ(printer->Print(), DecoratedPrefix + OwnedPrinterPrefix + HelloWorld);
+    printer.reset();
+
+    // Taking ownership out of the scope
+    auto owner = scope.GetInstance<std::unique_ptr<IPrinter>&&>(owner_symbol);
+    ASSERT_NE(owner, nullptr);
+    EXPECT_EQ(owner->Print(), OwnedPrinterPrefix + HelloWorld);
+    EXPECT_EQ(scope.GetInstanceCount(), 1);
+    EXPECT_THROW(scope.GetInstance<IPrinter*>(PrinterOwnerInstanceName), std::runtime_error);
+
+    // Names that are only used in the scope are not interned in the ObjectManager
+    const auto symbol_count = object_manager.GetSymbolCount();
+    for (int idx = 0; idx < 10; ++idx)
+    {
+      EXPECT_EQ(scope.CreateInstance(HelloPrinterName, "RequestPrinter" + std::to_string(idx), {}),
+                ErrorCode::kSuccess);
+    }
+    EXPECT_EQ(scope.CreateInstance(PrinterDecoratorName, "RequestDecorator", {"RequestPrinter0"}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(scope.GetInstance<IPrinter*>("RequestDecorator")->Print(),
+              DecoratedPrefix + HelloWorld);
+    EXPECT_EQ(scope.CallGlobalFunction(HelloTestName, {"RequestPrinter1"}), ErrorCode::kSuccess);
+    EXPECT_EQ(object_manager.GetSymbolCount(), symbol_count);
+    EXPECT_THROW(object_manager.GetInstance<IPrinter*>("RequestPrinter1"), std::runtime_error);
+
+    // They are still found by symbols that were interned in the ObjectManager afterwards
+    auto later_symbol = object_manager.Intern("RequestPrinter2");
+    EXPECT_EQ(scope.GetInstance<IPrinter*>(later_symbol),
+              scope.GetInstance<IPrinter*>("RequestPrinter2"));
+    EXPECT_EQ(scope.CallGlobalFunction(object_manager.Intern(HelloTestName), {later_symbol}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(scope.GetInstanceCount(), 12);
+  }
+  // Instances of the ObjectManager are not affected by the scope
+  EXPECT_EQ(object_manager.CallGlobalFunction(HelloTestName, {HelloPrinterInstanceName}),
+            ErrorCode::kSuccess);
+}
+
+TEST_F(ObjectManagerTest, ChildObjectManager)
+{
+  const std::string TransferableInstanceName = "TransferableInstance";
+  const std::string DeferredInstanceName = "DeferredInstance";
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterDecoratorName, PrinterDecoratorFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterGlobalFunction(DecoratorHelloTestName,
+                                                    TestDecoratedHelloPrinter));
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, HelloPrinterInstanceName, {}),
+            ErrorCode::kSuccess);
+  EXPECT_EQ(object_manager.CreateInstance(HelloPrinterName, TransferableInstanceName, {}),
+            ErrorCode::kSuccess);
+  EXPECT_TRUE(object_manager.RegisterInstance<HelloPrinterTag>(HelloPrinterFactoryFunction()));
+  EXPECT_EQ(object_manager.DeferCreateInstance(HelloPrinterName, DeferredInstanceName, {}),
+            ErrorCode::kSuccess);
+  {
+    ObjectManager child{object_manager, std::pmr::get_default_resource()};
+    EXPECT_EQ(child.GetParent(), &object_manager);
+    EXPECT_EQ(object_manager.GetParent(), nullptr);
+
+    // Instances and functions of the parent are visible in the child
+    EXPECT_EQ(child.GetInstance<IPrinter*>(HelloPrinterInstanceName),
+              object_manager.GetInstance<IPrinter*>(HelloPrinterInstanceName));
+    EXPECT_EQ((child.GetInstance<IPrinter*, HelloPrinterTag>()),
+              (object_manager.GetInstance<IPrinter*, HelloPrinterTag>()));
+    EXPECT_EQ(child.Intern(HelloPrinterInstanceName),
+              object_manager.Intern(HelloPrinterInstanceName));
+    EXPECT_EQ(child.CreateInstance(PrinterDecoratorName, PrinterDecoratorInstanceName,
+                                   {HelloPrinterInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(child.CallGlobalFunction(DecoratorHelloTestName, {PrinterDecoratorInstanceName}),
+              ErrorCode::kSuccess);
+
+    // Instances and functions of the child are not visible in the parent
+    EXPECT_EQ(object_manager.CallGlobalFunction(DecoratorHelloTestName,
+                                                {PrinterDecoratorInstanceName}),
+              ErrorCode::kDependencyNotFound);
+    EXPECT_TRUE(child.RegisterGlobalFunction(HelloTestName, TestHelloPrinter));
+    EXPECT_EQ(child.CallGlobalFunction(HelloTestName, {HelloPrinterInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(object_manager.CallGlobalFunction(HelloTestName, {HelloPrinterInstanceName}),
+              ErrorCode::kGlobalFunctionNotFound);
+
+    // Instances of the child shadow those of the parent
+    EXPECT_EQ(child.CreateInstance(PrinterDecoratorName, HelloPrinterInstanceName,
+                                   {HelloPrinterInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(child.CallGlobalFunction(DecoratorHelloTestName, {HelloPrinterInstanceName}),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(object_manager.GetInstance<IPrinter*>(HelloPrinterInstanceName)->Print(),
+              HelloWorld);
+
+    // Typed lookups that were cached before an instance of the parent was shadowed see the new one
+    IPrinter* parent_tagged = object_manager.GetInstance<IPrinter*, HelloPrinterTag>();
+    EXPECT_EQ((child.GetInstance<IPrinter*, HelloPrinterTag>()), parent_tagged);
+    EXPECT_TRUE(child.RegisterInstance<HelloPrinterTag>(HelloPrinterFactoryFunction()));
+    IPrinter* child_tagged = child.GetInstance<IPrinter*, HelloPrinterTag>();
+    EXPECT_NE(child_tagged, parent_tagged);
+    EXPECT_EQ((child.GetInstance<IPrinter*, HelloPrinterTag>()), child_tagged);
+    EXPECT_EQ((object_manager.GetInstance<IPrinter*, HelloPrinterTag>()), parent_tagged);
+
+    // Prepared calls in the child are refreshed when the parent removes an instance
+    PreparedCall prepared_call;
+    EXPECT_EQ(child.PrepareGlobalFunction(HelloTestName, {TransferableInstanceName},
+                                          prepared_call),
+              ErrorCode::kSuccess);
+    EXPECT_EQ(child.Invoke(prepared_call), ErrorCode::kSuccess);
+    auto transferred = object_manager.GetInstance<std::unique_ptr<IPrinter>>(
+      TransferableInstanceName);
+    EXPECT_EQ(child.Invoke(prepared_call), ErrorCode::kDependencyNotFound);
+
+    // Deferred instances of the parent are created in the parent
+    EXPECT_EQ(child.GetInstance<IPrinter*>(DeferredInstanceName)->Print(), HelloWorld);
+    EXPECT_EQ(object_manager.GetDeferredInstanceCount(), 0);
+    EXPECT_EQ(child.GetInstance<IPrinter*>(DeferredInstanceName),
+              object_manager.GetInstance<IPrinter*>(DeferredInstanceName));
+  }
+  // Destroying the child only releases its own instances
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(HelloPrinterInstanceName)->Print(), HelloWorld);
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(PrinterDecoratorInstanceName),
+               std::runtime_error);
+}
+
+TEST_F(ObjectManagerTest, BatchCreateInstances)
+{
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      HelloPrinterName, HelloPrinterFactoryFunction));
+  EXPECT_TRUE(object_manager.RegisterFactoryFunction(
+      PrinterDecoratorName, PrinterDecoratorFactoryFunction));
+  auto hello_printer = object_manager.Intern(HelloPrinterName);
+  auto printer_decorator = object_manager.Intern(PrinterDecoratorName);
+  auto hello_instance = object_manager.Intern(HelloPrinterInstanceName);
+  auto decorator_instance = object_manager.Intern(PrinterDecoratorInstanceName);
+  std::vector<Symbol> printer_names;
+  for (int idx = 0; idx < 20; ++idx)
+  {
+    printer_names.push_back(object_manager.Intern("Printer" + std::to_string(idx)));
+  }
+
+  // Requests can depend on instances created earlier in the same batch
+  const std::vector<Symbol> no_dependencies;
+  const std::vector<Symbol> hello_dependency{hello_instance};
+  std::vector<CreateInstanceRequest> requests{
+    {hello_printer, hello_instance, no_dependencies},
+    {printer_decorator, decorator_instance, hello_dependency}};
+  for (auto printer_name : printer_names)
+  {
+    requests.push_back({hello_printer, printer_name, no_dependencies});
+  }
+  std::vector<ErrorCode> results;
+  EXPECT_EQ(object_manager.CreateInstances(requests, results), ErrorCode::kSuccess);
+  EXPECT_EQ(results, std::vector<ErrorCode>(requests.size(), ErrorCode::kSuccess));
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(decorator_instance)->Print(),
+            DecoratedPrefix + HelloWorld);
+  for (auto printer_name : printer_names)
+  {
+    EXPECT_EQ(object_manager.GetInstance<IPrinter*>(printer_name)->Print(), HelloWorld);
+  }
+
+  // Each request gets its own error code and failures do not stop the batch
+  auto new_instance = object_manager.Intern("NewInstance");
+  const std::vector<Symbol> unknown_dependency{new_instance};
+  requests = {
+    {hello_instance, new_instance, no_dependencies},
+    {hello_printer, new_instance, hello_dependency},
+    {hello_printer, kInvalidSymbol, no_dependencies},
+    {printer_decorator, decorator_instance, unknown_dependency},
+    {hello_printer, hello_instance, no_dependencies},
+    {hello_printer, new_instance, no_dependencies}};
+  EXPECT_EQ(object_manager.CreateInstances(requests, results),
+            ErrorCode::kFactoryFunctionNotFound);
+  EXPECT_EQ(results, std::vector<ErrorCode>({
+    ErrorCode::kFactoryFunctionNotFound, ErrorCode::kWrongNumberOfDependencies,
+    ErrorCode::kInvalidInstanceName, ErrorCode::kDependencyNotFound,
+    ErrorCode::kInvalidInstanceName, ErrorCode::kSuccess}));
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(new_instance)->Print(), HelloWorld);
+
+  // Optionally, the batch stops at the first failure
+  auto first_instance = object_manager.Intern("FirstInstance");
+  auto last_instance = object_manager.Intern("LastInstance");
+  requests = {
+    {hello_printer, first_instance, no_dependencies},
+    {hello_printer, hello_instance, no_dependencies},
+    {hello_printer, last_instance, no_dependencies}};
+  EXPECT_EQ(object_manager.CreateInstances(requests, results, true),
+            ErrorCode::kInvalidInstanceName);
+  EXPECT_EQ(results, std::vector<ErrorCode>({
+    ErrorCode::kSuccess, ErrorCode::kInvalidInstanceName}));
+  EXPECT_EQ(object_manager.GetInstance<IPrinter*>(first_instance)->Print(), HelloWorld);
+  EXPECT_THROW(object_manager.GetInstance<IPrinter*>(last_instance), std::runtime_error);
+
+  // Empty batch
+  EXPECT_EQ(object_manager.CreateInstances(nullptr, 0, results), ErrorCode::kSuccess);
+  EXPECT_TRUE(results.empty());
 }
 
 ObjectManagerTest::ObjectManagerTest()
@@ -293,3 +1061,25 @@ ObjectManagerTest::ObjectManagerTest()
 }
 
 ObjectManagerTest::~ObjectManagerTest() = default;
+
+bool CreateHelloPrinterNested()
+{
+  return nested_object_manager->CreateInstance(HelloPrinterName, HelloPrinterInstanceName, {}) ==
+         ErrorCode::kSuccess;
+}
+
+std::unique_ptr<IPrinter> CountingPrinterFactoryFunction()
+{
+  ++counting_printer_creations;
+  return HelloPrinterFactoryFunction();
+}
+
+std::unique_ptr<IPrinter> ThrowingPrinterFactoryFunction()
+{
+  throw std::runtime_error("ThrowingPrinterFactoryFunction");
+}
+
+bool ThrowingGlobalFunction(IPrinter*)
+{
+  throw std::runtime_error("ThrowingGlobalFunction");
+}
@@ -24,6 +24,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <memory_resource>
 #include <string>
 
 using namespace sup::di::internal;
@@ -48,6 +50,11 @@ bool UseTestServices(TestServiceA&, std::unique_ptr<TestServiceB>)
   return true;
 }
 
+bool UseTestServices2(std::unique_ptr<TestServiceB>, TestServiceA&)
+{
+  return true;
+}
+
 class TestClient
 {
 public:
@@ -57,6 +64,8 @@ public:
 TEST_F(ServiceStoreTest, StoreRetrieve)
 {
   StringServiceStore store;
+  // Reserving is a no-op for the ordered instance map
+  store.ReserveInstances<TestServiceA>(4);
   // Store two services
   EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
   EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceB>(), "B"));
@@ -69,3 +78,179 @@ TEST_F(ServiceStoreTest, StoreRetrieve)
   EXPECT_NO_THROW(store.GetInstance<TestServiceA*>("A"));
   EXPECT_THROW(store.GetInstance<TestServiceB*>("B"), std::runtime_error);
 }
+
+TEST_F(ServiceStoreTest, FlatTypeMapBackend)
+{
+  ServiceStore<std::string, FlatTypeMap> store;
+  // Store two services
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceB>(), "B"));
+  EXPECT_FALSE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
+
+  // Invoke function with those services
+  EXPECT_TRUE((InvokeWithStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    UseTestServices, store, {"A", "B"})));
+
+  // Verify service A is still in the store, while B was removed because of transfer of ownership
+  EXPECT_NO_THROW(store.GetInstance<TestServiceA*>("A"));
+  EXPECT_THROW(store.GetInstance<TestServiceB*>("B"), std::runtime_error);
+  EXPECT_THROW(store.GetInstance<int*>("A"), std::runtime_error);
+}
+
+TEST_F(ServiceStoreTest, HashedInstanceMapBackend)
+{
+  ServiceStore<std::string, FlatTypeMap, HashedInstanceMap> store;
+  store.ReserveInstances<TestServiceA>(4);
+  // Store two services
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceB>(), "B"));
+  EXPECT_FALSE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
+
+  // Lookup without creating a std::string
+  std::string_view key_a = "A";
+  EXPECT_NO_THROW(store.GetInstance<TestServiceA*>(key_a));
+  EXPECT_THROW(store.GetInstance<TestServiceA*>("B"), std::runtime_error);
+
+  // Invoke function with those services
+  EXPECT_TRUE((InvokeWithStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    UseTestServices, store, {"A", "B"})));
+
+  // Verify service A is still in the store, while B was removed because of transfer of ownership
+  EXPECT_NO_THROW(store.GetInstance<TestServiceA*>("A"));
+  EXPECT_THROW(store.GetInstance<TestServiceB*>("B"), std::runtime_error);
+}
+
+TEST_F(ServiceStoreTest, ResolvedArgs)
+{
+  ServiceStore<std::string, FlatTypeMap, HashedInstanceMap> store;
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceB>(), "B"));
+
+  // Resolution failures report the index of the failing dependency
+  ResolvedDependencies containers;
+  EXPECT_EQ((ResolveStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    store, {"A", "C"}, containers)), 1);
+  EXPECT_EQ((ResolveStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    store, {"B", "B"}, containers)), 0);
+  EXPECT_EQ((ResolveStoreArgs<TestServiceB*, std::unique_ptr<TestServiceB>>(
+    store, {"B", "B"}, containers)), 1);
+
+  // Successful resolution and invocation
+  auto generation = store.GetGeneration();
+  EXPECT_EQ((ResolveStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    store, {"A", "B"}, containers)), 2);
+  EXPECT_EQ(store.GetGeneration(), generation);
+  EXPECT_TRUE((InvokeWithResolvedArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    UseTestServices, store, {"A", "B"}, containers)));
+  EXPECT_NE(store.GetGeneration(), generation);
+  EXPECT_EQ(store.FindInstanceContainer<TestServiceB>("B"), nullptr);
+  EXPECT_NE(store.FindInstanceContainer<TestServiceA>("A"), nullptr);
+}
+
+TEST_F(ServiceStoreTest, TryInvoke)
+{
+  StringServiceStore store;
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceA>(), "A"));
+  EXPECT_TRUE(store.StoreInstance(std::make_unique<TestServiceB>(), "B"));
+
+  // Failures report error code and dependency index, without modifying the store
+  auto result = TryInvokeWithStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    UseTestServices, store, {"A"});
+  EXPECT_FALSE(result.IsSuccess());
+  EXPECT_EQ(result.GetErrorCode(), sup::di::ErrorCode::kWrongNumberOfDependencies);
+  result = TryInvokeWithStoreArgs<std::unique_ptr<TestServiceB>, TestServiceA&>(
+    UseTestServices2, store, {"B", "C"});
+  EXPECT_FALSE(result.IsSuccess());
+  EXPECT_EQ(result.GetErrorCode(), sup::di::ErrorCode::kDependencyNotFound);
+  EXPECT_EQ(result.GetDependencyIndex(), 1);
+  EXPECT_NE(store.FindInstanceContainer<TestServiceB>("B"), nullptr);
+
+  // Success
+  result = TryInvokeWithStoreArgs<TestServiceA&, std::unique_ptr<TestServiceB>>(
+    UseTestServices, store, {"A", "B"});
+  ASSERT_TRUE(result.IsSuccess());
+  EXPECT_TRUE(result.GetValue());
+  EXPECT_EQ(store.FindInstanceContainer<TestServiceB>("B"), nullptr);
+}
+
+TEST_F(ServiceStoreTest, StoreValue)
+{
+  ServiceStore<std::string, FlatTypeMap, HashedInstanceMap> store;
+  const std::string text = "stored copy";
+  EXPECT_TRUE(store.StoreValue(text, "text"));
+  EXPECT_TRUE(store.StoreValue(42, "answer"));
+  EXPECT_FALSE(store.StoreValue(43, "answer"));
+  EXPECT_EQ(*store.GetInstance<int*>("answer"), 42);
+  EXPECT_EQ(store.GetInstance<const std::string&>("text"), text);
+
+  // Transfer of ownership hands out the stored object itself
+  const std::string* stored = store.GetInstance<const std::string*>("text");
+  std::unique_ptr<std::string> released;
+  EXPECT_NO_THROW(released = store.GetInstance<std::unique_ptr<std::string>&&>("text"));
+  ASSERT_NE(released, nullptr);
+  EXPECT_EQ(released.get(), stored);
+  EXPECT_EQ(*stored, text);
+  EXPECT_THROW(store.GetInstance<std::string*>("text"), std::runtime_error);
+  EXPECT_TRUE(store.StoreValue(text, "text"));
+}
+
+TEST_F(ServiceStoreTest, RemovedContainersAreReused)
+{
+  // A fixed buffer without upstream fails when the store keeps allocating new containers
+  alignas(std::max_align_t) static char buffer[64 * 1024];
+  std::pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer),
+                                               std::pmr::null_memory_resource()};
+  ServiceStore<std::string, FlatTypeMap, HashedInstanceMap> store{&resource};
+  for (int i = 0; i < 10000; ++i)
+  {
+    ASSERT_TRUE(store.StoreValue(i, "value"));
+    ASSERT_EQ(*store.GetInstance<std::unique_ptr<int>&&>("value"), i);
+  }
+}
+
+TEST_F(ServiceStoreTest, ReserveAndShrink)
+{
+  ServiceStore<std::string, FlatTypeMap, HashedInstanceMap> store;
+  const int n_values = 100;
+  store.Reserve(2, 2 * n_values);
+  for (int i = 0; i < n_values; ++i)
+  {
+    EXPECT_TRUE(store.StoreValue(i, "int" + std::to_string(i)));
+    EXPECT_TRUE(store.StoreValue(static_cast<double>(i), "double" + std::to_string(i)));
+  }
+  auto* container = store.FindInstanceContainer<int>("int0");
+  ASSERT_NE(container, nullptr);
+
+  // Shrinking does not move the instances
+  for (int i = 1; i < n_values; ++i)
+  {
+    store.EraseInstance<int>("int" + std::to_string(i));
+  }
+  store.ShrinkToFit();
+  EXPECT_EQ(store.FindInstanceContainer<int>("int0"), container);
+  EXPECT_EQ(store.FindInstanceContainer<int>("int1"), nullptr);
+  for (int i = 0; i < n_values; ++i)
+  {
+    EXPECT_EQ(*store.GetInstance<double*>("double" + std::to_string(i)), i);
+  }
+
+  // The hints only apply to the types of the reservation, so a fixed buffer without upstream
+  // holds one large instance map, but not one for each type that is stored later
+  alignas(std::max_align_t) static char buffer[512 * 1024];
+  std::pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer),
+                                               std::pmr::null_memory_resource()};
+  ServiceStore<std::string, FlatTypeMap, HashedInstanceMap> reserved_store{&resource};
+  reserved_store.Reserve(1, 2000);
+  EXPECT_TRUE(reserved_store.StoreValue(1, "int"));
+  EXPECT_TRUE(reserved_store.StoreValue(2.0, "double"));
+  EXPECT_TRUE(reserved_store.StoreValue(3L, "long"));
+  EXPECT_TRUE(reserved_store.StoreValue('4', "char"));
+  EXPECT_TRUE(reserved_store.StoreValue(5u, "unsigned"));
+
+  // The ordered maps ignore the hints
+  StringServiceStore ordered_store;
+  ordered_store.Reserve(2, 2 * n_values);
+  EXPECT_TRUE(ordered_store.StoreValue(42, "answer"));
+  ordered_store.ShrinkToFit();
+  EXPECT_EQ(*ordered_store.GetInstance<int*>("answer"), 42);
+}
@@ -0,0 +1,184 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "global_test_objects.h"
+#include "temporary_file.h"
+
+#include <sup/di-composer-core/composition_root.h>
+#include <sup/di-composer-core/exceptions.h>
+#include <sup/di-composer-core/streaming_object_tree.h>
+#include <sup/di/object_manager.h>
+
+#include <sup/xml/exceptions.h>
+
+#include <gtest/gtest.h>
+
+using namespace sup::di;
+
+const std::string STREAMING_FILE_NAME = "test_streaming_object_tree.xml";
+
+const std::string STREAMING_TREE_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0"
+           name="Test configuration file for the SUP dependency injection framework"
+           xmlns:xs="http://www.w3.org/2001/XMLSchema-instance"
+           xs:schemaLocation="http://codac.iter.org/sup/di sup-di.xsd">
+    <!-- Comments are skipped -->
+    <StringInstance>
+        <InstanceName>streaming_str_name</InstanceName>
+        <Value><![CDATA[Hello]]></Value>
+    </StringInstance>
+    <IntegerInstance>
+        <InstanceName>streaming_int_name</InstanceName>
+        <Value>42</Value>
+    </IntegerInstance>
+    <DoubleInstance>
+        <InstanceName>streaming_double_name</InstanceName>
+        <Value>3.14e6</Value>
+    </DoubleInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>streaming_wrapper_name</InstanceName>
+        <Dependency>streaming_str_name</Dependency>
+    </Instance>
+    <CallFunction>
+        <FunctionName>test_literals_positive</FunctionName>
+        <Dependency>streaming_str_name</Dependency>
+        <Dependency>streaming_int_name</Dependency>
+        <Dependency>streaming_double_name</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+const std::string STREAMING_LAZY_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <StringInstance>
+        <InstanceName>streaming_lazy_str_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <Instance>
+        <TypeName>test_string_wrapper</TypeName>
+        <InstanceName>streaming_lazy_wrapper_name</InstanceName>
+        <Dependency>streaming_lazy_str_name</Dependency>
+    </Instance>
+</ObjectComposer>
+)RAW";
+
+const std::string STREAMING_INVALID_ELEMENT_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <StringInstance>
+        <InstanceName>streaming_before_invalid_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <UnknownElement/>
+</ObjectComposer>
+)RAW";
+
+const std::string STREAMING_MALFORMED_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <StringInstance>
+        <InstanceName>streaming_before_malformed_name</InstanceName>
+        <Value>Hello</Value>
+    </StringInstance>
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>streaming_before_malformed_name</Dependency>
+    </Function>
+</ObjectComposer>
+)RAW";
+
+const std::string STREAMING_CONTENT_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>test_string</Dependency>
+    </CallFunction>
+    Unexpected content
+</ObjectComposer>
+)RAW";
+
+const std::string STREAMING_FAILING_XML =
+R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<ObjectComposer xmlns="http://codac.iter.org/sup/di" version="1.0">
+    <CallFunction>
+        <FunctionName>test_check_string_not_null</FunctionName>
+        <Dependency>streaming_non_existing_name</Dependency>
+    </CallFunction>
+</ObjectComposer>
+)RAW";
+
+class StreamingObjectTreeTest : public ::testing::Test
+{
+protected:
+  StreamingObjectTreeTest();
+  virtual ~StreamingObjectTreeTest();
+};
+
+TEST_F(StreamingObjectTreeTest, FromString)
+{
+  EXPECT_NO_THROW(StreamObjectTreeFromString(STREAMING_TREE_XML));
+  auto& global_object_manager = GlobalObjectManager();
+  EXPECT_EQ(global_object_manager.GetInstance<const std::string&>("streaming_str_name"), "Hello");
+  EXPECT_EQ(*global_object_manager.GetInstance<int*>("streaming_int_name"), 42);
+  EXPECT_EQ(*global_object_manager.GetInstance<double*>("streaming_double_name"), 3.14e6);
+  EXPECT_EQ(global_object_manager.GetInstance<test::Test_StringWrapper*>(
+              "streaming_wrapper_name")->GetString(), "Hello");
+}
+
+TEST_F(StreamingObjectTreeTest, FromFile)
+{
+  test::TemporaryTestFile file(STREAMING_FILE_NAME, STREAMING_LAZY_XML);
+  ComposerOptions options;
+  options.streaming = true;
+  options.lazy_instances = true;
+  auto& global_object_manager = GlobalObjectManager();
+  auto deferred_count = global_object_manager.GetDeferredInstanceCount();
+  EXPECT_NO_THROW(ExecuteObjectTreeFromFile(STREAMING_FILE_NAME, options));
+  EXPECT_EQ(global_object_manager.GetDeferredInstanceCount(), deferred_count + 1);
+  EXPECT_EQ(global_object_manager.GetInstance<test::Test_StringWrapper*>(
+              "streaming_lazy_wrapper_name")->GetString(), "Hello");
+
+  EXPECT_THROW(StreamObjectTreeFromFile("non_existing_file.xml"), ParseException);
+}
+
+TEST_F(StreamingObjectTreeTest, Failures)
+{
+  // Elements before an invalid element were already executed
+  auto& global_object_manager = GlobalObjectManager();
+  EXPECT_THROW(StreamObjectTreeFromString(STREAMING_INVALID_ELEMENT_XML),
+               sup::xml::ValidationException);
+  EXPECT_EQ(global_object_manager.GetInstance<const std::string&>(
+              "streaming_before_invalid_name"), "Hello");
+  EXPECT_THROW(StreamObjectTreeFromString(STREAMING_MALFORMED_XML), ParseException);
+
+  EXPECT_THROW(StreamObjectTreeFromString(STREAMING_CONTENT_XML), sup::xml::ValidationException);
+  EXPECT_THROW(StreamObjectTreeFromString(STREAMING_FAILING_XML), RuntimeException);
+  EXPECT_THROW(StreamObjectTreeFromString("<ObjectComposer>"), ParseException);
+}
+
+StreamingObjectTreeTest::StreamingObjectTreeTest() = default;
+
+StreamingObjectTreeTest::~StreamingObjectTreeTest() = default;
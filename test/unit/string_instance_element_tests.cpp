@@ -54,7 +54,7 @@ TEST_F(StringInstanceElementTest, Construction)
 {
   EXPECT_NO_THROW(StringInstanceElement inst_elem{m_string_instance_tree});
   auto constr_it = ElementConstructorMap().find(constants::STRING_INSTANCE_TAG);
-  EXPECT_NO_THROW(constr_it->second(m_string_instance_tree));
+  EXPECT_NO_THROW(constr_it->second(m_string_instance_tree, ComposerOptions{}));
 }
 
 TEST_F(StringInstanceElementTest, Validation)
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/di/symbol_table.h>
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string>
+
+using namespace sup::di;
+
+class SymbolTableTest : public ::testing::Test
+{
+protected:
+  SymbolTableTest();
+  virtual ~SymbolTableTest();
+
+  SymbolTable symbol_table;
+};
+
+TEST_F(SymbolTableTest, Intern)
+{
+  EXPECT_EQ(symbol_table.Size(), 0);
+  EXPECT_EQ(symbol_table.Find("one"), kInvalidSymbol);
+  auto one = symbol_table.Intern("one");
+  auto two = symbol_table.Intern(std::string{"two"});
+  EXPECT_NE(one, two);
+  EXPECT_EQ(symbol_table.Intern("one"), one);
+  EXPECT_EQ(symbol_table.Find("one"), one);
+  EXPECT_EQ(symbol_table.Find(std::string_view{"two"}), two);
+  EXPECT_EQ(symbol_table.Size(), 2);
+
+  EXPECT_EQ(symbol_table.Name(one), "one");
+  EXPECT_EQ(symbol_table.Name(two), "two");
+  EXPECT_TRUE(symbol_table.Contains(one));
+  EXPECT_FALSE(symbol_table.Contains(kInvalidSymbol));
+  EXPECT_TRUE(symbol_table.Name(kInvalidSymbol).empty());
+
+  // The empty string is a valid name
+  auto empty = symbol_table.Intern("");
+  EXPECT_TRUE(symbol_table.Contains(empty));
+  EXPECT_TRUE(symbol_table.Name(empty).empty());
+}
+
+TEST_F(SymbolTableTest, StableNames)
+{
+  // Names returned earlier stay valid while the table grows
+  auto first = symbol_table.Intern("first");
+  auto first_name = symbol_table.Name(first);
+  const int n_symbols = 10000;
+  for (int i = 0; i < n_symbols; ++i)
+  {
+    auto name = "a name that is too long for the small string buffer " + std::to_string(i);
+    EXPECT_EQ(symbol_table.Name(symbol_table.Intern(name)), name);
+  }
+  EXPECT_EQ(symbol_table.Size(), n_symbols + 1);
+  EXPECT_EQ(first_name.data(), symbol_table.Name(first).data());
+  EXPECT_EQ(first_name, "first");
+  EXPECT_EQ(symbol_table.Find("a name that is too long for the small string buffer 42"),
+            static_cast<Symbol>(43));
+}
+
+TEST_F(SymbolTableTest, MemoryResource)
+{
+  // Any use of the default memory resource throws std::bad_alloc
+  auto default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  {
+    std::pmr::monotonic_buffer_resource arena{default_resource};
+    SymbolTable arena_table{&arena};
+    for (int i = 0; i < 100; ++i)
+    {
+      auto name = "a name that is too long for the small string buffer " + std::to_string(i);
+      EXPECT_EQ(arena_table.Name(arena_table.Intern(name)), name);
+    }
+  }
+  std::pmr::set_default_resource(default_resource);
+
+  // Empty tables do not allocate
+  SymbolTable empty_table{std::pmr::null_memory_resource()};
+  EXPECT_EQ(empty_table.Find("name"), kInvalidSymbol);
+  EXPECT_EQ(empty_table.Size(), 0);
+}
+
+SymbolTableTest::SymbolTableTest() = default;
+
+SymbolTableTest::~SymbolTableTest() = default;
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation - Dependency injection
+ *
+ * Description   : The definition and implementation for dependency injection templates in SUP.
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/di/trace_recorder.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace sup::di;
+
+namespace
+{
+std::size_t fake_allocation_count = 0;
+
+std::size_t FakeAllocationCount()
+{
+  return fake_allocation_count;
+}
+}  // unnamed namespace
+
+class TraceRecorderTest : public ::testing::Test
+{
+protected:
+  TraceRecorderTest();
+  virtual ~TraceRecorderTest();
+
+  TraceRecorder recorder;
+};
+
+TEST_F(TraceRecorderTest, Spans)
+{
+  {
+    // A span without recorder does nothing
+    TraceSpan span{nullptr, "ignored", "test"};
+    span.AddArgument("key", "value");
+  }
+  {
+    TraceSpan outer{&recorder, "outer", "test"};
+    outer.AddArgument("key", "value");
+    {
+      TraceSpan inner{&recorder, "inner", "test"};
+    }
+  }
+  auto events = recorder.GetEvents();
+  ASSERT_EQ(events.size(), 2);
+  // Events are recorded in the order they finish
+  EXPECT_EQ(events[0].name, "inner");
+  EXPECT_EQ(events[1].name, "outer");
+  EXPECT_EQ(events[1].category, "test");
+  ASSERT_EQ(events[1].args.size(), 1);
+  EXPECT_EQ(events[1].args[0].first, "key");
+  EXPECT_EQ(events[1].args[0].second, "value");
+  EXPECT_LE(events[1].start_ns, events[0].start_ns);
+  EXPECT_GE(events[1].start_ns + events[1].duration_ns,
+            events[0].start_ns + events[0].duration_ns);
+  EXPECT_EQ(events[0].thread_id, events[1].thread_id);
+  EXPECT_EQ(events[1].allocations, 0);
+}
+
+TEST_F(TraceRecorderTest, Threads)
+{
+  std::thread thread{[this]() { TraceSpan span{&recorder, "thread", "test"}; }};
+  thread.join();
+  {
+    TraceSpan span{&recorder, "main", "test"};
+  }
+  auto events = recorder.GetEvents();
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_NE(events[0].thread_id, events[1].thread_id);
+  EXPECT_EQ(events[1].thread_id, TraceThreadId());
+}
+
+TEST_F(TraceRecorderTest, AllocationCounter)
+{
+  TraceRecorder counting_recorder{FakeAllocationCount};
+  fake_allocation_count = 10;
+  {
+    TraceSpan span{&counting_recorder, "allocating", "test"};
+    fake_allocation_count += 5;
+  }
+  auto events = counting_recorder.GetEvents();
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events[0].allocations, 5);
+}
+
+TEST_F(TraceRecorderTest, ChromeTrace)
+{
+  {
+    std::ostringstream oss;
+    recorder.WriteChromeTrace(oss);
+    EXPECT_EQ(oss.str().find("\"traceEvents\":[\n]"), oss.str().find("\"traceEvents\""));
+  }
+  {
+    TraceSpan span{&recorder, "quoted \"name\"", "test"};
+    span.AddArgument("path", "C:\\dir\n");
+  }
+  std::ostringstream oss;
+  recorder.WriteChromeTrace(oss);
+  auto json = oss.str();
+  EXPECT_NE(json.find("\"name\":\"quoted \\\"name\\\"\""), std::string::npos);
+  EXPECT_NE(json.find("\"cat\":\"test\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(json.find("\"path\":\"C:\\\\dir\\n\""), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, Report)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    TraceSpan span{&recorder, "element" + std::to_string(i), "execute"};
+    span.AddArgument("instance", "name" + std::to_string(i));
+  }
+  {
+    TraceSpan span{&recorder, "parse", "phase"};
+  }
+  std::ostringstream oss;
+  recorder.WriteReport(oss, 2);
+  auto report = oss.str();
+  EXPECT_NE(report.find("execute"), std::string::npos);
+  EXPECT_NE(report.find("phase"), std::string::npos);
+  EXPECT_NE(report.find("instance=["), std::string::npos);
+  // Only the two slowest events are listed
+  auto slowest = report.substr(report.find("Slowest events:"));
+  EXPECT_EQ(std::count(slowest.begin(), slowest.end(), '\n'), 4);
+}
+
+TraceRecorderTest::TraceRecorderTest()
+  : recorder{}
+{}
+
+TraceRecorderTest::~TraceRecorderTest() = default;